@@ -9,8 +9,11 @@
 #include <thread>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 #include <ctime>
 #include <iomanip>
+#include <cstdint>
+#include <string_view>
 
 // Rule type enumeration
 enum class RuleType {
@@ -35,7 +38,8 @@ enum class Operator {
     STARTS_WITH,    // Starts with
     ENDS_WITH,      // Ends with
     REGEX,          // Regular expression
-    CUSTOM          // Custom function
+    CUSTOM,         // Custom function
+    IN_LIST         // Equal to one of a comma-separated list of values
 };
 
 // Data type enumeration
@@ -138,10 +142,33 @@ struct ProcessingTask {
     ProcessingTask() = default;
 };
 
+// Date / time cell value: seconds since 1970-01-01 00:00:00 on the workbook's clock (no time zone),
+// 8 bytes where a std::tm takes 36 to 56. It converts from std::tm implicitly, so code that fills
+// cells with a std::tm keeps working, and toTm() gives the calendar fields back.
+struct CellDate {
+    int64_t seconds = 0;
+
+    CellDate() = default;
+    CellDate(const std::tm& tm);
+    static CellDate fromDate(int year, int month, int day);   // month and day 1-based
+
+    std::tm toTm() const;
+    int64_t days() const;                                     // Days since 1970-01-01, rounded down
+    bool hasTime() const { return seconds != days() * 86400; }
+    // "YYYY-MM-DD", with " HH:MM:SS" when there is a time of day
+    std::string toString() const;
+
+    bool operator==(const CellDate& other) const { return seconds == other.seconds; }
+    bool operator!=(const CellDate& other) const { return seconds != other.seconds; }
+};
+
+// One cell of a row
+using CellValue = std::variant<std::string, int, double, bool, CellDate>;
+
 // Data row structure
 struct DataRow {
-    std::vector<std::variant<std::string, int, double, bool, std::tm>> data;
-    std::string sheetName;
+    std::vector<CellValue> data;
+    std::shared_ptr<const std::string> sheetName; // Shared by every row a reader returns from one sheet
     int rowNumber;
     bool isValid = true;
 
@@ -163,6 +190,14 @@ struct ProcessingResult {
     ProcessingResult() = default;
 };
 
+// Work done by one thread of the core's scheduler since its counters were reset
+struct WorkerUtilization {
+    uint64_t morsels = 0;          // Work items run
+    uint64_t steals = 0;           // Of those, taken over from another thread's queue
+    double busySeconds = 0.0;
+    double utilization = 0.0;      // busySeconds over the wall time the counters cover
+};
+
 // Performance statistics
 struct PerformanceStats {
     size_t memoryUsed = 0;
@@ -226,9 +261,36 @@ public:
     void setLogger(std::function<void(const std::string&)> logger);
     void setProgressCallback(std::function<void(int, const std::string&)> callback);
 
+    // Pipelined task processing (default on): chunks are read ahead and CSV output is written
+    // on background threads while rules are evaluated, with bounded queues between the stages
+    void setPipelinedProcessing(bool enabled);
+    bool isPipelinedProcessing() const;
+
+    // Process-wide: threads of the one scheduler that the reader, processData and the task loop of
+    // every ExcelProcessorCore share (0: one per hardware thread, 1: everything on the calling thread).
+    // Setting it affects all instances, including the per-file cores of concurrent file processing;
+    // change it only while no instance is processing.
+    static void setThreadCount(int threads);
+    static int getThreadCount();
+    // Counters of that shared scheduler, covering every instance: entry 0 is the calling threads,
+    // the others the workers
+    static std::vector<WorkerUtilization> getWorkerUtilization();
+    static void resetWorkerUtilization();
+
+    // Input files processed at once when processTasks() / processTask() take their files from the tasks'
+    // filename patterns (0: one per hardware thread, 1: one after another, the default). Files that share
+    // an input or output file still run one after the other, in the order a serial run would use.
+    void setConcurrentFiles(int files);
+    int getConcurrentFiles() const;
+
     // Data loading
     bool loadFile(const std::string& filename, const std::string& sheetName = "", int maxRows = 0, bool includeHeader = false);
     std::vector<std::string> getSheetNames(const std::string& filename);
+    // Number of times the last processTasks run opened its input file (for benchmarks)
+    int inputFileOpenCount() const;
+    // Number of rows the last processTasks run evaluated its rules on; each row is evaluated once
+    // for all tasks, however many of them share rules (for benchmarks)
+    int64_t ruleRowEvaluationCount() const;
 
     // Preview functionality
     bool previewResults(const std::string& inputFile, const std::string& sheetName = "", int maxPreviewRows = 5000);
@@ -271,12 +333,17 @@ private:
 
     mutable std::mutex dataMutex_;
     std::vector<ProcessingResult> processTasksInternal(const std::vector<ProcessingTask>& tasksToProcess, const std::string& overrideInputFile, const std::string& overrideOutputFile, const std::string& overrideSheetName);
+    std::vector<ProcessingResult> processFilesConcurrently(const std::vector<ProcessingTask>& tasksToProcess, const std::vector<std::string>& files, const std::string& defaultOutputFile, const std::string& sheetName);
 
     mutable std::recursive_mutex rulesMutex_;
 
     // Callbacks
     std::function<void(const std::string&)> logger_;
     std::function<void(int, const std::string&)> progressCallback_;
+
+    bool pipelinedProcessing_ = true;
+    int concurrentFiles_ = 1;
+    int64_t ruleRowEvaluations_ = 0;
     
     std::string loadedConfigFilename_;
 
@@ -291,30 +358,127 @@ private:
     Rule parseRuleLine(const std::string& line);
 };
 
+// Column-oriented copy of a chunk of rows, for evaluating a rule condition over a whole column at once.
+// Each column keeps one type tag per row, every number in one contiguous array and every text in one
+// arena addressed by offsets. Dates are kept as their "YYYY-MM-DD" text, the form rules compare them in.
+class ColumnarChunk {
+public:
+    enum class CellType : uint8_t {
+        Missing,    // The row has fewer cells
+        String,
+        Int,
+        Double,
+        Bool,
+        Date
+    };
+
+    // Text is dictionary-encoded: each distinct String / Date text of the column is stored once and rows
+    // hold its index, so a condition can be answered once per distinct text and looked up per row
+    struct Column {
+        std::vector<CellType> types;
+        std::vector<double> numbers;                // Int, Double and Bool (1 / 0) cells; 0 for the others
+        std::vector<uint32_t> codes;                // String and Date cells: index into dictionary; 0 for the others
+        std::vector<std::string_view> dictionary;   // Distinct texts in order of first appearance
+        std::vector<uint64_t> present;              // Bit per row: the row has this cell
+        std::unordered_map<std::string, uint32_t> entries;  // Owns the dictionary's text
+
+        std::string_view textAt(size_t row) const { return dictionary[codes[row]]; }
+    };
+
+    // Replaces the contents with rows; buffers are reused between chunks
+    void assign(const std::vector<DataRow>& rows);
+    // Same, but only the listed 1-based columns are filled; the others read as missing in every row
+    void assign(const std::vector<DataRow>& rows, const std::vector<int>& wantedColumns);
+    // Same, for rows [begin, end) only; chunk row 0 is rows[begin]
+    void assign(const std::vector<DataRow>& rows, size_t begin, size_t end, const std::vector<int>& wantedColumns);
+
+    size_t rowCount() const { return rowCount_; }
+    size_t columnCount() const { return columnCount_; }
+    // 0-based; index must be below columnCount()
+    const Column& column(size_t index) const { return columns_[index]; }
+
+private:
+    size_t rowCount_ = 0;
+    size_t columnCount_ = 0;
+    std::vector<Column> columns_;   // May hold more than columnCount_ from an earlier, wider chunk
+};
+
+// Rule prepared for repeated evaluation: condition constants are normalized once (trimmed, lowercased,
+// parsed as numbers, regex compiled), so matching a row only has to look at its cells
+class CompiledRule {
+public:
+    virtual ~CompiledRule() = default;
+    virtual bool matches(const DataRow& row) const = 0;
+};
+
+// Rules compiled together so work they share is done once per row: all CONTAINS / NOT_CONTAINS
+// conditions on a column are answered by a single scan of the cell
+class CompiledRuleSet {
+public:
+    virtual ~CompiledRuleSet() = default;
+    virtual int ruleCount() const = 0;
+    // Position of the rule with this id in the results, -1 if absent (the first rule with an id wins)
+    virtual int ruleIndex(int ruleId) const = 0;
+    // Bit i of results (ruleCount() bits) is set if rule i matches the row
+    virtual void evaluate(const DataRow& row, std::vector<uint64_t>& results) const = 0;
+    // Every rule on every row of the chunk, one condition over a whole column at a time: ruleRows[i]
+    // is rule i's bitmap over the rows (bit r % 64 of word r / 64), the answers evaluate() gives per row
+    virtual void evaluateColumns(const ColumnarChunk& chunk, std::vector<std::vector<uint64_t>>& ruleRows) const = 0;
+    // 1-based columns the rules read, ascending; a chunk only needs these for evaluateColumns()
+    virtual std::vector<int> columns() const = 0;
+};
+
 // Rule engine interface
 class RuleEngine {
 public:
     virtual ~RuleEngine() = default;
     virtual bool evaluateRule(const Rule& rule, const DataRow& row, const std::vector<Rule>* allRules = nullptr) const = 0;
+    // Compiled form of rule; matches() returns what evaluateRule() would for the same row
+    virtual std::unique_ptr<CompiledRule> compileRule(const Rule& rule) const = 0;
+    virtual std::unique_ptr<CompiledRuleSet> compileRuleSet(const std::vector<Rule>& rules) const = 0;
     virtual bool evaluateCondition(const RuleCondition& condition,
-                                   const std::variant<std::string, int, double, bool, std::tm>& value) const = 0;
+                                   const CellValue& value) const = 0;
     virtual std::vector<std::string> getValidationErrors(const Rule& rule) const = 0;
 };
 
+// Sequential chunk cursor over one sheet (opened once, keeps its read position)
+class ChunkCursor {
+public:
+    virtual ~ChunkCursor() = default;
+    // Appends up to maxRows rows to data. The first chunk starts with the header row if includeHeader was requested.
+    virtual bool readNextChunk(std::vector<DataRow>& data, int maxRows) = 0;
+    virtual bool atEnd() const = 0;
+    // True if chunks may be read on a different thread than the one that opened the cursor
+    virtual bool supportsBackgroundRead() const { return false; }
+};
+
 // Data reader interface
 class ExcelReader {
 public:
     virtual ~ExcelReader() = default;
     virtual bool readExcelFile(const std::string& filename, std::vector<DataRow>& data, const std::string& sheetName = "", int maxRows = 0, int offset = 0, bool includeHeader = false) = 0;
+    // Default implementation re-reads through readExcelFile with a growing offset
+    virtual std::unique_ptr<ChunkCursor> openChunkCursor(const std::string& filename, const std::string& sheetName = "", bool includeHeader = false);
     virtual void setLogger(std::function<void(const std::string&)> logger) {}
     virtual bool getSheetNames(const std::string& filename, std::vector<std::string>& sheetNames) const = 0;
     virtual int getRowCount(const std::string& sheetName) const = 0;
     virtual int getColumnCount(const std::string& sheetName) const = 0;
+    // Releases what the reader keeps open between calls (parsed workbook, Excel instance)
+    virtual void closeInput() {}
+    // Number of times the reader has opened an input file (for benchmarks)
+    virtual int fileOpenCount() const { return 0; }
 };
 
 enum class ExcelWriterType {
     ActiveQt,
-    CSV
+    CSV,
+    Xlsx
+};
+
+// How REGEX conditions are matched
+enum class RegexEngine {
+    Automatic,  // Bit-parallel automaton for simple patterns, std::regex for the rest
+    StdRegex    // Always std::regex
 };
 
 // Data writer interface
@@ -348,4 +512,6 @@ public:
 };
 
 // Factory functions
-std::unique_ptr<RuleEngine> createRuleEngine();
\ No newline at end of file
+std::unique_ptr<RuleEngine> createRuleEngine(RegexEngine regexEngine = RegexEngine::Automatic);
+std::unique_ptr<ExcelReader> createExcelReader(const std::string& filename, bool memoryMapped = true); // Picks reader by file extension
+std::unique_ptr<ExcelWriter> createExcelWriter(ExcelWriterType type);
\ No newline at end of file
@@ -10,6 +10,30 @@
 #include <vector>
 #include <cstdlib>
 #include <ctime>
+#include <algorithm>
+#include <regex>
+#include <bitset>
+#include <functional>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+// Peak resident memory of the process so far, in MB
+static double peakResidentMB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize / 1024.0 / 1024.0;
+#else
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // Kilobytes on Linux
+#endif
+}
 
 class ConsoleExcelProcessor {
 public:
@@ -38,6 +62,20 @@ public:
         std::cout << "  -d, --delete <ID>       \xE5\x88\xA0\xE9\x99\xA4\xE6\x8C\x87\xE5\xAE\x9A\xE8\xA7\x84\xE5\x88\x99\n"; // Delete rule
         std::cout << "  -p, --preview <num>     \xE9\xA2\x84\xE8\xA7\x88\xE6\x8C\x87\xE5\xAE\x9A\xE6\x95\xB0\xE9\x87\x8F\xE6\x95\xB0\xE6\x8D\xAE\xE8\xA1\x8C\n"; // Preview data
         std::cout << "  -t, --test              \xE8\xBF\x90\xE8\xA1\x8C\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95\n"; // Run perf test
+        std::cout << "  --threads <num>         \xE5\xB7\xA5\xE4\xBD\x9C\xE7\xBA\xBF\xE7\xA8\x8B\xE6\x95\xB0 (0=\xE6\x8C\x89" "CPU\xE6\xA0\xB8\xE6\x95\xB0)\n"; // Worker threads (0 = one per core)
+        std::cout << "  --files <num>           \xE5\x90\x8C\xE6\x97\xB6\xE5\xA4\x84\xE7\x90\x86\xE7\x9A\x84\xE8\xBE\x93\xE5\x85\xA5\xE6\x96\x87\xE4\xBB\xB6\xE6\x95\xB0 (0=\xE6\x8C\x89" "CPU\xE6\xA0\xB8\xE6\x95\xB0)\n"; // Input files processed at once (0 = one per core)
+        std::cout << "  --bench-read <rows>     \xE5\x88\x86\xE5\x9D\x97\xE8\xAF\xBB\xE5\x8F\x96\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (100k \xE8\xB5\xB7, 10\xE5\x80\x8D\xE9\x80\x92\xE5\xA2\x9E)\n"; // Chunked read benchmark (from 100k, x10 steps)
+        std::cout << "  --bench-write <rows>    \xE5\x86\x99\xE5\x85\xA5\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE6\x95\xB0\xE5\x80\xBC/\xE5\xAD\x97\xE7\xAC\xA6\xE4\xB8\xB2)\n"; // Write benchmark (numeric / string rows)
+        std::cout << "  --bench-regex <rows>    \xE6\xAD\xA3\xE5\x88\x99\xE6\x9D\xA1\xE4\xBB\xB6\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE9\x80\x90\xE6\xA0\xBC\xE7\xBC\x96\xE8\xAF\x91/\xE7\xBC\x93\xE5\xAD\x98/\xE8\x87\xAA\xE5\x8A\xA8\xE6\x9C\xBA)\n"; // REGEX condition benchmark (per cell / cached / automaton)
+        std::cout << "  --bench-keywords <rows> \xE5\x85\xB3\xE9\x94\xAE\xE8\xAF\x8D\xE8\xA7\x84\xE5\x88\x99\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE9\x80\x90\xE6\x9D\xA1\xE8\xA7\x84\xE5\x88\x99/\xE8\xA7\x84\xE5\x88\x99\xE9\x9B\x86)\n"; // Keyword rule benchmark (per rule / rule set)
+        std::cout << "  --bench-inlist <rows>   \xE5\x80\xBC\xE5\x88\x97\xE8\xA1\xA8\xE8\xA7\x84\xE5\x88\x99\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE6\x96\x87\xE6\x9C\xAC/\xE6\x95\xB0\xE5\x80\xBC)\n"; // Value list benchmark (text / numeric)
+        std::cout << "  --bench-columns <rows>  \xE5\x88\x97\xE5\xBC\x8F\xE8\xA7\x84\xE5\x88\x99\xE6\xB1\x82\xE5\x80\xBC\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE9\x80\x90\xE8\xA1\x8C/\xE6\x8C\x89\xE5\x88\x97)\n"; // Columnar rule evaluation benchmark (by row / by column)
+        std::cout << "  --bench-text <rows>     \xE4\xBD\x8E\xE5\x9F\xBA\xE6\x95\xB0\xE6\x96\x87\xE6\x9C\xAC\xE5\x88\x97\xE8\xA7\x84\xE5\x88\x99\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95\n"; // Low-cardinality text column rule benchmark
+        std::cout << "  --bench-memory <rows>   \xE6\x95\xB4\xE8\xA1\xA8\xE5\x8A\xA0\xE8\xBD\xBD\xE5\x86\x85\xE5\xAD\x98\xE6\xB5\x8B\xE8\xAF\x95 (30\xE5\x88\x97, \xE5\xB3\xB0\xE5\x80\xBC\xE5\x86\x85\xE5\xAD\x98)\n"; // Whole-sheet load memory benchmark (30 columns, peak memory)
+        std::cout << "  --bench-input <rows>    \xE8\xBE\x93\xE5\x85\xA5\xE6\x96\x87\xE4\xBB\xB6\xE6\x89\x93\xE5\xBC\x80\xE6\xAC\xA1\xE6\x95\xB0\xE6\xB5\x8B\xE8\xAF\x95 (xlsx, 4\xE4\xB8\xAA\xE5\xB7\xA5\xE4\xBD\x9C\xE8\xA1\xA8)\n"; // Input open-count benchmark (xlsx, 4 sheets)
+        std::cout << "  --bench-shared <rows>   \xE5\x85\xB1\xE4\xBA\xAB\xE8\xA7\x84\xE5\x88\x99\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (20\xE4\xB8\xAA\xE4\xBB\xBB\xE5\x8A\xA1)\n"; // Shared rule benchmark (20 tasks)
+        std::cout << "  --bench-pipeline <rows> \xE6\xB5\x81\xE6\xB0\xB4\xE7\xBA\xBF\xE5\xA4\x84\xE7\x90\x86\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE4\xB8\xB2\xE8\xA1\x8C/\xE6\xB5\x81\xE6\xB0\xB4\xE7\xBA\xBF)\n"; // Task pipeline benchmark (serial / pipelined)
+        std::cout << "  --bench-files <files>   \xE5\xA4\x9A\xE6\x96\x87\xE4\xBB\xB6\xE5\xB9\xB6\xE8\xA1\x8C\xE5\xA4\x84\xE7\x90\x86\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95 (\xE6\xAF\x8F\xE4\xB8\xAA" "20000\xE8\xA1\x8C)\n"; // Multi-file processing benchmark (20000 rows each)
         std::cout << "  -v, --validate          \xE9\xAA\x8C\xE8\xAF\x81\xE8\xA7\x84\xE5\x88\x99\xE9\x85\x8D\xE7\xBD\xAE\n"; // Validate rules
         std::cout << "  -s, --stats             \xE6\x98\xBE\xE7\xA4\xBA\xE6\x80\xA7\xE8\x83\xBD\xE7\xBB\x9F\xE8\xAE\xA1\n"; // Show stats
         std::cout << "  --no-gui                \xE7\xA6\x81\xE7\x94\xA8GUI (\xE7\xBA\xAF\xE5\x91\xBD\xE4\xBB\xA4\xE8\xA1\x8C\xE6\xA8\xA1\xE5\xBC\x8F)\n"; // No GUI
@@ -205,10 +243,30 @@ public:
 
         std::cout << "\xE6\xAD\xA3\xE5\x9C\xA8\xE8\xBF\x90\xE8\xA1\x8C\xE6\x80\xA7\xE8\x83\xBD\xE6\xB5\x8B\xE8\xAF\x95...\n"; // Running perf test...
 
+        ExcelProcessorCore::resetWorkerUtilization();
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        // Load config if needed, or add default rule
-        // processor_->loadConfiguration(...);
+        // Without a configuration (-c before -t) there is nothing to evaluate, so filter with sample rules
+        if (processor_->getRules().empty() && processor_->getRuleCombinations().empty()) {
+            std::cout << "\xE6\x9C\xAA\xE9\x85\x8D\xE7\xBD\xAE\xE8\xA7\x84\xE5\x88\x99\xE7\xBB\x84\xE5\x90\x88, \xE4\xBD\xBF\xE7\x94\xA8\xE7\xA4\xBA\xE4\xBE\x8B\xE8\xA7\x84\xE5\x88\x99\n"; // No combinations configured, using sample rules
+            auto addRule = [this](int id, RuleType type, int column, Operator oper, const std::string& value) {
+                Rule rule;
+                rule.id = id;
+                rule.name = "Sample " + std::to_string(id);
+                rule.type = type;
+                RuleCondition cond;
+                cond.column = column;
+                cond.oper = oper;
+                cond.value = value;
+                rule.conditions.push_back(cond);
+                processor_->addRule(rule);
+            };
+            addRule(1, RuleType::FILTER, 4, Operator::GREATER, "500");
+            addRule(2, RuleType::FILTER, 5, Operator::EQUAL, "Active");
+            addRule(3, RuleType::DELETE_ROW, 8, Operator::ENDS_WITH, "7");
+            processor_->createRuleCombination(1, { 1, 2 });
+            processor_->createRuleCombination(2, { 3 });
+        }
 
         auto result = processor_->processExcelFile(testFile, testFile + "_result.csv");
 
@@ -221,12 +279,744 @@ public:
         std::cout << "\xE5\xA4\x84\xE7\x90\x86\xE6\x97\xB6\xE9\x97\xB4: " << std::fixed << std::setprecision(3) << duration.count() << " \xE6\xAF\xAB\xE7\xA7\x92\n"; // Processing time
         std::cout << "\xE5\xA4\x84\xE7\x90\x86\xE9\x80\x9F\xE5\xBA\xA6: " << std::fixed << std::setprecision(0) << (result.processedRows / (duration.count() / 1000.0)) << " \xE8\xA1\x8C/\xE7\xA7\x92\n"; // Speed
 
+        // The rule stage on its own, in a fresh processor with the same rules: the loaded rows are copied
+        // and run through the combinations
+        ExcelProcessorCore stage;
+        for (const auto& rule : processor_->getRules()) stage.addRule(rule);
+        for (const auto& [comboId, ruleIds] : processor_->getRuleCombinations()) stage.createRuleCombination(comboId, ruleIds);
+        if (stage.loadFile(testFile)) {
+            auto ruleStart = std::chrono::high_resolution_clock::now();
+            auto kept = stage.getProcessedPreviewData(dataRows + 1);
+            auto ruleMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - ruleStart);
+            std::cout << "\xE8\xA7\x84\xE5\x88\x99\xE5\xA4\x84\xE7\x90\x86\xE6\x97\xB6\xE9\x97\xB4: " << ruleMs.count() << " \xE6\xAF\xAB\xE7\xA7\x92 (\xE4\xBF\x9D\xE7\x95\x99 " << kept.size() << " \xE8\xA1\x8C)\n"; // Rule stage time (rows kept)
+        }
+
+        // Per-thread work of the scheduler over the whole test; thread 0 is the calling thread
+        auto utilization = ExcelProcessorCore::getWorkerUtilization();
+        std::cout << "\n\xE7\xBA\xBF\xE7\xA8\x8B  \xE5\xB7\xA5\xE4\xBD\x9C\xE9\xA1\xB9  \xE7\xAA\x83\xE5\x8F\x96  \xE5\x88\xA9\xE7\x94\xA8\xE7\x8E\x87\n"; // Thread, work items, steals, utilisation
+        for (size_t t = 0; t < utilization.size(); ++t) {
+            std::cout << std::setw(4) << t << std::setw(8) << utilization[t].morsels << std::setw(6) << utilization[t].steals
+                      << std::setw(8) << std::fixed << std::setprecision(1) << utilization[t].utilization * 100.0 << "%\n";
+        }
+
         try {
             std::remove(testFile.c_str());
             std::remove((testFile + "_result.csv").c_str());
         } catch (...) {}
     }
 
+    // Chunked read scaling: streaming cursor vs legacy offset re-read (which re-skips all previous lines)
+    void runReadBenchmark(int maxRows) {
+        printHeader();
+        std::cout << "Chunked read benchmark (chunk size 5000)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(10) << "Rows" << std::setw(14) << "Cursor ms" << std::setw(14) << "ns/row"
+                  << std::setw(14) << "Offset ms" << "\n";
+
+        const int chunkSize = 5000;
+        for (int rows = 100000; rows <= maxRows; rows *= 10) {
+            std::string testFile = "bench_read_" + std::to_string(rows) + ".csv";
+            generateTestData(testFile, rows);
+
+            auto reader = createExcelReader(testFile);
+            std::vector<DataRow> chunk;
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            size_t cursorRows = 0;
+            auto cursor = reader->openChunkCursor(testFile);
+            while (cursor && !cursor->atEnd()) {
+                chunk.clear();
+                cursor->readNextChunk(chunk, chunkSize);
+                cursorRows += chunk.size();
+            }
+            double cursorMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            // The offset path is quadratic; skip it past 1M rows to keep the run short
+            std::string offsetCol = "-";
+            if (rows <= 1000000) {
+                startTime = std::chrono::high_resolution_clock::now();
+                for (int offset = 0; ; offset += chunkSize) {
+                    chunk.clear();
+                    reader->readExcelFile(testFile, chunk, "", chunkSize, offset);
+                    if (static_cast<int>(chunk.size()) < chunkSize) break;
+                }
+                double offsetMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(1) << offsetMs;
+                offsetCol = oss.str();
+            }
+
+            std::cout << std::setw(10) << cursorRows
+                      << std::setw(14) << std::fixed << std::setprecision(1) << cursorMs
+                      << std::setw(14) << std::fixed << std::setprecision(1) << (cursorMs * 1e6 / (cursorRows > 0 ? cursorRows : 1))
+                      << std::setw(14) << offsetCol << "\n";
+
+            std::remove(testFile.c_str());
+        }
+
+        // Tokenizer throughput on the same rows with and without RFC 4180 quoting
+        int quoteRows = std::min(maxRows, 1000000);
+        std::cout << "\nQuoted vs plain CSV (" << quoteRows << " rows)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(10) << "File" << std::setw(14) << "MB" << std::setw(14) << "Cursor MB/s"
+                  << std::setw(14) << "Full MB/s" << "\n";
+        for (bool quoted : { false, true }) {
+            std::string testFile = quoted ? "bench_read_quoted.csv" : "bench_read_plain.csv";
+            if (quoted) generateQuotedTestData(testFile, quoteRows);
+            else generateTestData(testFile, quoteRows);
+
+            auto reader = createExcelReader(testFile);
+            std::vector<DataRow> chunk;
+            auto startTime = std::chrono::high_resolution_clock::now();
+            auto cursor = reader->openChunkCursor(testFile);
+            while (cursor && !cursor->atEnd()) {
+                chunk.clear();
+                cursor->readNextChunk(chunk, chunkSize);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            // Whole-file read: parsed on all cores over record-aligned byte ranges
+            std::vector<DataRow> all;
+            startTime = std::chrono::high_resolution_clock::now();
+            reader->readExcelFile(testFile, all);
+            double fullMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            std::ifstream sizeCheck(testFile, std::ios::binary | std::ios::ate);
+            double mb = static_cast<double>(sizeCheck.tellg()) / (1024.0 * 1024.0);
+            sizeCheck.close();
+            std::cout << std::setw(10) << (quoted ? "quoted" : "plain")
+                      << std::setw(14) << std::fixed << std::setprecision(1) << mb
+                      << std::setw(14) << std::fixed << std::setprecision(1) << (mb * 1000.0 / (ms > 0 ? ms : 1))
+                      << std::setw(14) << std::fixed << std::setprecision(1) << (mb * 1000.0 / (fullMs > 0 ? fullMs : 1)) << "\n";
+
+            std::remove(testFile.c_str());
+        }
+    }
+
+    void runWriteBenchmark(int rows) {
+        printHeader();
+        std::cout << "CSV write benchmark (" << rows << " rows, 10 columns)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(10) << "Data" << std::setw(14) << "MB" << std::setw(14) << "ms" << std::setw(14) << "MB/s" << "\n";
+
+        for (bool numeric : { true, false }) {
+            std::vector<DataRow> data(rows);
+            for (int i = 0; i < rows; ++i) {
+                auto& cells = data[i].data;
+                for (int c = 0; c < 10; ++c) {
+                    if (numeric) {
+                        if (c % 2 == 0) cells.push_back(i * 10 + c);
+                        else cells.push_back((i * 10 + c) / 7.0);
+                    } else {
+                        cells.push_back("Customer name " + std::to_string(i) + "-" + std::to_string(c));
+                    }
+                }
+            }
+
+            std::string testFile = numeric ? "bench_write_numeric.csv" : "bench_write_string.csv";
+            auto writer = createExcelWriter(ExcelWriterType::CSV);
+            auto startTime = std::chrono::high_resolution_clock::now();
+            writer->writeExcelFile(testFile, data);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            std::ifstream sizeCheck(testFile, std::ios::binary | std::ios::ate);
+            double mb = static_cast<double>(sizeCheck.tellg()) / (1024.0 * 1024.0);
+            sizeCheck.close();
+            std::cout << std::setw(10) << (numeric ? "numeric" : "string")
+                      << std::setw(14) << std::fixed << std::setprecision(1) << mb
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ms
+                      << std::setw(14) << std::fixed << std::setprecision(1) << (mb * 1000.0 / (ms > 0 ? ms : 1)) << "\n";
+
+            std::remove(testFile.c_str());
+        }
+    }
+
+    void runRegexBenchmark(int rows) {
+        printHeader();
+        std::cout << "REGEX condition benchmark (" << rows << " cells per pattern)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(20) << "Pattern" << std::setw(14) << "per cell ms" << std::setw(14) << "std ms"
+                  << std::setw(14) << "auto ms" << std::setw(10) << "matches" << "\n";
+
+        std::vector<std::string> cells(rows);
+        const char* samples[] = { "ABC1234", "ORD-20240517", "disk error on node 7", "abc123", "foo42", "Customer name" };
+        for (int i = 0; i < rows; ++i) cells[i] = samples[i % 6] + std::string(i % 7 == 0 ? "x" : "");
+
+        // The last pattern needs a group, so both engines use std::regex for it
+        for (const char* pattern : { "[A-Z]{3}\\d{4}", "ORD-\\d+", ".*error.*", "(foo|bar)\\d*" }) {
+            Rule rule;
+            rule.id = 1;
+            RuleCondition condition;
+            condition.column = 1;
+            condition.oper = Operator::REGEX;
+            condition.value = std::string(pattern);
+            condition.case_sensitive = true;
+            rule.conditions.push_back(condition);
+
+            // Before: the pattern was compiled again for every cell
+            int perCellMatches = 0;
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (const auto& cell : cells) {
+                if (std::regex_match(cell, std::regex(pattern))) perCellMatches++;
+            }
+            double perCellMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            double engineMs[2] = {};
+            int engineMatches[2] = {};
+            RegexEngine engines[2] = { RegexEngine::StdRegex, RegexEngine::Automatic };
+            for (int e = 0; e < 2; ++e) {
+                auto compiled = createRuleEngine(engines[e])->compileRule(rule);
+                DataRow row;
+                row.data.resize(1);
+                startTime = std::chrono::high_resolution_clock::now();
+                for (const auto& cell : cells) {
+                    row.data[0] = cell;
+                    if (compiled->matches(row)) engineMatches[e]++;
+                }
+                engineMs[e] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            }
+
+            std::cout << std::setw(20) << pattern
+                      << std::setw(14) << std::fixed << std::setprecision(1) << perCellMs
+                      << std::setw(14) << std::fixed << std::setprecision(1) << engineMs[0]
+                      << std::setw(14) << std::fixed << std::setprecision(1) << engineMs[1]
+                      << std::setw(10) << engineMatches[1]
+                      << (perCellMatches == engineMatches[0] && engineMatches[0] == engineMatches[1] ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    void runKeywordBenchmark(int rows) {
+        printHeader();
+        std::cout << "Keyword rule benchmark (" << rows << " rows, CONTAINS / NOT_CONTAINS rules on one column)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(10) << "Rules" << std::setw(16) << "per rule ms" << std::setw(16) << "rule set ms"
+                  << std::setw(10) << "matches" << "\n";
+
+        std::vector<DataRow> data(rows);
+        for (int i = 0; i < rows; ++i) {
+            data[i].data.push_back("Order " + std::to_string(i) + " shipped to customer " + std::to_string(i % 977) +
+                                   (i % 13 == 0 ? " - REFUND requested" : " without issues"));
+        }
+
+        for (int ruleCount : { 1, 10, 50, 200 }) {
+            std::vector<Rule> rules;
+            for (int r = 0; r < ruleCount; ++r) {
+                Rule rule;
+                rule.id = r + 1;
+                RuleCondition condition;
+                condition.column = 1;
+                condition.oper = r % 5 == 4 ? Operator::NOT_CONTAINS : Operator::CONTAINS;
+                condition.value = r == 0 ? std::string("refund") : "keyword" + std::to_string(r) + "x";
+                rule.conditions.push_back(condition);
+                rules.push_back(rule);
+            }
+            auto engine = createRuleEngine();
+
+            // Before: every rule searches its own lowercased copy of the cell
+            std::vector<std::unique_ptr<CompiledRule>> compiled;
+            for (const auto& rule : rules) compiled.push_back(engine->compileRule(rule));
+            int perRuleMatches = 0;
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (const auto& row : data) {
+                for (const auto& rule : compiled) {
+                    if (rule->matches(row)) perRuleMatches++;
+                }
+            }
+            double perRuleMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            auto ruleSet = engine->compileRuleSet(rules);
+            std::vector<uint64_t> results;
+            int setMatches = 0;
+            startTime = std::chrono::high_resolution_clock::now();
+            for (const auto& row : data) {
+                ruleSet->evaluate(row, results);
+                for (uint64_t word : results) setMatches += static_cast<int>(std::bitset<64>(word).count());
+            }
+            double setMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            std::cout << std::setw(10) << ruleCount
+                      << std::setw(16) << std::fixed << std::setprecision(1) << perRuleMs
+                      << std::setw(16) << std::fixed << std::setprecision(1) << setMs
+                      << std::setw(10) << setMatches << (setMatches == perRuleMatches ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    void runInListBenchmark(int rows) {
+        printHeader();
+        std::cout << "Value list benchmark (" << rows << " rows, 2000 values, us per row)\n";
+        std::cout << "---------------------------------------------\n";
+        std::cout << std::setw(10) << "Column" << std::setw(16) << "interpreted" << std::setw(16) << "OR of EQUAL"
+                  << std::setw(16) << "IN_LIST" << std::setw(10) << "matches" << "\n";
+
+        const int valueCount = 2000;
+        for (bool numeric : { false, true }) {
+            std::vector<DataRow> data(rows);
+            for (int i = 0; i < rows; ++i) {
+                int code = (i * 7919) % (valueCount * 4);
+                if (numeric) data[i].data.push_back(code);
+                else data[i].data.push_back("CUST-" + std::to_string(code));
+            }
+
+            Rule orRule;
+            orRule.id = 1;
+            orRule.logic = RuleLogic::OR;
+            Rule listRule;
+            listRule.id = 2;
+            std::string list;
+            for (int v = 0; v < valueCount; ++v) {
+                std::string value = numeric ? std::to_string(v * 2) : "cust-" + std::to_string(v * 2);
+                RuleCondition condition;
+                condition.column = 1;
+                condition.oper = Operator::EQUAL;
+                condition.value = value;
+                orRule.conditions.push_back(condition);
+                list += (v ? "," : "") + value;
+            }
+            RuleCondition listCondition;
+            listCondition.column = 1;
+            listCondition.oper = Operator::IN_LIST;
+            listCondition.value = list;
+            listRule.conditions.push_back(listCondition);
+
+            auto engine = createRuleEngine();
+            auto time = [&data](int count, const std::function<bool(const DataRow&)>& matches, int& matched) {
+                matched = 0;
+                auto startTime = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < count; ++i) {
+                    if (matches(data[i])) matched++;
+                }
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+                return ms * 1000.0 / (count > 0 ? count : 1);
+            };
+
+            // The interpreter compares every condition in turn, so it only gets a sample of the rows
+            int interpretedMatches = 0, orMatches = 0, listMatches = 0;
+            double interpretedUs = time(std::min(rows, 2000), [&](const DataRow& row) { return engine->evaluateRule(orRule, row); }, interpretedMatches);
+            auto compiledOr = engine->compileRule(orRule);
+            double orUs = time(rows, [&](const DataRow& row) { return compiledOr->matches(row); }, orMatches);
+            auto compiledList = engine->compileRule(listRule);
+            double listUs = time(rows, [&](const DataRow& row) { return compiledList->matches(row); }, listMatches);
+
+            std::cout << std::setw(10) << (numeric ? "numeric" : "text")
+                      << std::setw(16) << std::fixed << std::setprecision(3) << interpretedUs
+                      << std::setw(16) << std::fixed << std::setprecision(3) << orUs
+                      << std::setw(16) << std::fixed << std::setprecision(3) << listUs
+                      << std::setw(10) << listMatches << (orMatches == listMatches ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    void runColumnarBenchmark(int rows) {
+        printHeader();
+        std::cout << "Columnar rule benchmark (" << rows << " rows in chunks of 5000, 8 columns, 24 rules, ns per row)\n";
+        std::cout << "---------------------------------------------\n";
+
+        const int chunkSize = 5000;
+        std::vector<DataRow> data(std::min(rows, chunkSize));
+        for (size_t i = 0; i < data.size(); ++i) {
+            auto& cells = data[i].data;
+            cells.push_back(static_cast<int>(i));
+            cells.push_back("Customer " + std::to_string(i));
+            cells.push_back(std::string(i % 4 == 0 ? "North" : "South"));
+            cells.push_back((i % 997) / 7.0);
+            cells.push_back(static_cast<int>(i % 50));
+            cells.push_back((i * 7919 % 10000) / 100.0);
+            cells.push_back(i % 2 == 0);
+            cells.push_back("C" + std::to_string(i % 10000));
+        }
+
+        // Mostly numeric range checks, as in amount / quantity / score filters, plus a few text rules
+        std::vector<Rule> rules;
+        for (int r = 0; r < 24; ++r) {
+            Rule rule;
+            rule.id = r + 1;
+            rule.logic = r % 3 == 0 ? RuleLogic::OR : RuleLogic::AND;
+            auto add = [&rule](int column, Operator oper, const std::string& value) {
+                RuleCondition cond;
+                cond.column = column;
+                cond.oper = oper;
+                cond.value = value;
+                rule.conditions.push_back(cond);
+            };
+            int column = std::vector<int>{ 1, 4, 5, 6 }[r % 4];
+            add(column, Operator::GREATER_EQUAL, std::to_string(r * 3));
+            add(column, Operator::LESS, std::to_string(r * 3 + 40));
+            if (r % 4 == 1) add(5, Operator::NOT_EQUAL, std::to_string(r));
+            if (r % 8 == 7) add(3, Operator::EQUAL, "North");
+            rules.push_back(rule);
+        }
+        auto engine = createRuleEngine();
+        auto ruleSet = engine->compileRuleSet(rules);
+        const int passes = std::max(1, rows / static_cast<int>(data.size()));
+        const double rowCount = static_cast<double>(passes) * data.size();
+
+        std::vector<std::vector<uint64_t>> byRow, byColumn;
+        std::vector<uint64_t> results;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            byRow.assign(rules.size(), std::vector<uint64_t>((data.size() + 63) / 64, 0));
+            for (size_t row = 0; row < data.size(); ++row) {
+                ruleSet->evaluate(data[row], results);
+                for (size_t r = 0; r < rules.size(); ++r) {
+                    if ((results[r / 64] >> (r % 64)) & 1) byRow[r][row / 64] |= uint64_t(1) << (row % 64);
+                }
+            }
+        }
+        double rowNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count() / rowCount;
+
+        ColumnarChunk chunk;
+        double convertNs = 0.0, columnNs = 0.0;
+        for (int p = 0; p < passes; ++p) {
+            auto convertStart = std::chrono::high_resolution_clock::now();
+            chunk.assign(data, ruleSet->columns());
+            auto evaluateStart = std::chrono::high_resolution_clock::now();
+            ruleSet->evaluateColumns(chunk, byColumn);
+            auto end = std::chrono::high_resolution_clock::now();
+            convertNs += std::chrono::duration<double, std::nano>(evaluateStart - convertStart).count();
+            columnNs += std::chrono::duration<double, std::nano>(end - evaluateStart).count();
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Row at a time:        " << rowNs << "\n";
+        std::cout << "Column at a time:     " << (convertNs + columnNs) / rowCount << " (convert " << convertNs / rowCount
+                  << ", evaluate " << columnNs / rowCount << ")" << (byRow == byColumn ? "" : "  MISMATCH") << "\n";
+    }
+
+    void runTextColumnBenchmark(int rows) {
+        printHeader();
+        std::cout << "Text column rule benchmark (" << rows << " rows in chunks of 5000, 5 columns, 24 rules, ns per row)\n";
+        std::cout << "---------------------------------------------\n";
+
+        // Region, status and category repeat a few values; the name is different on every row
+        const char* regions[] = { "North", "South", "East", "West", "Central", "North East", "South West", "Overseas" };
+        const char* statuses[] = { "Open", "Closed", "Pending", "Cancelled", "On Hold" };
+        const int chunkSize = 5000;
+        std::vector<DataRow> data(std::min(rows, chunkSize));
+        for (size_t i = 0; i < data.size(); ++i) {
+            auto& cells = data[i].data;
+            cells.push_back(std::string(regions[i * 7 % 8]));
+            cells.push_back(std::string(statuses[i * 3 % 5]));
+            cells.push_back("Category " + std::to_string(i * 13 % 40));
+            cells.push_back("Customer " + std::to_string(i));
+            cells.push_back((i * 7919 % 10000) / 100.0);
+        }
+
+        std::vector<Rule> rules;
+        for (int r = 0; r < 24; ++r) {
+            Rule rule;
+            rule.id = r + 1;
+            rule.logic = r % 3 == 0 ? RuleLogic::OR : RuleLogic::AND;
+            auto add = [&rule](int column, Operator oper, const std::string& value) {
+                RuleCondition cond;
+                cond.column = column;
+                cond.oper = oper;
+                cond.value = value;
+                rule.conditions.push_back(cond);
+            };
+            add(1, r % 2 ? Operator::EQUAL : Operator::NOT_EQUAL, regions[r % 8]);
+            add(2, r % 4 == 3 ? Operator::IN_LIST : Operator::STARTS_WITH, r % 4 == 3 ? "open,pending" : statuses[r % 5]);
+            add(3, r % 3 ? Operator::ENDS_WITH : Operator::REGEX, r % 3 ? std::to_string(r % 10) : "category [1-3]\\d");
+            if (r % 6 == 5) add(4, Operator::CONTAINS, std::to_string(r) + "9");
+            rules.push_back(rule);
+        }
+        auto engine = createRuleEngine();
+        auto ruleSet = engine->compileRuleSet(rules);
+        const int passes = std::max(1, rows / static_cast<int>(data.size()));
+        const double rowCount = static_cast<double>(passes) * data.size();
+
+        std::vector<std::vector<uint64_t>> byRow, byColumn;
+        std::vector<uint64_t> results;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int p = 0; p < passes; ++p) {
+            byRow.assign(rules.size(), std::vector<uint64_t>((data.size() + 63) / 64, 0));
+            for (size_t row = 0; row < data.size(); ++row) {
+                ruleSet->evaluate(data[row], results);
+                for (size_t r = 0; r < rules.size(); ++r) {
+                    if ((results[r / 64] >> (r % 64)) & 1) byRow[r][row / 64] |= uint64_t(1) << (row % 64);
+                }
+            }
+        }
+        double rowNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count() / rowCount;
+
+        ColumnarChunk chunk;
+        double convertNs = 0.0, columnNs = 0.0;
+        for (int p = 0; p < passes; ++p) {
+            auto convertStart = std::chrono::high_resolution_clock::now();
+            chunk.assign(data, ruleSet->columns());
+            auto evaluateStart = std::chrono::high_resolution_clock::now();
+            ruleSet->evaluateColumns(chunk, byColumn);
+            auto end = std::chrono::high_resolution_clock::now();
+            convertNs += std::chrono::duration<double, std::nano>(evaluateStart - convertStart).count();
+            columnNs += std::chrono::duration<double, std::nano>(end - evaluateStart).count();
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Row at a time:        " << rowNs << "\n";
+        std::cout << "Column at a time:     " << (convertNs + columnNs) / rowCount << " (convert " << convertNs / rowCount
+                  << ", evaluate " << columnNs / rowCount << ")" << (byRow == byColumn ? "" : "  MISMATCH") << "\n";
+    }
+
+    void runMemoryBenchmark(int rows) {
+        printHeader();
+        std::cout << "Load memory benchmark (" << rows << " rows x 30 columns, whole CSV file into memory)\n";
+        std::cout << "---------------------------------------------\n";
+
+        // Numbers, short codes, dates and names past the small-string buffer, six columns of each
+        std::string inputFile = "bench_memory_input.csv";
+        {
+            std::ofstream out(inputFile);
+            for (int i = 0; i < rows; ++i) {
+                for (int c = 0; c < 30; ++c) {
+                    if (c) out << ',';
+                    switch (c % 5) {
+                        case 0: out << (i + c); break;
+                        case 1: out << (i % 997) / 7.0 + c; break;
+                        case 2: out << 'C' << (i + c) % 10000; break;
+                        case 3: out << "2024-" << (1 + (i + c) % 12) << '-' << (1 + i % 28); break;
+                        default: out << "Customer name " << (i + c);
+                    }
+                }
+                out << "\n";
+            }
+        }
+        double baseMB = peakResidentMB();
+
+        std::vector<DataRow> data;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        createExcelReader(inputFile)->readExcelFile(inputFile, data, "", 0, 0, true);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Rows loaded:   " << data.size() << " in " << ms << " ms\n";
+        std::cout << "Cell size:     " << sizeof(DataRow().data[0]) << " bytes, row header " << sizeof(DataRow) << " bytes\n";
+        std::cout << "Peak RSS:      " << peakResidentMB() << " MB (" << peakResidentMB() - baseMB << " MB for the load)\n";
+        std::remove(inputFile.c_str());
+    }
+
+    void runInputCacheBenchmark(int rows) {
+        printHeader();
+        std::cout << "Input open benchmark (" << rows << " rows per sheet, 8 columns, .xlsx)\n";
+        std::cout << "---------------------------------------------\n";
+
+        std::string inputFile = "bench_input.xlsx";
+        const int sheetCount = 4;
+        {
+            std::map<std::string, std::vector<DataRow>> sheets;
+            for (int s = 1; s <= sheetCount; ++s) {
+                auto& data = sheets["Sheet" + std::to_string(s)];
+                data.resize(rows);
+                for (int i = 0; i < rows; ++i) {
+                    auto& cells = data[i].data;
+                    cells.push_back(i);
+                    cells.push_back("Customer " + std::to_string(i));
+                    cells.push_back(std::string(i % 4 == 0 ? "North" : "South"));
+                    cells.push_back((i % 997) / 7.0);
+                    cells.push_back("C" + std::to_string(i % 10000));
+                    cells.push_back(i % 50);
+                    cells.push_back(i % 2 == 0);
+                    cells.push_back("Note " + std::to_string(i));
+                }
+            }
+            auto writer = createExcelWriter(ExcelWriterType::Xlsx);
+            writer->writeMultipleSheets(inputFile, sheets);
+            writer->closeAll();
+        }
+
+        // List the sheets and read each one, with a new reader per call or one reader for the whole pass
+        std::cout << std::setw(16) << "Reader" << std::setw(10) << "Opens" << std::setw(14) << "ms" << "\n";
+        for (bool shared : { false, true }) {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            int opens = 0;
+            auto reader = createExcelReader(inputFile);
+            std::vector<std::string> names;
+            reader->getSheetNames(inputFile, names);
+            for (const auto& name : names) {
+                std::unique_ptr<ExcelReader> sheetReader;
+                if (!shared) sheetReader = createExcelReader(inputFile);
+                ExcelReader* current = shared ? reader.get() : sheetReader.get();
+                auto cursor = current->openChunkCursor(inputFile, name, true);
+                std::vector<DataRow> chunk;
+                while (cursor && !cursor->atEnd()) {
+                    chunk.clear();
+                    if (!cursor->readNextChunk(chunk, 5000)) break;
+                }
+                if (sheetReader) opens += sheetReader->fileOpenCount();
+            }
+            opens += reader->fileOpenCount();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            std::cout << std::setw(16) << (shared ? "shared" : "per call") << std::setw(10) << opens
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ms << "\n";
+        }
+
+        // A full task run over every sheet
+        ExcelProcessorCore processor;
+        ProcessingTask task;
+        task.id = 1;
+        task.taskName = "bench_input_out.csv";
+        task.outputMode = OutputMode::NEW_WORKBOOK;
+        task.useHeader = true;
+        processor.addTask(task);
+        processor.processTasks(inputFile);
+        std::cout << "processTasks over " << sheetCount << " sheets: " << processor.inputFileOpenCount() << " input open(s)\n";
+
+        std::remove("bench_input_out.csv");
+        std::remove(inputFile.c_str());
+    }
+
+    void runSharedRuleBenchmark(int rows) {
+        printHeader();
+        std::cout << "Shared rule benchmark (" << rows << " rows, 20 CSV output tasks sharing 4 exclusion rules)\n";
+        std::cout << "---------------------------------------------\n";
+
+        std::string inputFile = "bench_shared_input.csv";
+        {
+            std::ofstream out(inputFile);
+            out << "ID,Name,Region,Amount,Code,Note\n";
+            for (int i = 0; i < rows; ++i) {
+                out << i << ",Customer " << i << "," << (i % 4 == 0 ? "North" : "South") << "," << (i % 1000)
+                    << ",C" << (i % 10000) << ",note " << (i % 13 == 0 ? "blocked" : "ok") << "\n";
+            }
+        }
+
+        ExcelProcessorCore processor;
+        auto addRule = [&processor](int id, int column, Operator oper, const std::string& value) {
+            Rule rule;
+            rule.id = id;
+            rule.name = "Rule" + std::to_string(id);
+            RuleCondition cond;
+            cond.column = column;
+            cond.oper = oper;
+            cond.value = value;
+            rule.conditions.push_back(cond);
+            processor.addRule(rule);
+        };
+        addRule(1, 3, Operator::EQUAL, "North");
+        addRule(2, 4, Operator::GREATER, "500");
+        addRule(10, 6, Operator::CONTAINS, "blocked");
+        addRule(11, 5, Operator::REGEX, "C9\\d{3}");
+        addRule(12, 2, Operator::ENDS_WITH, "7");
+        addRule(13, 4, Operator::EQUAL, "0");
+        for (int t = 1; t <= 20; ++t) {
+            ProcessingTask task;
+            task.id = t;
+            task.taskName = "bench_shared_out" + std::to_string(t) + ".csv";
+            task.outputMode = OutputMode::NEW_WORKBOOK;
+            task.rules.push_back(TaskRuleEntry(1 + t % 2));
+            task.excludeRuleIds = { 10, 11, 12, 13 };
+            processor.addTask(task);
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        processor.processTasks(inputFile);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << "Time: " << std::fixed << std::setprecision(1) << ms << " ms\n";
+        std::cout << "Rows evaluated against the rules: " << processor.ruleRowEvaluationCount()
+                  << " (rule references per row: 20 tasks x 5)\n";
+
+        for (int t = 1; t <= 20; ++t) std::remove(("bench_shared_out" + std::to_string(t) + ".csv").c_str());
+        std::remove(inputFile.c_str());
+    }
+
+    void runPipelineBenchmark(int rows) {
+        printHeader();
+        std::cout << "Task pipeline benchmark (" << rows << " rows, 10 columns, 4 CSV output tasks)\n";
+        std::cout << "---------------------------------------------\n";
+
+        std::string inputFile = "bench_pipeline_input.csv";
+        {
+            std::ofstream out(inputFile);
+            out << "ID,Name,Region,Amount,Price,Qty,Flag,Code,Note,Score\n";
+            for (int i = 0; i < rows; ++i) {
+                out << i << ",Customer " << i << "," << (i % 4 == 0 ? "North" : "South") << "," << (i % 1000)
+                    << "," << (i % 997) / 7.0 << "," << (i % 50) << "," << (i % 2 ? "true" : "false")
+                    << ",C" << (i % 10000) << ",\"note, " << i << "\"," << (i % 100) << "\n";
+            }
+        }
+
+        Rule rule;
+        rule.id = 1;
+        rule.name = "North";
+        rule.type = RuleType::FILTER;
+        rule.enabled = true;
+        RuleCondition cond;
+        cond.column = 3;
+        cond.oper = Operator::NOT_EQUAL;
+        cond.value = std::string("North");
+        rule.conditions.push_back(cond);
+
+        std::cout << std::setw(12) << "Mode" << std::setw(14) << "ms" << "\n";
+        for (bool pipelined : { false, true }) {
+            ExcelProcessorCore processor;
+            processor.addRule(rule);
+            for (int t = 1; t <= 4; ++t) {
+                ProcessingTask task;
+                task.id = t;
+                task.taskName = "bench_pipeline_out" + std::to_string(t) + ".csv";
+                task.outputMode = OutputMode::NEW_WORKBOOK;
+                task.useHeader = true;
+                if (t % 2 == 0) task.rules.push_back(TaskRuleEntry(rule.id));
+                processor.addTask(task);
+            }
+            processor.setPipelinedProcessing(pipelined);
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            processor.processTasks(inputFile);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            std::cout << std::setw(12) << (pipelined ? "pipelined" : "serial")
+                      << std::setw(14) << std::fixed << std::setprecision(1) << ms << "\n";
+
+            for (int t = 1; t <= 4; ++t) std::remove(("bench_pipeline_out" + std::to_string(t) + ".csv").c_str());
+        }
+        std::remove(inputFile.c_str());
+    }
+
+    void runFilesBenchmark(int files) {
+        printHeader();
+        const int rows = 20000;
+        std::cout << "Multi-file benchmark (" << files << " CSV files x " << rows << " rows, matched by bench_files_*.csv)\n";
+        std::cout << "---------------------------------------------\n";
+
+        for (int f = 0; f < files; ++f) {
+            std::ofstream out("bench_files_" + std::to_string(f) + ".csv");
+            out << "ID,Name,Region,Amount,Note\n";
+            for (int i = 0; i < rows; ++i) {
+                out << i << ",Customer " << i << "," << (i % 4 == 0 ? "North" : "South") << "," << (i % 1000)
+                    << ",\"note, " << i << "\"\n";
+            }
+        }
+
+        Rule rule;
+        rule.id = 1;
+        rule.name = "North";
+        rule.type = RuleType::FILTER;
+        rule.enabled = true;
+        RuleCondition cond;
+        cond.column = 3;
+        cond.oper = Operator::EQUAL;
+        cond.value = std::string("North");
+        rule.conditions.push_back(cond);
+
+        // Counting tasks write nothing, so no two files share a destination
+        std::cout << std::setw(12) << "Files" << std::setw(14) << "ms" << "\n";
+        for (int concurrent : { 1, 2, 4 }) {
+            ExcelProcessorCore processor;
+            processor.addRule(rule);
+            ProcessingTask task;
+            task.id = 1;
+            task.taskName = "North";
+            task.inputFilenamePattern = "bench_files_*.csv";
+            task.outputMode = OutputMode::NONE;
+            task.rules.push_back(TaskRuleEntry(rule.id));
+            processor.addTask(task);
+            processor.setConcurrentFiles(concurrent);
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            processor.processTasks("");
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+            std::cout << std::setw(12) << concurrent << std::setw(14) << std::fixed << std::setprecision(1) << ms << "\n";
+        }
+        for (int f = 0; f < files; ++f) std::remove(("bench_files_" + std::to_string(f) + ".csv").c_str());
+    }
+
     void showStats() {
         auto stats = processor_->getPerformanceStats();
         printHeader();
@@ -300,6 +1090,16 @@ public:
         }
     }
 
+    // Same columns as generateTestData, with every text cell quoted and some holding commas, quotes and newlines
+    void generateQuotedTestData(const std::string& filename, int rows) {
+        std::ofstream file(filename, std::ios::binary);
+        file << "ID,Name,Dept,Amount,Status,Date,City,Note\r\n";
+        for (int i = 1; i <= rows; ++i) {
+            file << i << ",\"Name" << i << ", Jr\",\"DeptA\"," << (100 + i) << ",\"Active\",2024-01-01,\"City \"\"A\"\"\",\"Note" << i
+                 << (i % 10 == 0 ? "\r\nsecond line\"" : "\"") << "\r\n";
+        }
+    }
+
     std::unique_ptr<ExcelProcessorCore> processor_;
 };
 
@@ -328,6 +1128,10 @@ int main(int argc, char* argv[]) {
             if (++i < argc) inputFile = argv[i];
         } else if (arg == "-o" || arg == "--output") {
             if (++i < argc) outputFile = argv[i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            ExcelProcessorCore::setThreadCount(std::stoi(argv[++i]));
+        } else if (arg == "--files" && i + 1 < argc) {
+            app.processor_->setConcurrentFiles(std::stoi(argv[++i]));
         } else if (arg == "-c" || arg == "--config") {
             if (++i < argc) {
                 configFile = argv[i];
@@ -355,6 +1159,42 @@ int main(int argc, char* argv[]) {
             int testRows = std::stoi(argv[++i]);
             app.runPerformanceTest(testRows);
             return 0;
+        } else if (arg == "--bench-write" && i + 1 < argc) {
+            app.runWriteBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-regex" && i + 1 < argc) {
+            app.runRegexBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-keywords" && i + 1 < argc) {
+            app.runKeywordBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-inlist" && i + 1 < argc) {
+            app.runInListBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-columns" && i + 1 < argc) {
+            app.runColumnarBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-text" && i + 1 < argc) {
+            app.runTextColumnBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-memory" && i + 1 < argc) {
+            app.runMemoryBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-input" && i + 1 < argc) {
+            app.runInputCacheBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-shared" && i + 1 < argc) {
+            app.runSharedRuleBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-pipeline" && i + 1 < argc) {
+            app.runPipelineBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-files" && i + 1 < argc) {
+            app.runFilesBenchmark(std::stoi(argv[++i]));
+            return 0;
+        } else if (arg == "--bench-read" && i + 1 < argc) {
+            app.runReadBenchmark(std::stoi(argv[++i]));
+            return 0;
         } else if (arg == "-v" || arg == "--validate") {
             validateOnly = true;
         } else if (arg == "-s" || arg == "--stats") {
@@ -0,0 +1,76 @@
+#include "ExcelProcessorCore.h"
+#include <cstdio>
+
+namespace {
+
+// Days from 1970-01-01 to a proleptic Gregorian date, month 1-12 (H. Hinnant's days_from_civil)
+int64_t daysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+} // namespace
+
+// Out-of-range fields carry over as mktime would (month 13 is January of the next year)
+CellDate::CellDate(const std::tm& tm) {
+    int64_t month = tm.tm_mon;
+    int64_t year = static_cast<int64_t>(tm.tm_year) + 1900 + floorDiv(month, 12);
+    month -= floorDiv(month, 12) * 12;
+    int64_t days = daysFromCivil(year, month + 1, 1) + tm.tm_mday - 1;
+    seconds = days * 86400 + static_cast<int64_t>(tm.tm_hour) * 3600 + static_cast<int64_t>(tm.tm_min) * 60 + tm.tm_sec;
+}
+
+CellDate CellDate::fromDate(int year, int month, int day) {
+    CellDate date;
+    date.seconds = daysFromCivil(year, month, day) * 86400;
+    return date;
+}
+
+int64_t CellDate::days() const {
+    return floorDiv(seconds, 86400);
+}
+
+// Inverse of daysFromCivil (civil_from_days), with the weekday and day of year strftime may use
+std::tm CellDate::toTm() const {
+    const int64_t dayNumber = days();
+    const int64_t secondOfDay = seconds - dayNumber * 86400;
+
+    const int64_t z = dayNumber + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t dayOfEra = z - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t mp = (5 * dayOfYear + 2) / 153;
+    const int64_t day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = yearOfEra + era * 400 + (month <= 2);
+
+    std::tm tm = {};
+    tm.tm_year = static_cast<int>(year - 1900);
+    tm.tm_mon = static_cast<int>(month - 1);
+    tm.tm_mday = static_cast<int>(day);
+    tm.tm_hour = static_cast<int>(secondOfDay / 3600);
+    tm.tm_min = static_cast<int>(secondOfDay / 60 % 60);
+    tm.tm_sec = static_cast<int>(secondOfDay % 60);
+    tm.tm_wday = static_cast<int>(floorDiv(dayNumber + 4, 7) * -7 + dayNumber + 4); // 1970-01-01 was a Thursday
+    tm.tm_yday = static_cast<int>(dayNumber - daysFromCivil(year, 1, 1));
+    return tm;
+}
+
+std::string CellDate::toString() const {
+    std::tm tm = toTm();
+    char buffer[64];
+    int length = hasTime()
+        ? std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1,
+                        tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec)
+        : std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    return std::string(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+}
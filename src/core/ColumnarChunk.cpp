@@ -0,0 +1,76 @@
+#include "ExcelProcessorCore.h"
+#include <algorithm>
+
+void ColumnarChunk::assign(const std::vector<DataRow>& rows) {
+    std::vector<int> all;
+    for (const auto& row : rows) {
+        while (all.size() < row.data.size()) all.push_back(static_cast<int>(all.size()) + 1);
+    }
+    assign(rows, all);
+}
+
+void ColumnarChunk::assign(const std::vector<DataRow>& rows, const std::vector<int>& wantedColumns) {
+    assign(rows, 0, rows.size(), wantedColumns);
+}
+
+// Rows are read once, in order, each wanted cell appended to its column and its text interned
+void ColumnarChunk::assign(const std::vector<DataRow>& rows, size_t begin, size_t end, const std::vector<int>& wantedColumns) {
+    rowCount_ = end - begin;
+    columnCount_ = 0;
+    for (size_t r = begin; r < end; ++r) columnCount_ = std::max(columnCount_, rows[r].data.size());
+    if (columns_.size() < columnCount_) columns_.resize(columnCount_);
+
+    const size_t words = (rowCount_ + 63) / 64;
+    std::vector<size_t> filled;
+    for (size_t c = 0; c < columnCount_; ++c) {
+        Column& column = columns_[c];
+        column.types.assign(rowCount_, CellType::Missing);
+        column.numbers.assign(rowCount_, 0.0);
+        column.codes.assign(rowCount_, 0);
+        column.dictionary.clear();
+        column.entries.clear();
+        column.present.assign(words, 0);
+        if (std::find(wantedColumns.begin(), wantedColumns.end(), static_cast<int>(c) + 1) != wantedColumns.end()) {
+            filled.push_back(c);
+        }
+    }
+
+    auto intern = [](Column& column, const std::string& text) {
+        auto it = column.entries.find(text);
+        if (it != column.entries.end()) return it->second;
+        it = column.entries.emplace(text, static_cast<uint32_t>(column.dictionary.size())).first;
+        column.dictionary.push_back(it->first);
+        return it->second;
+    };
+
+    std::string dateText;
+    for (size_t r = 0; r < rowCount_; ++r) {
+        const auto& cells = rows[begin + r].data;
+        const uint64_t bit = uint64_t(1) << (r % 64);
+        for (size_t c : filled) {
+            if (c >= cells.size()) continue;
+            Column& column = columns_[c];
+            column.present[r / 64] |= bit;
+            const auto& cell = cells[c];
+            if (auto strVal = std::get_if<std::string>(&cell)) {
+                column.types[r] = CellType::String;
+                column.codes[r] = intern(column, *strVal);
+            } else if (auto intVal = std::get_if<int>(&cell)) {
+                column.types[r] = CellType::Int;
+                column.numbers[r] = static_cast<double>(*intVal);
+            } else if (auto doubleVal = std::get_if<double>(&cell)) {
+                column.types[r] = CellType::Double;
+                column.numbers[r] = *doubleVal;
+            } else if (auto boolVal = std::get_if<bool>(&cell)) {
+                column.types[r] = CellType::Bool;
+                column.numbers[r] = *boolVal ? 1.0 : 0.0;
+            } else if (auto dateVal = std::get_if<CellDate>(&cell)) {
+                column.types[r] = CellType::Date;
+                std::tm tm = dateVal->toTm();
+                char buffer[64];
+                dateText.assign(buffer, std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm));
+                column.codes[r] = intern(column, dateText);
+            }
+        }
+    }
+}
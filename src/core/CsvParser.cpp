@@ -0,0 +1,684 @@
+#include "CsvParser.h"
+#include "TaskScheduler.h"
+#include <QFile>
+#include <charconv>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <iomanip>
+#include <istream>
+#include <streambuf>
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    file_ = std::make_unique<QFile>(QString::fromStdString(filename));
+    if (!file_->open(QIODevice::ReadOnly)) {
+        file_.reset();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(file_->size());
+    if (size_ == 0) return true; // Nothing to map
+
+    uchar* ptr = file_->map(0, file_->size());
+    if (!ptr) {
+        close();
+        return false;
+    }
+    data_ = reinterpret_cast<const char*>(ptr);
+    return true;
+}
+
+void MappedFile::close() {
+    if (file_) {
+        if (data_) file_->unmap(reinterpret_cast<uchar*>(const_cast<char*>(data_)));
+        file_->close();
+        file_.reset();
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Structural character scanning
+// ---------------------------------------------------------------------------
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define CSV_SIMD_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define CSV_TARGET_AVX2
+#else
+#define CSV_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define CSV_SIMD_X86 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Scalar fallback: one lookup per byte
+void buildBitmapScalar(const char* data, size_t size, uint64_t* bits) {
+    static const struct Table {
+        bool isStructural[256] = {};
+        Table() {
+            isStructural[static_cast<unsigned char>(',')] = true;
+            isStructural[static_cast<unsigned char>('"')] = true;
+            isStructural[static_cast<unsigned char>('\n')] = true;
+        }
+    } table;
+
+    size_t words = (size + 63) / 64;
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t mask = 0;
+        size_t base = w * 64;
+        size_t n = std::min<size_t>(64, size - base);
+        for (size_t i = 0; i < n; ++i) {
+            if (table.isStructural[static_cast<unsigned char>(data[base + i])]) mask |= uint64_t(1) << i;
+        }
+        bits[w] = mask;
+    }
+}
+
+#if CSV_SIMD_X86
+inline uint64_t structuralMaskSse2(const char* p) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+                                   _mm_cmpeq_epi8(v, newline));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (i * 16);
+    }
+    return mask;
+}
+
+void buildBitmapSse2(const char* data, size_t size, uint64_t* bits) {
+    size_t full = size / 64;
+    for (size_t w = 0; w < full; ++w) {
+        bits[w] = structuralMaskSse2(data + w * 64);
+    }
+    size_t rest = size - full * 64;
+    if (rest > 0) {
+        // Never read past the end of the mapping: scan the tail from a zero-padded copy
+        alignas(16) char tail[64] = {};
+        std::memcpy(tail, data + full * 64, rest);
+        bits[full] = structuralMaskSse2(tail) & ((uint64_t(1) << rest) - 1);
+    }
+}
+
+CSV_TARGET_AVX2 inline uint64_t structuralMaskAvx2(const char* p) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    __m256i hitLo = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, quote)),
+                                    _mm256_cmpeq_epi8(lo, newline));
+    __m256i hitHi = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, quote)),
+                                    _mm256_cmpeq_epi8(hi, newline));
+    return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hitLo))) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hitHi))) << 32);
+}
+
+CSV_TARGET_AVX2 void buildBitmapAvx2(const char* data, size_t size, uint64_t* bits) {
+    size_t full = size / 64;
+    for (size_t w = 0; w < full; ++w) {
+        bits[w] = structuralMaskAvx2(data + w * 64);
+    }
+    size_t rest = size - full * 64;
+    if (rest > 0) {
+        alignas(32) char tail[64] = {};
+        std::memcpy(tail, data + full * 64, rest);
+        bits[full] = structuralMaskAvx2(tail) & ((uint64_t(1) << rest) - 1);
+    }
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+inline int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+} // namespace
+
+CsvSimdLevel detectCsvSimdLevel() {
+#if CSV_SIMD_X86
+    static const CsvSimdLevel level = cpuSupportsAvx2() ? CsvSimdLevel::AVX2 : CsvSimdLevel::SSE2;
+    return level;
+#else
+    return CsvSimdLevel::Scalar;
+#endif
+}
+
+const char* csvSimdLevelName(CsvSimdLevel level) {
+    switch (level) {
+        case CsvSimdLevel::AVX2: return "AVX2";
+        case CsvSimdLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+CsvTokenizer::CsvTokenizer() : CsvTokenizer(nullptr, nullptr) {}
+
+CsvTokenizer::CsvTokenizer(const char* begin, const char* end)
+    : CsvTokenizer(begin, end, detectCsvSimdLevel()) {}
+
+CsvTokenizer::CsvTokenizer(const char* begin, const char* end, CsvSimdLevel level) {
+    reset(begin, end);
+    buildBitmap_ = buildBitmapScalar;
+#if CSV_SIMD_X86
+    // Never use a level above what the CPU supports
+    if (level == CsvSimdLevel::AVX2 && detectCsvSimdLevel() == CsvSimdLevel::AVX2) {
+        buildBitmap_ = buildBitmapAvx2;
+    } else if (level != CsvSimdLevel::Scalar) {
+        buildBitmap_ = buildBitmapSse2;
+    }
+#endif
+}
+
+void CsvTokenizer::reset(const char* begin, const char* end) {
+    cur_ = begin;
+    end_ = end;
+    windowBegin_ = windowEnd_ = begin;
+    windowWords_ = 0;
+    word_ = 0;
+    mask_ = 0;
+    inQuotes_ = false;
+}
+
+void CsvTokenizer::fillWindow(const char* p) {
+    size_t size = std::min<size_t>(kWindowWords * 64, end_ - p);
+    windowBegin_ = p;
+    windowEnd_ = p + size;
+    windowWords_ = (size + 63) / 64;
+    buildBitmap_(p, size, bits_);
+    word_ = 0;
+    mask_ = bits_[0];
+}
+
+inline const char* CsvTokenizer::nextStructural() {
+    while (true) {
+        if (mask_) {
+            const char* s = windowBegin_ + word_ * 64 + countTrailingZeros(mask_);
+            mask_ &= mask_ - 1;
+            return s;
+        }
+        if (++word_ < windowWords_) {
+            mask_ = bits_[word_];
+        } else if (windowEnd_ < end_) {
+            fillWindow(windowEnd_);
+        } else {
+            return end_;
+        }
+    }
+}
+
+bool CsvTokenizer::skipRecord() {
+    // Quoted fields may contain newlines, so skipping runs the same state machine
+    return nextRecord(skipped_);
+}
+
+// RFC 4180 record splitter driven by the structural bitmap:
+//  - a field that starts with '"' is quoted; ',', '\n' and '\r' inside it are data
+//  - "" inside a quoted field is one '"'
+//  - a '"' anywhere else is ordinary data
+// Unquoted fields and quoted fields without "" are views into the input; only fields
+// that need unescaping are copied, into unescaped_.
+bool CsvTokenizer::nextRecord(std::vector<std::string_view>& fields) {
+    fields.clear();
+    escaped_.clear();
+    inQuotes_ = false;
+    if (atEnd()) return false;
+
+    const char* fieldBegin = cur_;
+    const char* closeQuote = nullptr; // Closing quote of the current field, if it was quoted
+    bool quoted = false;              // Inside a quoted field
+    bool hasEscapes = false;          // Current quoted field contains "" or data after the closing quote
+    const char* lineEnd = end_;
+
+    auto addField = [&](const char* fieldEnd) {
+        if (fieldBegin == fieldEnd || *fieldBegin != '"') {
+            fields.emplace_back(fieldBegin, fieldEnd - fieldBegin);
+        } else if (!hasEscapes && closeQuote == fieldEnd - 1) {
+            fields.emplace_back(fieldBegin + 1, closeQuote - fieldBegin - 1);
+        } else {
+            // Unescaped after the record is complete, so unescaped_ is resized only once
+            escaped_.push_back({ fields.size(), std::string_view(fieldBegin + 1, fieldEnd - fieldBegin - 1) });
+            fields.emplace_back();
+        }
+    };
+
+    while (true) {
+        const char* s = nextStructural();
+        if (s == end_) {
+            cur_ = end_; // Last record without a trailing newline
+            break;
+        }
+
+        if (quoted) {
+            if (*s != '"') continue;
+            if (s + 1 < end_ && s[1] == '"') {
+                hasEscapes = true;
+                nextStructural(); // Second quote of the pair
+                continue;
+            }
+            quoted = false;
+            closeQuote = s;
+            continue;
+        }
+
+        if (*s == '"') {
+            if (s == fieldBegin) quoted = true;
+            else if (closeQuote) hasEscapes = true; // Stray quote after the closing one is dropped
+            continue;
+        }
+
+        if (*s == ',') {
+            addField(s);
+        } else {
+            lineEnd = s;
+            cur_ = s + 1;
+            break;
+        }
+        fieldBegin = s + 1;
+        closeQuote = nullptr;
+        hasEscapes = false;
+    }
+
+    if (quoted) {
+        // Unterminated quoted field runs to the end of the input
+        inQuotes_ = true;
+        hasEscapes = true;
+        addField(end_);
+    } else {
+        // Same splitting as std::getline(lineStream, cell, ','): a trailing ',' adds no empty field
+        if (lineEnd > fieldBegin && *(lineEnd - 1) == '\r') --lineEnd;
+        if (fieldBegin < lineEnd) addField(lineEnd);
+    }
+
+    if (!escaped_.empty()) unescapeFields(fields);
+    return true;
+}
+
+void CsvTokenizer::unescapeFields(std::vector<std::string_view>& fields) {
+    size_t total = 0;
+    for (const auto& field : escaped_) total += field.raw.size();
+    unescaped_.resize(total);
+
+    char* out = unescaped_.data();
+    for (const auto& field : escaped_) {
+        char* fieldStart = out;
+        const char* p = field.raw.data();
+        const char* end = p + field.raw.size();
+        while (p < end) {
+            if (*p == '"') {
+                // "" is a literal quote, a lone quote closes (or is dropped)
+                if (p + 1 < end && p[1] == '"') {
+                    *out++ = '"';
+                    p += 2;
+                } else {
+                    ++p;
+                }
+            } else {
+                *out++ = *p++;
+            }
+        }
+        fields[field.index] = std::string_view(fieldStart, out - fieldStart);
+    }
+}
+
+std::vector<const char*> splitCsvRecords(const char* begin, const char* end, size_t parts) {
+    std::vector<const char*> bounds{ begin };
+    size_t size = end - begin;
+    if (parts <= 1 || size == 0) {
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    // Pass 1: quote count of each nominal segment, in parallel
+    size_t segment = (size + parts - 1) / parts;
+    std::vector<size_t> counts(parts - 1);
+    TaskScheduler::shared().parallelFor(parts - 1, 1, [&](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            const char* segBegin = begin + std::min(size, k * segment);
+            const char* segEnd = begin + std::min(size, (k + 1) * segment);
+            counts[k] = static_cast<size_t>(std::count(segBegin, segEnd, '"'));
+        }
+    });
+
+    // Pass 2: from each nominal offset, move to the first newline outside quotes
+    size_t quotesBefore = 0;
+    for (size_t k = 1; k < parts; ++k) {
+        quotesBefore += counts[k - 1];
+        const char* p = begin + std::min(size, k * segment);
+        if (p <= bounds.back()) continue; // Previous boundary already ran past this segment
+
+        bool inQuotes = (quotesBefore % 2) != 0;
+        while (p < end && (inQuotes || *p != '\n')) {
+            if (*p == '"') inQuotes = !inQuotes;
+            ++p;
+        }
+        if (p >= end - 1) break;
+        bounds.push_back(p + 1);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+namespace {
+
+// istream source over a string_view, so std::get_time can run without copying the cell
+class ViewStreamBuf : public std::streambuf {
+public:
+    explicit ViewStreamBuf(std::string_view view) {
+        char* p = const_cast<char*>(view.data());
+        setg(p, p, p + view.size());
+    }
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    }
+    return true;
+}
+
+// Same acceptance as std::stoi: optional sign, leading digits, trailing garbage ignored, int range only
+bool parseIntPrefix(std::string_view cell, int& value) {
+    const char* begin = cell.data();
+    const char* end = begin + cell.size();
+    if (begin < end && *begin == '+') {
+        ++begin;
+        if (begin == end || !std::isdigit(static_cast<unsigned char>(*begin))) return false;
+    }
+    auto res = std::from_chars(begin, end, value);
+    return res.ec == std::errc();
+}
+
+// Same acceptance as std::stod (strtod semantics, ERANGE rejected)
+bool parseDoublePrefix(std::string_view cell, double& value) {
+    char buffer[128];
+    std::string heapBuffer;
+    const char* str = nullptr;
+    if (cell.size() < sizeof(buffer)) {
+        std::memcpy(buffer, cell.data(), cell.size());
+        buffer[cell.size()] = '\0';
+        str = buffer;
+    } else {
+        heapBuffer.assign(cell.data(), cell.size());
+        str = heapBuffer.c_str();
+    }
+
+    char* parseEnd = nullptr;
+    errno = 0;
+    value = std::strtod(str, &parseEnd);
+    if (parseEnd == str) return false;
+    if (errno == ERANGE) return false;
+    return true;
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// YYYY-MM-DD or YYYY/MM/DD exactly, filled the way std::get_time does for those formats
+bool parseFixedDate(std::string_view cell, std::tm& tm) {
+    if (cell.size() != 10 || cell[4] != cell[7] || (cell[4] != '-' && cell[4] != '/')) return false;
+    for (size_t i : { 0, 1, 2, 3, 5, 6, 8, 9 }) {
+        if (!isDigit(cell[i])) return false;
+    }
+    int year = (cell[0] - '0') * 1000 + (cell[1] - '0') * 100 + (cell[2] - '0') * 10 + (cell[3] - '0');
+    int month = (cell[5] - '0') * 10 + (cell[6] - '0');
+    int day = (cell[8] - '0') * 10 + (cell[9] - '0');
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    return true;
+}
+
+bool parseDate(std::string_view cell, std::tm& tm) {
+    if (parseFixedDate(cell, tm)) return true;
+
+    // %Y needs a leading digit; skip the stream setup for plain text
+    size_t first = cell.find_first_not_of(" \t\r\n\v\f");
+    if (first == std::string_view::npos || !std::isdigit(static_cast<unsigned char>(cell[first]))) return false;
+
+    for (const char* format : { "%Y-%m-%d", "%Y/%m/%d" }) {
+        ViewStreamBuf buf(cell);
+        std::istream ss(&buf);
+        ss >> std::get_time(&tm, format);
+        if (!ss.fail()) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+CellValue parseCsvCell(std::string_view cell) {
+    // Handle empty
+    if (cell.empty()) {
+        return std::string("");
+    }
+
+    // Handle boolean
+    if (equalsIgnoreCase(cell, "true")) return true;
+    if (equalsIgnoreCase(cell, "false")) return false;
+
+    // Handle integer
+    if (cell.find('.') == std::string_view::npos &&
+        cell.find_first_not_of("0123456789-+") == std::string_view::npos) {
+        int intValue = 0;
+        if (parseIntPrefix(cell, intValue)) return intValue;
+    }
+
+    // Handle double
+    if (cell.find_first_of("0123456789.") != std::string_view::npos) {
+        double doubleValue = 0.0;
+        if (parseDoublePrefix(cell, doubleValue)) return doubleValue;
+    }
+
+    // Handle date
+    std::tm tm = {};
+    if (parseDate(cell, tm)) return tm;
+
+    // Default to string
+    return std::string(cell);
+}
+
+// ---------------------------------------------------------------------------
+// Column parsers used once a CsvSchema is locked.
+// Each accepts only cells for which parseCsvCell would produce the same type and value, and returns false
+// for everything else.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Optional '-' then digits only
+bool parseIntColumn(std::string_view cell, int& value) {
+    size_t i = (!cell.empty() && cell[0] == '-') ? 1 : 0;
+    if (i == cell.size()) return false;
+    for (size_t j = i; j < cell.size(); ++j) {
+        if (!isDigit(cell[j])) return false;
+    }
+    auto res = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    return res.ec == std::errc();
+}
+
+// Optional '-', digits with one '.', no exponent. Up to 15 significant digits the value is the exactly
+// representable mantissa divided by an exact power of ten, i.e. correctly rounded like strtod.
+bool parseDoubleColumn(std::string_view cell, double& value) {
+    static const double kPow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    size_t i = 0;
+    bool negative = false;
+    if (i < cell.size() && cell[i] == '-') {
+        negative = true;
+        ++i;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool seenDot = false;
+    for (; i < cell.size(); ++i) {
+        char c = cell[i];
+        if (isDigit(c)) {
+            if (mantissa != 0 || c != '0') ++digits; // Leading zeros are not significant
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            if (seenDot) ++fractionDigits;
+            if (digits > 15 || fractionDigits > 22) return false;
+        } else if (c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            return false;
+        }
+    }
+    if (!seenDot || cell.size() - (negative ? 1 : 0) < 2) return false; // Needs a '.' and at least one digit
+
+    value = static_cast<double>(mantissa) / kPow10[fractionDigits];
+    if (negative) value = -value;
+    return true;
+}
+
+// Starts with a character that cannot begin a boolean, number, inf/nan or date, so parseCsvCell
+// would return the cell as text
+bool isPlainText(std::string_view cell) {
+    static const struct Table {
+        bool plain[256];
+        Table() {
+            for (int c = 0; c < 256; ++c) plain[c] = true;
+            for (const char* p = "0123456789+-. \\t\\r\\n\\v\\ftTfFiInN"; *p; ++p) plain[static_cast<unsigned char>(*p)] = false;
+        }
+    } table;
+    return !cell.empty() && table.plain[static_cast<unsigned char>(cell[0])];
+}
+
+} // namespace
+
+void CsvSchema::parseRecord(const std::vector<std::string_view>& fields,
+                            std::vector<CellValue>& cells,
+                            bool sample) {
+    if (!locked_) {
+        for (size_t c = 0; c < fields.size(); ++c) {
+            cells.push_back(parseCsvCell(fields[c]));
+            if (sample) observe(c, cells.back());
+        }
+        if (sample && ++sampledRows_ >= sampleRows_) lock();
+        return;
+    }
+
+    for (size_t c = 0; c < fields.size(); ++c) {
+        std::string_view cell = fields[c];
+        if (cell.empty()) {
+            cells.emplace_back(std::string());
+            continue;
+        }
+
+        switch (columnType(c)) {
+            case CsvColumnType::Int: {
+                int value;
+                if (parseIntColumn(cell, value)) { cells.emplace_back(value); continue; }
+                break;
+            }
+            case CsvColumnType::Double: {
+                double value;
+                if (parseDoubleColumn(cell, value)) { cells.emplace_back(value); continue; }
+                break;
+            }
+            case CsvColumnType::Number: {
+                int intValue;
+                if (parseIntColumn(cell, intValue)) { cells.emplace_back(intValue); continue; }
+                double doubleValue;
+                if (parseDoubleColumn(cell, doubleValue)) { cells.emplace_back(doubleValue); continue; }
+                break;
+            }
+            case CsvColumnType::Bool:
+                if (equalsIgnoreCase(cell, "true")) { cells.emplace_back(true); continue; }
+                if (equalsIgnoreCase(cell, "false")) { cells.emplace_back(false); continue; }
+                break;
+            case CsvColumnType::Date: {
+                std::tm tm = {};
+                if (parseFixedDate(cell, tm)) { cells.emplace_back(tm); continue; }
+                break;
+            }
+            case CsvColumnType::String:
+                if (isPlainText(cell)) { cells.emplace_back(std::string(cell)); continue; }
+                break;
+            default:
+                break;
+        }
+
+        // Does not fit the column type
+        cells.push_back(parseCsvCell(cell));
+    }
+}
+
+CsvColumnType CsvSchema::columnType(size_t column) const {
+    return column < types_.size() ? types_[column] : CsvColumnType::Mixed;
+}
+
+void CsvSchema::observe(size_t column, const CellValue& value) {
+    if (column >= seen_.size()) seen_.resize(column + 1, 0);
+    // Empty cells say nothing about the column type
+    if (auto str = std::get_if<std::string>(&value); str && str->empty()) return;
+    seen_[column] |= 1u << value.index();
+}
+
+void CsvSchema::lock() {
+    // Bits follow the variant order: string, int, double, bool, date
+    const unsigned kString = 1u << 0, kInt = 1u << 1, kDouble = 1u << 2, kBool = 1u << 3, kDate = 1u << 4;
+
+    types_.assign(seen_.size(), CsvColumnType::Mixed);
+    for (size_t c = 0; c < seen_.size(); ++c) {
+        unsigned seen = seen_[c];
+        if (seen == kInt) types_[c] = CsvColumnType::Int;
+        else if (seen == kDouble) types_[c] = CsvColumnType::Double;
+        else if (seen == (kInt | kDouble)) types_[c] = CsvColumnType::Number;
+        else if (seen == kBool) types_[c] = CsvColumnType::Bool;
+        else if (seen == kDate) types_[c] = CsvColumnType::Date;
+        else if (seen == kString) types_[c] = CsvColumnType::String;
+    }
+    locked_ = true;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "ExcelProcessorCore.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+class QFile;
+
+// Read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file cannot be opened or mapped (an empty file maps to size 0)
+    bool open(const std::string& filename);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    std::unique_ptr<QFile> file_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Instruction set used to find structural characters (',', '"', '\n')
+enum class CsvSimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Best level supported by this CPU (AVX2 is picked at runtime, SSE2 is the x86 baseline)
+CsvSimdLevel detectCsvSimdLevel();
+const char* csvSimdLevelName(CsvSimdLevel level);
+
+// In-place RFC 4180 CSV tokenizer over a memory buffer.
+// Fields are returned as views into the buffer with surrounding quotes removed; only quoted
+// fields containing "" are copied (into storage owned by the tokenizer, valid until the next record).
+// Structural characters are located 16/32 bytes at a time into a bitmap over a sliding window.
+class CsvTokenizer {
+public:
+    CsvTokenizer();
+    CsvTokenizer(const char* begin, const char* end);
+    CsvTokenizer(const char* begin, const char* end, CsvSimdLevel level);
+
+    // Restarts on a new buffer, keeping the SIMD level and scratch storage
+    void reset(const char* begin, const char* end);
+
+    bool atEnd() const { return cur_ >= end_; }
+    const char* position() const { return cur_; }
+
+    // Skips one record; returns false at end of input
+    bool skipRecord();
+
+    // Splits the next record into fields; returns false at end of input
+    bool nextRecord(std::vector<std::string_view>& fields);
+
+    // True if the last record hit the end of input inside an open quoted field
+    bool endedInQuotes() const { return inQuotes_; }
+
+private:
+    using BuildBitmapFn = void (*)(const char* data, size_t size, uint64_t* bits);
+
+    // Next structural character after the previous one, or end_
+    const char* nextStructural();
+    void fillWindow(const char* p);
+    void unescapeFields(std::vector<std::string_view>& fields);
+
+    const char* cur_ = nullptr;
+    const char* end_ = nullptr;
+
+    static constexpr size_t kWindowWords = 256; // 16 KB of input per bitmap fill
+
+    BuildBitmapFn buildBitmap_ = nullptr;
+    uint64_t bits_[kWindowWords];   // Bit i set if windowBegin_[i] is structural
+    const char* windowBegin_ = nullptr;
+    const char* windowEnd_ = nullptr;
+    size_t windowWords_ = 0;
+    size_t word_ = 0;               // Bitmap word being consumed
+    uint64_t mask_ = 0;             // Unconsumed bits of bits_[word_]
+
+    struct EscapedField {
+        size_t index;               // Position in the record
+        std::string_view raw;       // Text after the opening quote
+    };
+    std::vector<EscapedField> escaped_;
+    std::string unescaped_;
+    std::vector<std::string_view> skipped_;
+    bool inQuotes_ = false;
+};
+
+// Splits [begin, end) into at most `parts` ranges that each start on a record boundary.
+// Quote parity is counted first, so a newline inside a quoted field is never chosen as a split point.
+// Returns the range starts followed by end (so range i is [result[i], result[i + 1])).
+std::vector<const char*> splitCsvRecords(const char* begin, const char* end, size_t parts);
+
+// Converts one raw CSV cell to a typed value.
+// Only string cells allocate; numbers, booleans and dates are parsed straight from the view.
+CellValue parseCsvCell(std::string_view cell);
+
+// Column type inferred from the sample rows
+enum class CsvColumnType {
+    Mixed,   // No single type; every cell goes through parseCsvCell
+    Int,
+    Double,
+    Number,  // Int and double cells
+    Bool,
+    Date,
+    String
+};
+
+// Per-column schema inferred from the leading rows of a file.
+// While sampling, cells are parsed with parseCsvCell and their types recorded. After sampleRows rows the
+// schema is locked and each column uses a parser specialised for its type, without trying the others.
+// A cell the column parser does not accept goes through parseCsvCell, so values are always identical to
+// per-cell parsing.
+class CsvSchema {
+public:
+    explicit CsvSchema(int sampleRows = 100) : sampleRows_(sampleRows) {}
+
+    // Parses one record into cells (appended to cells). sample = false keeps the row out of inference (header).
+    void parseRecord(const std::vector<std::string_view>& fields,
+                     std::vector<CellValue>& cells,
+                     bool sample = true);
+
+    bool isLocked() const { return locked_; }
+    CsvColumnType columnType(size_t column) const;
+
+private:
+    void observe(size_t column, const CellValue& value);
+    void lock();
+
+    int sampleRows_;
+    int sampledRows_ = 0;
+    bool locked_ = false;
+    std::vector<unsigned> seen_;          // Per column: bit set of variant indices seen while sampling
+    std::vector<CsvColumnType> types_;
+};
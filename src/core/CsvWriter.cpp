@@ -0,0 +1,104 @@
+#include "CsvWriter.h"
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+
+namespace {
+
+void appendInt(std::string& out, int value) {
+    char buffer[16];
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, res.ptr);
+}
+
+// Same text as `ostream << double` with default flags (printf "%g")
+void appendDouble(std::string& out, double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+    out.append(buffer, res.ptr);
+#else
+    int n = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    if (n > 0) out.append(buffer, static_cast<size_t>(n));
+#endif
+}
+
+void appendTwoDigits(std::string& out, int value) {
+    out += static_cast<char>('0' + value / 10);
+    out += static_cast<char>('0' + value % 10);
+}
+
+// put_time "%Y-%m-%d" without a stream; unusual years/fields go through strftime
+void appendDate(std::string& out, const CellDate& date) {
+    std::tm tm = date.toTm();
+    int year = tm.tm_year + 1900;
+    if (year >= 1000 && year <= 9999 && tm.tm_mon >= 0 && tm.tm_mon <= 11 && tm.tm_mday >= 1 && tm.tm_mday <= 31) {
+        appendInt(out, year);
+        out += '-';
+        appendTwoDigits(out, tm.tm_mon + 1);
+        out += '-';
+        appendTwoDigits(out, tm.tm_mday);
+        return;
+    }
+    char buffer[64];
+    size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
+    out.append(buffer, n);
+}
+
+void appendQuoted(std::string& out, const std::string& value) {
+    out += '"';
+    size_t start = 0;
+    for (size_t quote = value.find('"'); quote != std::string::npos; quote = value.find('"', quote + 1)) {
+        out.append(value, start, quote + 1 - start);
+        out += '"';
+        start = quote + 1;
+    }
+    out.append(value, start, std::string::npos);
+    out += '"';
+}
+
+} // namespace
+
+CsvOutputBuffer::CsvOutputBuffer(std::ostream& out, size_t flushThreshold)
+    : out_(out), flushThreshold_(flushThreshold) {
+    buffer_.reserve(flushThreshold_ + 4096);
+}
+
+CsvOutputBuffer::~CsvOutputBuffer() {
+    flush();
+}
+
+void CsvOutputBuffer::appendRow(const std::vector<CellValue>& cells) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (i > 0) buffer_ += ',';
+        appendCell(cells[i]);
+    }
+    buffer_ += '\n';
+    if (buffer_.size() >= flushThreshold_) flush();
+}
+
+void CsvOutputBuffer::appendCell(const CellValue& value) {
+    std::visit([this](const auto& val) {
+        using ValType = std::decay_t<decltype(val)>;
+        if constexpr (std::is_same_v<ValType, std::string>) {
+            appendQuoted(buffer_, val);
+        } else if constexpr (std::is_same_v<ValType, bool>) {
+            buffer_ += val ? "true" : "false";
+        } else if constexpr (std::is_same_v<ValType, CellDate>) {
+            appendDate(buffer_, val);
+        } else if constexpr (std::is_same_v<ValType, int>) {
+            appendInt(buffer_, val);
+        } else {
+            appendDouble(buffer_, val);
+        }
+    }, value);
+}
+
+bool CsvOutputBuffer::flush() {
+    if (!buffer_.empty()) {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        bytesWritten_ += buffer_.size();
+        buffer_.clear();
+    }
+    return static_cast<bool>(out_);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ExcelProcessorCore.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Formats CSV rows straight into a reusable byte buffer and writes it out in large blocks.
+// Output matches the previous ostringstream/std::endl formatting: strings are quoted, doubles use
+// the default stream format (%g, 6 significant digits), dates are YYYY-MM-DD and rows end with '\n'.
+// Quotes inside strings are doubled so the output reads back unchanged.
+class CsvOutputBuffer {
+public:
+    explicit CsvOutputBuffer(std::ostream& out, size_t flushThreshold = 1 << 20);
+    ~CsvOutputBuffer();
+    CsvOutputBuffer(const CsvOutputBuffer&) = delete;
+    CsvOutputBuffer& operator=(const CsvOutputBuffer&) = delete;
+
+    void appendRow(const std::vector<CellValue>& cells);
+    void appendCell(const CellValue& value);
+
+    // Writes buffered bytes to the stream; returns false if the stream failed
+    bool flush();
+
+    size_t bytesWritten() const { return bytesWritten_ + buffer_.size(); }
+
+private:
+    std::ostream& out_;
+    std::string buffer_;
+    size_t flushThreshold_;
+    size_t bytesWritten_ = 0;
+};
@@ -1,13 +1,22 @@
 #include "ExcelProcessorCore.h"
+#include "CsvParser.h"
+#include "CsvWriter.h"
+#include "BoundedQueue.h"
+#include "XlsxParser.h"
+#include "XlsxWriter.h"
+#include "TaskScheduler.h"
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <iomanip>
 // #include <filesystem>  // Disabled for MinGW compatibility
-#include <future>
 #include <thread>
 #include <set>
+#include <unordered_map>
 #include <ctime>
 #include <QAxObject>
 #include <QVariant>
@@ -18,70 +27,143 @@
 #include <QDateTime> // Added for QDateTime
 #include <QRegExp> // Added for wildcard matching
 #include <cctype> // For std::tolower
+#ifdef _WIN32
+#include <objbase.h> // CoInitialize for the file threads
+#endif
 
 // namespace fs = std::filesystem;  // Disabled for MinGW compatibility
 
-// ActiveQt Excel Reader for .xlsx support
+// ActiveQt Excel Reader for .xls support (.xlsx is read natively by XlsxExcelReader)
+// Excel and the input workbook are opened on first use and stay open until closeInput(), so listing the
+// sheets and reading every chunk of a run share one Excel instance instead of launching Excel per call.
+// Sheet names and used ranges are cached with the workbook; a new size or modification time reopens it.
 class ActiveQtExcelReader : public ExcelReader {
 private:
     std::function<void(const std::string&)> logger_;
 
-public:
-    void setLogger(std::function<void(const std::string&)> logger) override {
-        logger_ = logger;
-    }
-
-    bool readExcelFile(const std::string& filename, std::vector<DataRow>& data, const std::string& sheetName = "", int maxRows = 0, int offset = 0, bool includeHeader = false) override {
-        qDebug() << "DEBUG: Reading Excel File:" << QString::fromStdString(filename) 
-                 << "Offset:" << offset 
-                 << "IncludeHeader:" << includeHeader;
+    struct UsedRange {
+        int lastRow = 0;
+        int lastColumn = 0;
+    };
 
-        QAxObject excel("Excel.Application");
-        if (excel.isNull()) {
-            qDebug() << "ERROR: Failed to create Excel.Application";
-            if (logger_) logger_("ERROR: Failed to create Excel.Application (ActiveQt)");
-            return false;
+    mutable QAxObject* excelApp_ = nullptr;
+    mutable QAxObject* workbook_ = nullptr;
+    mutable std::string openPath_; // Absolute path of workbook_
+    mutable qint64 openSize_ = -1;
+    mutable qint64 openModified_ = 0;
+    mutable std::vector<std::string> sheetNames_;
+    mutable std::map<std::string, UsedRange> usedRanges_; // Key: sheet name as requested ("" = first sheet)
+    mutable int openCount_ = 0;
+
+    // Returns the open workbook for filename, starting Excel and opening the file only when needed
+    QAxObject* openWorkbook(const std::string& filename) const {
+        QFileInfo info(QString::fromStdString(filename));
+        QString absPath = info.absoluteFilePath();
+        absPath.replace("/", "\\");
+        std::string key = absPath.toStdString();
+        qint64 size = info.size();
+        qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        if (workbook_ && key == openPath_ && size == openSize_ && modified == openModified_) {
+            return workbook_;
         }
-        excel.setProperty("Visible", false);
-        excel.setProperty("DisplayAlerts", false);
 
-        QAxObject* workbooks = excel.querySubObject("Workbooks");
-        if (!workbooks) {
-            excel.dynamicCall("Quit()");
-            return false;
+        closeWorkbook();
+        if (!excelApp_) {
+            excelApp_ = new QAxObject("Excel.Application");
+            if (excelApp_->isNull()) {
+                qDebug() << "ERROR: Failed to create Excel.Application";
+                if (logger_) logger_("ERROR: Failed to create Excel.Application (ActiveQt)");
+                delete excelApp_;
+                excelApp_ = nullptr;
+                return nullptr;
+            }
+            excelApp_->setProperty("Visible", false);
+            excelApp_->setProperty("DisplayAlerts", false);
         }
 
-        // Convert to absolute path with backslashes
-        QString absPath = QFileInfo(QString::fromStdString(filename)).absoluteFilePath();
-        absPath.replace("/", "\\");
+        QAxObject* workbooks = excelApp_->querySubObject("Workbooks");
+        if (!workbooks) return nullptr;
 
-        QAxObject* workbook = workbooks->querySubObject("Open(const QString&)", absPath);
-        if (!workbook) {
+        // Read-only, so task output written to the same file by ActiveQtExcelWriter is not blocked
+        ++openCount_;
+        workbook_ = workbooks->querySubObject("Open(const QString&, const QVariant&, const QVariant&)", absPath, 0, true);
+        if (!workbook_) {
             qDebug() << "ERROR: Failed to open workbook:" << absPath;
-            if (logger_) logger_("ERROR: Failed to open workbook: " + absPath.toStdString());
-            excel.dynamicCall("Quit()");
-            return false;
+            if (logger_) logger_("ERROR: Failed to open workbook: " + key);
+            return nullptr;
         }
+        openPath_ = key;
+        openSize_ = size;
+        openModified_ = modified;
+        return workbook_;
+    }
 
-        QAxObject* sheets = workbook->querySubObject("Worksheets");
-        if (!sheets) {
-            workbook->dynamicCall("Close()");
-            excel.dynamicCall("Quit()");
-            return false;
+    void closeWorkbook() const {
+        if (workbook_) {
+            workbook_->dynamicCall("Close()");
+            delete workbook_;
+            workbook_ = nullptr;
         }
+        openPath_.clear();
+        sheetNames_.clear();
+        usedRanges_.clear();
+    }
 
-        QAxObject* sheet = nullptr;
-        if (sheetName.empty()) {
-            sheet = sheets->querySubObject("Item(int)", 1);
-        } else {
-            sheet = sheets->querySubObject("Item(const QString&)", QString::fromStdString(sheetName));
+    QAxObject* findSheet(QAxObject* workbook, const std::string& sheetName) const {
+        QAxObject* sheets = workbook->querySubObject("Worksheets");
+        if (!sheets) return nullptr;
+        if (sheetName.empty()) return sheets->querySubObject("Item(int)", 1);
+        return sheets->querySubObject("Item(const QString&)", QString::fromStdString(sheetName));
+    }
+
+    // Last used row and column of a sheet, looked up once per workbook
+    bool usedRange(QAxObject* sheet, const std::string& sheetName, UsedRange& range) const {
+        auto it = usedRanges_.find(sheetName);
+        if (it != usedRanges_.end()) {
+            range = it->second;
+            return true;
         }
 
+        QAxObject* used = sheet->querySubObject("UsedRange");
+        if (!used) return false;
+
+        // Fix for "Header Reading Error" where UsedRange starts at a later row (e.g., 1093)
+        // We must read based on absolute row numbers (starting from 1).
+        int usedRowStart = used->property("Row").toInt();
+        int usedRowsCount = used->querySubObject("Rows")->property("Count").toInt();
+        int usedColStart = used->property("Column").toInt();
+        int usedColsCount = used->querySubObject("Columns")->property("Count").toInt();
+        range.lastRow = usedRowStart + usedRowsCount - 1;
+        range.lastColumn = usedColStart + usedColsCount - 1;
+
+        qDebug() << "DEBUG: UsedRange: Row" << usedRowStart << "Count" << usedRowsCount << "(Last:" << range.lastRow << ")"
+                 << "Col" << usedColStart << "Count" << usedColsCount;
+
+        usedRanges_[sheetName] = range;
+        return true;
+    }
+
+public:
+    ~ActiveQtExcelReader() override {
+        closeInput();
+    }
+
+    void setLogger(std::function<void(const std::string&)> logger) override {
+        logger_ = logger;
+    }
+
+    bool readExcelFile(const std::string& filename, std::vector<DataRow>& data, const std::string& sheetName = "", int maxRows = 0, int offset = 0, bool includeHeader = false) override {
+        qDebug() << "DEBUG: Reading Excel File:" << QString::fromStdString(filename) 
+                 << "Offset:" << offset 
+                 << "IncludeHeader:" << includeHeader;
+
+        QAxObject* workbook = openWorkbook(filename);
+        if (!workbook) return false;
+
+        QAxObject* sheet = findSheet(workbook, sheetName);
         if (!sheet) {
             qDebug() << "ERROR: Sheet not found:" << QString::fromStdString(sheetName);
             if (logger_) logger_("ERROR: Sheet not found: " + sheetName);
-            workbook->dynamicCall("Close()");
-            excel.dynamicCall("Quit()");
             return false;
         }
 
@@ -95,26 +177,10 @@ public:
              }
         }
 
-        QAxObject* usedRange = sheet->querySubObject("UsedRange");
-        if (!usedRange) {
-            workbook->dynamicCall("Close()");
-            excel.dynamicCall("Quit()");
-            return false;
-        }
-
-        // Fix for "Header Reading Error" where UsedRange starts at a later row (e.g., 1093)
-        // We must read based on absolute row numbers (starting from 1).
-        
-        int usedRowStart = usedRange->property("Row").toInt();
-        int usedRowsCount = usedRange->querySubObject("Rows")->property("Count").toInt();
-        int lastRow = usedRowStart + usedRowsCount - 1;
-        
-        int usedColStart = usedRange->property("Column").toInt();
-        int usedColsCount = usedRange->querySubObject("Columns")->property("Count").toInt();
-        int lastCol = usedColStart + usedColsCount - 1;
-
-        qDebug() << "DEBUG: UsedRange: Row" << usedRowStart << "Count" << usedRowsCount << "(Last:" << lastRow << ")"
-                 << "Col" << usedColStart << "Count" << usedColsCount;
+        UsedRange used;
+        if (!usedRange(sheet, sheetName, used)) return false;
+        int lastRow = used.lastRow;
+        int lastCol = used.lastColumn;
 
         // Determine absolute start row (1-based)
         int absStartRow;
@@ -143,8 +209,6 @@ public:
         }
 
         if (absStartRow > lastRow) {
-            workbook->dynamicCall("Close()");
-            excel.dynamicCall("Quit()");
             return true; // Nothing to read
         }
 
@@ -164,11 +228,7 @@ public:
         
         QAxObject* range = startCell->querySubObject("Resize(int, int)", rowsToRead, colsToRead);
 
-        if (!range) {
-            workbook->dynamicCall("Close()");
-            excel.dynamicCall("Quit()");
-            return false;
-        }
+        if (!range) return false;
 
         QVariant var = range->dynamicCall("Value");
         
@@ -180,6 +240,9 @@ public:
 
         int rowIdx = absStartRow - 1; // Start row index (will be incremented to absStartRow in loop)
         
+        std::string sheetTitle = sheet->property("Name").toString().toStdString();
+        auto sharedSheetTitle = std::make_shared<const std::string>(sheetTitle);
+
         // Skip header logic
         // We have already handled skipping via absStartRow calculation.
         bool skipHeader = false; 
@@ -243,7 +306,7 @@ public:
 
             DataRow row;
             row.rowNumber = rowIdx;
-            row.sheetName = sheet->property("Name").toString().toStdString();
+            row.sheetName = sharedSheetTitle;
             
             for (const auto& cellVar : colVars) {
                 // Convert QVariant to our std::variant
@@ -254,13 +317,8 @@ public:
                 } else if (cellVar.userType() == QMetaType::Bool) {
                     row.data.push_back(cellVar.toBool());
                 } else if (cellVar.userType() == QMetaType::QDate || cellVar.userType() == QMetaType::QDateTime) {
-                     // Convert to std::tm
                      QDateTime dt = cellVar.toDateTime();
-                     std::tm tm = {};
-                     tm.tm_year = dt.date().year() - 1900;
-                     tm.tm_mon = dt.date().month() - 1;
-                     tm.tm_mday = dt.date().day();
-                     row.data.push_back(tm);
+                     row.data.push_back(CellDate::fromDate(dt.date().year(), dt.date().month(), dt.date().day()));
                 } else {
                     row.data.push_back(cellVar.toString().toStdString());
                 }
@@ -269,53 +327,54 @@ public:
             data.push_back(row);
         }
 
-        workbook->dynamicCall("Close()");
-        excel.dynamicCall("Quit()");
         return true;
     }
 
     bool getSheetNames(const std::string& filename, std::vector<std::string>& sheetNames) const override {
-        QAxObject excel("Excel.Application");
-        if (excel.isNull()) return false;
-        excel.setProperty("Visible", false);
-        excel.setProperty("DisplayAlerts", false);
-
-        QString absPath = QFileInfo(QString::fromStdString(filename)).absoluteFilePath();
-        absPath.replace("/", "\\");
+        QAxObject* workbook = openWorkbook(filename);
+        if (!workbook) return false;
 
-        QAxObject* workbooks = excel.querySubObject("Workbooks");
-        if (!workbooks) {
-            excel.dynamicCall("Quit()");
-            return false;
+        if (sheetNames_.empty()) {
+            QAxObject* sheets = workbook->querySubObject("Worksheets");
+            if (!sheets) return false;
+            int count = sheets->property("Count").toInt();
+            for (int i = 1; i <= count; ++i) {
+                QAxObject* sheet = sheets->querySubObject("Item(int)", i);
+                if (sheet) {
+                    sheetNames_.push_back(sheet->property("Name").toString().toStdString());
+                }
+            }
         }
+        sheetNames = sheetNames_;
+        return true;
+    }
 
-        QAxObject* workbook = workbooks->querySubObject("Open(const QString&)", absPath);
-        if (!workbook) {
-            excel.dynamicCall("Quit()");
-            return false;
-        }
+    // Last used row / column of a sheet of the open workbook (0 before any file was opened)
+    int getRowCount(const std::string& sheetName) const override {
+        UsedRange range;
+        QAxObject* sheet = workbook_ ? findSheet(workbook_, sheetName) : nullptr;
+        return sheet && usedRange(sheet, sheetName, range) ? range.lastRow : 0;
+    }
+    int getColumnCount(const std::string& sheetName) const override {
+        UsedRange range;
+        QAxObject* sheet = workbook_ ? findSheet(workbook_, sheetName) : nullptr;
+        return sheet && usedRange(sheet, sheetName, range) ? range.lastColumn : 0;
+    }
 
-        QAxObject* sheets = workbook->querySubObject("Worksheets");
-        int count = sheets->property("Count").toInt();
-        sheetNames.clear();
-        
-        for (int i = 1; i <= count; ++i) {
-            QAxObject* sheet = sheets->querySubObject("Item(int)", i);
-            if (sheet) {
-                sheetNames.push_back(sheet->property("Name").toString().toStdString());
-            }
+    void closeInput() override {
+        closeWorkbook();
+        if (excelApp_) {
+            excelApp_->dynamicCall("Quit()");
+            delete excelApp_;
+            excelApp_ = nullptr;
         }
-
-        workbook->dynamicCall("Close()");
-        excel.dynamicCall("Quit()");
-        return true;
     }
 
-    int getRowCount(const std::string& sheetName) const override { return 0; }
-    int getColumnCount(const std::string& sheetName) const override { return 0; }
+    int fileOpenCount() const override { return openCount_; }
 };
 
-// ActiveQt Excel Writer for .xlsx support
+// ActiveQt Excel Writer for .xls output and for appending to existing workbooks
+// (new .xlsx output is written natively by XlsxExcelWriter)
 class ActiveQtExcelWriter : public ExcelWriter {
 private:
     QAxObject* excelApp_ = nullptr;
@@ -569,9 +628,10 @@ private:
                             using T = std::decay_t<decltype(val)>;
                             if constexpr (std::is_same_v<T, std::string>) {
                                 colVars << QVariant::fromValue(QString::fromStdString(val));
-                            } else if constexpr (std::is_same_v<T, tm>) {
-                                QDate date(val.tm_year + 1900, val.tm_mon + 1, val.tm_mday);
-                                QTime time(val.tm_hour, val.tm_min, val.tm_sec);
+                            } else if constexpr (std::is_same_v<T, CellDate>) {
+                                std::tm tm = val.toTm();
+                                QDate date(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+                                QTime time(tm.tm_hour, tm.tm_min, tm.tm_sec);
                                 colVars << QVariant::fromValue(QDateTime(date, time));
                             } else {
                                 colVars << QVariant::fromValue(val);
@@ -594,14 +654,10 @@ private:
 // CSV Excel Reader
 class CSVExcelReader : public ExcelReader {
 public:
+    // memoryMapped: tokenize the file in place through a read-only mapping (falls back to ifstream if mapping fails)
+    explicit CSVExcelReader(bool memoryMapped = true) : memoryMapped_(memoryMapped) {}
+
     bool readExcelFile(const std::string& filename, std::vector<DataRow>& data, const std::string& sheetName = "", int maxRows = 0, int offset = 0, bool includeHeader = false) override {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            return false;
-        }
-        
-        std::string line;
-        
         // Skip offset lines + 1 (Header)
         // Note: This logic assumes offset 0 means "start after header"
         // and offset N means "start after N rows of data"
@@ -611,32 +667,54 @@ public:
             skipLines = 0;
         }
 
+        ++openCount_;
+        MappedFile mapped;
+        if (memoryMapped_ && mapped.open(filename)) {
+            CsvTokenizer tokenizer(mapped.data(), mapped.data() + mapped.size());
+            for (int i = 0; i < skipLines; ++i) {
+                if (!tokenizer.skipRecord()) return true;
+            }
+
+            // Whole-file reads of large files are parsed in parallel over record-aligned byte ranges
+            size_t remaining = mapped.data() + mapped.size() - tokenizer.position();
+            if (maxRows == 0 && remaining >= kParallelReadMinBytes) {
+                readParallel(tokenizer.position(), mapped.data() + mapped.size(), data, offset, skipLines == 0);
+                return true;
+            }
+
+            CsvSchema schema;
+            std::vector<std::string_view> fields;
+            int count = 0;
+            while ((maxRows == 0 || count < maxRows) && tokenizer.nextRecord(fields)) {
+                DataRow row;
+                buildRow(fields, row, schema, skipLines == 0 && count == 0);
+                row.rowNumber = offset + count + 1; // 1-based
+                data.push_back(std::move(row));
+                count++;
+            }
+            return true;
+        }
+
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            return false;
+        }
+        
+        std::string record, line;
+        CsvTokenizer tokenizer;
+        std::vector<std::string_view> fields;
         for(int i=0; i < skipLines; ++i) {
-             if (!std::getline(file, line)) return true;
+             if (!readRecord(file, record, line, tokenizer, fields)) return true;
         }
         
+        CsvSchema schema;
         int count = 0;
         while(maxRows == 0 || count < maxRows) {
-            if (!std::getline(file, line)) break;
+            if (!readRecord(file, record, line, tokenizer, fields)) break;
             
             DataRow row;
-            std::istringstream lineStream(line);
-            std::string cell;
-            bool isValid = true;
-
-            while (std::getline(lineStream, cell, ',')) {
-                try {
-                    auto value = parseCellValue(cell);
-                    row.data.push_back(value);
-                } catch (...) {
-                    row.data.push_back(std::string(""));
-                    isValid = false;
-                }
-            }
-
+            buildRow(fields, row, schema, skipLines == 0 && count == 0);
             row.rowNumber = offset + count + 1; // 1-based
-            row.isValid = isValid;
-            row.sheetName = "Sheet1";
             data.push_back(std::move(row));
             
             count++;
@@ -645,6 +723,36 @@ public:
         return true;
     }
 
+    std::unique_ptr<ChunkCursor> openChunkCursor(const std::string& filename, const std::string& sheetName = "", bool includeHeader = false) override;
+
+    // Read and split one CSV record from a line stream. A quoted field may span several lines,
+    // so lines are appended to record until its quotes are closed. fields point into record/tokenizer.
+    static bool readRecord(std::istream& in, std::string& record, std::string& line,
+                           CsvTokenizer& tokenizer, std::vector<std::string_view>& fields) {
+        if (!std::getline(in, record)) return false;
+        while (true) {
+            tokenizer.reset(record.data(), record.data() + record.size());
+            tokenizer.nextRecord(fields);
+            if (!tokenizer.endedInQuotes() || !std::getline(in, line)) return true;
+            record += '\n';
+            record += line;
+        }
+    }
+
+    // Convert tokenized fields to typed cells using the file's column schema (header rows are kept out of inference)
+    static void buildRow(const std::vector<std::string_view>& fields, DataRow& row, CsvSchema& schema, bool isHeader = false) {
+        row.data.reserve(fields.size());
+        try {
+            schema.parseRecord(fields, row.data, !isHeader);
+            row.isValid = true;
+        } catch (...) {
+            row.data.resize(fields.size(), std::string(""));
+            row.isValid = false;
+        }
+        static const auto kSheetName = std::make_shared<const std::string>("Sheet1");
+        row.sheetName = kSheetName;
+    }
+
     bool getSheetNames(const std::string& filename, std::vector<std::string>& sheetNames) const override {
         sheetNames.clear();
         sheetNames.push_back("Sheet1"); // CSV has only one sheet
@@ -679,143 +787,995 @@ public:
         return columnCount;
     }
 
+    bool isMemoryMapped() const { return memoryMapped_; }
+    int fileOpenCount() const override { return openCount_; }
+
 private:
-    std::variant<std::string, int, double, bool, std::tm> parseCellValue(const std::string& cell) {
-        // Remove quotes
-        std::string trimmedCell = cell;
-        if (trimmedCell.length() >= 2 && trimmedCell.front() == '"' && trimmedCell.back() == '"') {
-            trimmedCell = trimmedCell.substr(1, trimmedCell.length() - 2);
+    static constexpr size_t kParallelReadMinBytes = 4 << 20;
+    static constexpr size_t kParallelReadMinRangeBytes = 1 << 20;
+
+    struct ParsedRange {
+        std::vector<DataRow> rows;
+        const char* begin = nullptr;  // Where parsing started
+        const char* end = nullptr;    // Position after the last record parsed
+    };
+
+    // Parse records starting at begin until the tokenizer reaches stop (the last record may run past it).
+    // Each range infers its own schema; hasHeader marks the first record as the header.
+    static void parseRange(const char* begin, const char* stop, const char* bufferEnd, bool hasHeader, ParsedRange& range) {
+        range.rows.clear();
+        range.begin = begin;
+        CsvTokenizer tokenizer(begin, bufferEnd);
+        CsvSchema schema;
+        std::vector<std::string_view> fields;
+        while (tokenizer.position() < stop && tokenizer.nextRecord(fields)) {
+            DataRow row;
+            buildRow(fields, row, schema, hasHeader && range.rows.empty());
+            range.rows.push_back(std::move(row));
+        }
+        range.end = tokenizer.position();
+    }
+
+    // Splits [begin, end) into record-aligned ranges, parses them concurrently and appends the rows in file order.
+    // A range whose start turns out not to be where the previous range stopped (possible only with malformed
+    // quoting) is parsed again from the right position, so the result always equals a sequential read.
+    // There are a few ranges per scheduler thread, so threads that finish early take over the rest.
+    static void readParallel(const char* begin, const char* end, std::vector<DataRow>& data, int offset, bool hasHeader) {
+        size_t threads = TaskScheduler::shared().threadCount();
+        size_t parts = std::min(4 * threads, std::max<size_t>(1, (end - begin) / kParallelReadMinRangeBytes));
+        std::vector<const char*> bounds = splitCsvRecords(begin, end, parts);
+
+        std::vector<ParsedRange> ranges(bounds.size() - 1);
+        TaskScheduler::shared().parallelFor(ranges.size(), 1, [&bounds, &ranges, end, hasHeader](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) parseRange(bounds[i], bounds[i + 1], end, hasHeader && i == 0, ranges[i]);
+        });
+
+        const char* expected = begin;
+        size_t total = 0;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (expected >= end) {
+                ranges[i].rows.clear();
+                continue;
+            }
+            if (ranges[i].begin != expected) {
+                parseRange(expected, bounds[i + 1], end, hasHeader && expected == begin, ranges[i]);
+            }
+            expected = ranges[i].end;
+            total += ranges[i].rows.size();
         }
 
-        // Handle empty
-        if (trimmedCell.empty()) {
-            return std::string("");
+        data.reserve(data.size() + total);
+        int rowNumber = offset;
+        for (auto& range : ranges) {
+            for (auto& row : range.rows) {
+                row.rowNumber = ++rowNumber; // 1-based
+                data.push_back(std::move(row));
+            }
         }
+    }
 
-        // Handle boolean
-        std::string lowerCell = trimmedCell;
-        std::transform(lowerCell.begin(), lowerCell.end(), lowerCell.begin(), 
-            [](unsigned char c){ return std::tolower(c); });
-            
-        if (lowerCell == "true") return true;
-        if (lowerCell == "false") return false;
+    bool memoryMapped_;
+    int openCount_ = 0;
+};
 
-        // Handle integer
-        try {
-            if (trimmedCell.find('.') == std::string::npos &&
-                trimmedCell.find_first_not_of("0123456789-+") == std::string::npos) {
-                return std::stoi(trimmedCell);
+// Streaming CSV cursor: opens the file once and keeps the read position between chunks,
+// so a full pass is linear instead of re-skipping all previous lines on every chunk.
+// Reads from a memory mapping when available, otherwise from a buffered ifstream.
+class CSVChunkCursor : public ChunkCursor {
+public:
+    CSVChunkCursor(const std::string& filename, bool includeHeader, bool memoryMapped) : includeHeader_(includeHeader) {
+        if (memoryMapped && mapped_.open(filename)) {
+            isMapped_ = true;
+            tokenizer_.reset(mapped_.data(), mapped_.data() + mapped_.size());
+        } else {
+            buffer_.resize(1 << 20);
+            file_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size()); // Must be set before open()
+            file_.open(filename);
+            if (!file_.is_open()) {
+                atEnd_ = true;
+                return;
             }
-        } catch (...) {}
+        }
 
-        // Handle double
-        try {
-            if (trimmedCell.find_first_of("0123456789.") != std::string::npos) {
-                return std::stod(trimmedCell);
+        // Same numbering as readExcelFile: header is row 1 when requested, otherwise it is skipped
+        // and data rows are numbered from 1.
+        if (!includeHeader) {
+            if (isMapped_) {
+                if (!tokenizer_.skipRecord()) atEnd_ = true;
+            } else {
+                if (!CSVExcelReader::readRecord(file_, record_, line_, tokenizer_, fields_)) atEnd_ = true;
             }
-        } catch (...) {}
+        }
+        if (isMapped_ && tokenizer_.atEnd()) atEnd_ = true;
+    }
 
-        // Handle date
-        try {
-            std::tm tm = {};
-            std::istringstream ss(trimmedCell);
-            ss >> std::get_time(&tm, "%Y-%m-%d");
-            if (!ss.fail()) return tm;
+    bool isOpen() const { return isMapped_ || file_.is_open(); }
+
+    bool readNextChunk(std::vector<DataRow>& data, int maxRows) override {
+        int count = 0;
+        while (!atEnd_ && (maxRows == 0 || count < maxRows)) {
+            DataRow row;
+            if (isMapped_) {
+                if (!tokenizer_.nextRecord(fields_)) {
+                    atEnd_ = true;
+                    break;
+                }
+                CSVExcelReader::buildRow(fields_, row, schema_, includeHeader_ && rowsRead_ == 0);
+            } else {
+                if (!CSVExcelReader::readRecord(file_, record_, line_, tokenizer_, fields_)) {
+                    atEnd_ = true;
+                    break;
+                }
+                CSVExcelReader::buildRow(fields_, row, schema_, includeHeader_ && rowsRead_ == 0);
+            }
+
+            row.rowNumber = ++rowsRead_;
+            data.push_back(std::move(row));
+            count++;
+        }
+
+        // Check ahead so that a chunk ending exactly at EOF is reported as the last one
+        if (!atEnd_) {
+            if (isMapped_ ? tokenizer_.atEnd() : file_.peek() == std::ifstream::traits_type::eof()) atEnd_ = true;
+        }
+        return true;
+    }
+
+    bool atEnd() const override { return atEnd_; }
+    bool supportsBackgroundRead() const override { return true; }
+
+private:
+    MappedFile mapped_;
+    CsvTokenizer tokenizer_;
+    bool isMapped_ = false;
+
+    std::vector<char> buffer_;
+    std::ifstream file_;
+    std::string record_;
+    std::string line_;
+
+    std::vector<std::string_view> fields_;
+    CsvSchema schema_;  // Inferred from the first rows, kept for the rest of the file
+    bool includeHeader_;
+    int rowsRead_ = 0;
+    bool atEnd_ = false;
+};
+
+std::unique_ptr<ChunkCursor> CSVExcelReader::openChunkCursor(const std::string& filename, const std::string& sheetName, bool includeHeader) {
+    ++openCount_;
+    auto cursor = std::make_unique<CSVChunkCursor>(filename, includeHeader, memoryMapped_);
+    if (!cursor->isOpen()) return nullptr;
+    return cursor;
+}
+
+// Fallback cursor for readers without native streaming (e.g. ActiveQt):
+// tracks the data-row offset and re-reads through readExcelFile.
+class OffsetChunkCursor : public ChunkCursor {
+public:
+    OffsetChunkCursor(ExcelReader* reader, const std::string& filename, const std::string& sheetName, bool includeHeader)
+        : reader_(reader), filename_(filename), sheetName_(sheetName), includeHeader_(includeHeader) {}
+
+    bool readNextChunk(std::vector<DataRow>& data, int maxRows) override {
+        if (atEnd_) return true;
+
+        size_t before = data.size();
+        if (!reader_->readExcelFile(filename_, data, sheetName_, maxRows, offset_, includeHeader_)) {
+            atEnd_ = true;
+            return false;
+        }
+
+        int rows = static_cast<int>(data.size() - before);
+        // The first chunk carries the header row, which is not counted in the data offset
+        if (isFirstChunk_ && includeHeader_ && rows > 0) {
+            offset_ += rows - 1;
+        } else {
+            offset_ += rows;
+        }
+        isFirstChunk_ = false;
+
+        if (rows == 0 || (maxRows > 0 && rows < maxRows)) atEnd_ = true;
+        return true;
+    }
+
+    bool atEnd() const override { return atEnd_; }
+
+private:
+    ExcelReader* reader_;
+    std::string filename_;
+    std::string sheetName_;
+    bool includeHeader_;
+    int offset_ = 0;
+    bool isFirstChunk_ = true;
+    bool atEnd_ = false;
+};
+
+std::unique_ptr<ChunkCursor> ExcelReader::openChunkCursor(const std::string& filename, const std::string& sheetName, bool includeHeader) {
+    return std::make_unique<OffsetChunkCursor>(this, filename, sheetName, includeHeader);
+}
 
-            ss.str(trimmedCell);
-            ss.clear();
-            ss >> std::get_time(&tm, "%Y/%m/%d");
-            if (!ss.fail()) return tm;
-        } catch (...) {}
+// Parsed workbook of the current .xlsx input. Listing sheets, querying dimensions and opening each
+// sheet's cursor share one parse of the zip directory, shared strings and styles; the file is parsed
+// again only when its path, size or modification time changes. Cursors hold their own reference, so a
+// reparse never unmaps a workbook that is still being read.
+class XlsxInputCache {
+public:
+    std::shared_ptr<const XlsxWorkbook> workbook(const std::string& filename, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        QFileInfo info(QString::fromStdString(filename));
+        std::string path = info.absoluteFilePath().toStdString();
+        qint64 size = info.size();
+        qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        if (workbook_ && path == path_ && size == size_ && modified == modified_) return workbook_;
+
+        auto workbook = std::make_shared<XlsxWorkbook>();
+        ++openCount_;
+        if (!workbook->open(filename)) {
+            error = workbook->error();
+            return nullptr;
+        }
+        workbook_ = workbook;
+        path_ = path;
+        size_ = size;
+        modified_ = modified;
+        dimensions_.clear();
+        return workbook_;
+    }
+
+    // Last row and column of a sheet of the cached workbook: its <dimension>, or a scan of the rows
+    // when the sheet has none. Computed once per sheet.
+    bool dimension(const std::string& sheetName, int& rows, int& columns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const XlsxSheetInfo* sheet = workbook_ ? workbook_->findSheet(sheetName) : nullptr;
+        if (!sheet) return false;
+
+        auto it = dimensions_.find(sheet->name);
+        if (it == dimensions_.end()) {
+            XlsxSheetReader reader;
+            if (!reader.open(*workbook_, *sheet)) return false;
+            int lastRow = reader.dimensionRows();
+            int lastColumn = reader.dimensionColumns();
+            if (lastRow == 0) {
+                int number = 0;
+                std::vector<CellValue> cells;
+                while (reader.nextRow(number, cells)) {
+                    lastRow = number;
+                    lastColumn = std::max(lastColumn, static_cast<int>(cells.size()));
+                }
+            }
+            it = dimensions_.emplace(sheet->name, std::make_pair(lastRow, lastColumn)).first;
+        }
+        rows = it->second.first;
+        columns = it->second.second;
+        return true;
+    }
 
-        // Default to string
-        return trimmedCell;
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workbook_.reset();
+        path_.clear();
+        dimensions_.clear();
     }
+
+    int openCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return openCount_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const XlsxWorkbook> workbook_;
+    std::string path_;
+    qint64 size_ = -1;
+    qint64 modified_ = 0;
+    std::map<std::string, std::pair<int, int>> dimensions_; // Sheet name -> last row, last column
+    int openCount_ = 0;
 };
 
+// Rows of one .xlsx sheet in file order, with the ActiveQt reader's conventions: rows are numbered
+// by their sheet row, rows without any text are skipped, and when the header is requested row 1 is
+// always returned first (empty if the sheet does not have one).
+class XlsxRowSource {
+public:
+    bool open(std::shared_ptr<const XlsxWorkbook> workbook, const std::string& sheetName, bool includeHeader, std::string& error) {
+        includeHeader_ = includeHeader;
+        workbook_ = std::move(workbook);
+        const XlsxSheetInfo* sheet = workbook_->findSheet(sheetName);
+        if (!sheet) {
+            error = "Sheet not found: " + sheetName;
+            return false;
+        }
+        sheetName_ = std::make_shared<const std::string>(sheet->name);
+        if (!sheetReader_.open(*workbook_, *sheet)) {
+            error = "Unable to read sheet: " + sheet->name;
+            return false;
+        }
+        return true;
+    }
+
+    // Next row to return; false at the end of the sheet
+    bool next(DataRow& row) {
+        row.data.clear();
+        row.sheetName = sheetName_;
+        row.isValid = true;
+
+        if (pendingNumber_ > 0) {
+            row.rowNumber = pendingNumber_;
+            pendingNumber_ = 0;
+            if (!isBlank(pending_)) {
+                row.data = std::move(pending_);
+                return true;
+            }
+        }
+
+        int number = 0;
+        while (sheetReader_.nextRow(number, row.data)) {
+            if (includeHeader_ && !headerSeen_) {
+                headerSeen_ = true;
+                if (number > 1) {
+                    // Row 1 is missing from the file: return it empty and keep this row for the next call
+                    pending_ = std::move(row.data);
+                    pendingNumber_ = number;
+                    row.data.assign(std::max(sheetReader_.dimensionColumns(), 1), std::string());
+                }
+                row.rowNumber = 1;
+                return true;
+            }
+            if (isBlank(row.data)) continue;
+            row.rowNumber = number;
+            return true;
+        }
+
+        if (includeHeader_ && !headerSeen_ && !sheetReader_.failed()) {
+            // Empty sheet: Excel still reports A1 as the used range
+            headerSeen_ = true;
+            row.data.assign(1, std::string());
+            row.rowNumber = 1;
+            return true;
+        }
+        return false;
+    }
+
+    bool failed() const { return sheetReader_.failed(); }
+
+private:
+    static bool isBlank(const std::vector<CellValue>& cells) {
+        for (const auto& cell : cells) {
+            const std::string* text = std::get_if<std::string>(&cell);
+            if (!text || !text->empty()) return false;
+        }
+        return true;
+    }
+
+    std::shared_ptr<const XlsxWorkbook> workbook_;
+    XlsxSheetReader sheetReader_;
+    std::shared_ptr<const std::string> sheetName_;
+    bool includeHeader_ = false;
+    bool headerSeen_ = false;
+    std::vector<CellValue> pending_;
+    int pendingNumber_ = 0;
+};
+
+// Streaming cursor over one .xlsx sheet of an already parsed workbook: the sheet XML is decoded as
+// chunks are requested, so memory does not grow with the sheet size.
+class XlsxChunkCursor : public ChunkCursor {
+public:
+    bool open(std::shared_ptr<const XlsxWorkbook> workbook, const std::string& sheetName, bool includeHeader, std::string& error) {
+        if (!source_.open(std::move(workbook), sheetName, includeHeader, error)) return false;
+        hasLookahead_ = source_.next(lookahead_);
+        return !source_.failed();
+    }
+
+    bool readNextChunk(std::vector<DataRow>& data, int maxRows) override {
+        int count = 0;
+        while (hasLookahead_ && (maxRows == 0 || count < maxRows)) {
+            data.push_back(std::move(lookahead_));
+            lookahead_ = DataRow();
+            hasLookahead_ = source_.next(lookahead_);
+            count++;
+        }
+        return !source_.failed();
+    }
+
+    bool atEnd() const override { return !hasLookahead_; }
+    bool supportsBackgroundRead() const override { return true; }
+
+private:
+    XlsxRowSource source_;
+    DataRow lookahead_;  // Read one row ahead so the last chunk is reported as the last
+    bool hasLookahead_ = false;
+};
+
+// Native .xlsx reader: unzips the workbook and streams the sheet XML without Excel or COM.
+// The parsed workbook is cached until closeInput(), so every call on the same input reuses it.
+class XlsxExcelReader : public ExcelReader {
+public:
+    void setLogger(std::function<void(const std::string&)> logger) override {
+        logger_ = logger;
+    }
+
+    bool readExcelFile(const std::string& filename, std::vector<DataRow>& data, const std::string& sheetName = "", int maxRows = 0, int offset = 0, bool includeHeader = false) override {
+        XlsxRowSource source;
+        std::string error;
+        auto workbook = cache_.workbook(filename, error);
+        if (!workbook || !source.open(workbook, sheetName, includeHeader, error)) {
+            if (logger_) logger_("ERROR: " + error);
+            return false;
+        }
+
+        // Same absolute start row as the ActiveQt reader: with a header, row 1 is not counted in offset
+        int startRow = 1;
+        if (offset > 0) startRow = includeHeader ? offset + 2 : offset + 1;
+
+        DataRow row;
+        while (source.next(row)) {
+            if (row.rowNumber < startRow) continue;
+            if (maxRows > 0 && row.rowNumber >= startRow + maxRows) break;
+            data.push_back(std::move(row));
+            row = DataRow();
+        }
+        if (source.failed()) {
+            if (logger_) logger_("ERROR: Corrupt sheet data in " + filename);
+            return false;
+        }
+        return true;
+    }
+
+    std::unique_ptr<ChunkCursor> openChunkCursor(const std::string& filename, const std::string& sheetName, bool includeHeader) override {
+        auto cursor = std::make_unique<XlsxChunkCursor>();
+        std::string error;
+        auto workbook = cache_.workbook(filename, error);
+        if (!workbook || !cursor->open(workbook, sheetName, includeHeader, error)) {
+            if (logger_) logger_("ERROR: " + error);
+            return nullptr;
+        }
+        return cursor;
+    }
+
+    bool getSheetNames(const std::string& filename, std::vector<std::string>& sheetNames) const override {
+        std::string error;
+        auto workbook = cache_.workbook(filename, error);
+        if (!workbook) return false;
+        sheetNames.clear();
+        for (const auto& sheet : workbook->sheets()) {
+            sheetNames.push_back(sheet.name);
+        }
+        return true;
+    }
+
+    // Last row / column of a sheet of the cached workbook (0 before any file was opened)
+    int getRowCount(const std::string& sheetName) const override {
+        int rows = 0, columns = 0;
+        return cache_.dimension(sheetName, rows, columns) ? rows : 0;
+    }
+    int getColumnCount(const std::string& sheetName) const override {
+        int rows = 0, columns = 0;
+        return cache_.dimension(sheetName, rows, columns) ? columns : 0;
+    }
+
+    void closeInput() override { cache_.clear(); }
+    int fileOpenCount() const override { return cache_.openCount(); }
+
+private:
+    std::function<void(const std::string&)> logger_;
+    mutable XlsxInputCache cache_;
+};
+
+std::unique_ptr<ExcelReader> createExcelReader(const std::string& filename, bool memoryMapped) {
+    std::string ext = filename.substr(filename.find_last_of(".") + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == "xlsx") {
+        return std::make_unique<XlsxExcelReader>();
+    }
+    if (ext == "xls") {
+        return std::make_unique<ActiveQtExcelReader>(); // Legacy binary format still needs Excel
+    }
+    return std::make_unique<CSVExcelReader>(memoryMapped);
+}
+
 // CSV Excel Writer
+// In persistent mode each destination is opened once and stays open (buffered) until closeAll(),
+// like ActiveQtExcelWriter keeps its workbooks open; otherwise every call opens, writes and closes.
 class CSVExcelWriter : public ExcelWriter {
 public:
+    explicit CSVExcelWriter(bool persistent = false) : persistent_(persistent) {}
+    ~CSVExcelWriter() override {
+        closeAll();
+    }
+
     ExcelWriterType getType() const override { return ExcelWriterType::CSV; }
 
+    void closeAll() override {
+        openFiles_.clear(); // Sinks flush on destruction
+    }
+
     bool writeExcelFile(const std::string& filename,
                         const std::vector<DataRow>& data,
                         const std::string& sheetName = "Sheet1") override {
-        std::ofstream file(filename);
+        return writeRows(filename, data, true);
+    }
+
+    bool writeMultipleSheets(const std::string& filename,
+                               const std::map<std::string, std::vector<DataRow>>& sheetData) override {
+        // CSV only supports single sheet, write first one
+        if (!sheetData.empty()) {
+            return writeExcelFile(filename + "_" + sheetData.begin()->first + ".csv",
+                              sheetData.begin()->second,
+                              sheetData.begin()->first);
+        }
+        return true;
+    }
+
+    bool appendToSheet(const std::string& filename,
+                        const std::vector<DataRow>& data,
+                        const std::string& sheetName,
+                        bool overwrite = false) override {
+        return writeRows(filename, data, overwrite);
+    }
+
+    bool isSheetEmpty(const std::string& filename, const std::string& sheetName) {
+        if (persistent_) {
+            // Answered from the open sink, which is then reused by the following appends
+            OutputSink* sink = openSink(filename, false);
+            return sink && sink->initialSize + sink->output->bytesWritten() == 0;
+        }
+        std::ifstream file(filename);
+        return file.peek() == std::ifstream::traits_type::eof();
+    }
+
+    // Number of times a destination file has been opened (for benchmarks)
+    int openCount() const { return openCount_; }
+
+private:
+    struct OutputSink {
+        std::ofstream file;
+        std::unique_ptr<CsvOutputBuffer> output;
+        qint64 initialSize = 0;
+    };
+
+    // Returns the open sink for filename, (re)opening it when needed; truncate always starts a new file
+    OutputSink* openSink(const std::string& filename, bool truncate) {
+        std::string key = QFileInfo(QString::fromStdString(filename)).absoluteFilePath().toStdString();
+        auto it = openFiles_.find(key);
+        if (it != openFiles_.end()) {
+            if (!truncate) return it->second.get();
+            openFiles_.erase(it); // Flush and close before truncating
+        }
+
+        auto sink = std::make_unique<OutputSink>();
+        sink->initialSize = truncate ? 0 : QFileInfo(QString::fromStdString(filename)).size();
+        sink->file.open(filename, truncate ? std::ios::trunc : std::ios::app);
+        ++openCount_;
+        if (!sink->file.is_open()) return nullptr;
+        sink->output = std::make_unique<CsvOutputBuffer>(sink->file);
+        return openFiles_.emplace(key, std::move(sink)).first->second.get();
+    }
+
+    bool writeRows(const std::string& filename, const std::vector<DataRow>& data, bool truncate) {
+        if (persistent_) {
+            OutputSink* sink = openSink(filename, truncate);
+            if (!sink) return false;
+            for (const auto& row : data) {
+                sink->output->appendRow(row.data);
+            }
+            return static_cast<bool>(sink->file);
+        }
+
+        std::ofstream file(filename, truncate ? std::ios::trunc : std::ios::app);
+        ++openCount_;
         if (!file.is_open()) {
             return false;
         }
 
         // Write data
+        CsvOutputBuffer output(file);
         for (const auto& row : data) {
-            std::string line;
-            for (size_t i = 0; i < row.data.size(); ++i) {
-                if (i > 0) line += ",";
-                line += formatCellValue(row.data[i]);
+            output.appendRow(row.data);
+        }
+
+        return output.flush();
+    }
+
+    bool persistent_;
+    int openCount_ = 0;
+    std::map<std::string, std::unique_ptr<OutputSink>> openFiles_; // Key: absolute path
+};
+
+// Native .xlsx writer: each destination is built by an XlsxWorkbookWriter that stays open until
+// closeAll()/saveAll(), so a workbook is written to disk once instead of being saved after every chunk.
+// Appending to an .xlsx file that is not open yet starts from its cell values.
+class XlsxExcelWriter : public ExcelWriter {
+public:
+    ~XlsxExcelWriter() override {
+        closeAll();
+    }
+
+    ExcelWriterType getType() const override { return ExcelWriterType::Xlsx; }
+
+    void closeAll() override {
+        std::vector<std::string> failedFiles;
+        saveAll(failedFiles);
+    }
+
+    // Writes every modified workbook and closes all of them; returns false if any could not be written
+    bool saveAll(std::vector<std::string>& failedFiles) {
+        for (auto& pair : openWorkbooks_) {
+            OpenWorkbook& open = pair.second;
+            if (!open.modified) continue;
+            ++saveCount_;
+            if (!open.writer->save(open.filename)) failedFiles.push_back(open.filename);
+        }
+        openWorkbooks_.clear();
+        return failedFiles.empty();
+    }
+
+    bool writeExcelFile(const std::string& filename,
+                        const std::vector<DataRow>& data,
+                        const std::string& sheetName = "Sheet1") override {
+        OpenWorkbook& open = createWorkbook(filename);
+        return open.writer->appendRows(open.writer->addSheet(sheetName), data);
+    }
+
+    bool writeMultipleSheets(const std::string& filename,
+                             const std::map<std::string, std::vector<DataRow>>& sheetData) override {
+        OpenWorkbook& open = createWorkbook(filename);
+        for (const auto& [name, data] : sheetData) {
+            if (!open.writer->appendRows(open.writer->addSheet(name), data)) return false;
+        }
+        return true;
+    }
+
+    bool appendToSheet(const std::string& filename,
+                       const std::vector<DataRow>& data,
+                       const std::string& sheetName,
+                       bool overwrite = false) override {
+        OpenWorkbook* open = openWorkbook(filename);
+        if (!open) return false;
+        open->modified = true;
+
+        int sheet = open->writer->findSheet(sheetName);
+        if (sheet < 0) {
+            sheet = open->writer->addSheet(sheetName);
+        } else if (overwrite) {
+            open->writer->clearSheet(sheet);
+        }
+        return open->writer->appendRows(sheet, data);
+    }
+
+    bool isSheetEmpty(const std::string& filename, const std::string& sheetName) {
+        std::string key = QFileInfo(QString::fromStdString(filename)).absoluteFilePath().toStdString();
+        if (!openWorkbooks_.count(key) && !QFile::exists(QString::fromStdString(filename))) return true;
+
+        OpenWorkbook* open = openWorkbook(filename); // Kept open for the appends that follow
+        if (!open) return false;
+        int sheet = open->writer->findSheet(sheetName);
+        return sheet < 0 || open->writer->isSheetEmpty(sheet);
+    }
+
+    // Number of workbooks written to disk (for benchmarks)
+    int saveCount() const { return saveCount_; }
+
+private:
+    struct OpenWorkbook {
+        std::string filename;
+        std::unique_ptr<XlsxWorkbookWriter> writer;
+        bool modified = false;   // Workbooks only inspected by isSheetEmpty() are not rewritten
+    };
+
+    // Starts an empty workbook for filename, discarding one that is open (we are overwriting)
+    OpenWorkbook& createWorkbook(const std::string& filename) {
+        std::string key = QFileInfo(QString::fromStdString(filename)).absoluteFilePath().toStdString();
+        OpenWorkbook& open = openWorkbooks_[key];
+        open.filename = filename;
+        open.writer = std::make_unique<XlsxWorkbookWriter>();
+        open.modified = true;
+        return open;
+    }
+
+    // Returns the open workbook for filename, loading the existing file the first time; nullptr if it cannot be read
+    OpenWorkbook* openWorkbook(const std::string& filename) {
+        std::string key = QFileInfo(QString::fromStdString(filename)).absoluteFilePath().toStdString();
+        auto it = openWorkbooks_.find(key);
+        if (it != openWorkbooks_.end()) return &it->second;
+
+        OpenWorkbook open;
+        open.filename = filename;
+        open.writer = std::make_unique<XlsxWorkbookWriter>();
+        if (QFile::exists(QString::fromStdString(filename)) && !open.writer->load(filename)) return nullptr;
+        return &openWorkbooks_.emplace(key, std::move(open)).first->second;
+    }
+
+    int saveCount_ = 0;
+    std::map<std::string, OpenWorkbook> openWorkbooks_; // Key: absolute path
+};
+
+std::unique_ptr<ExcelWriter> createExcelWriter(ExcelWriterType type) {
+    if (type == ExcelWriterType::ActiveQt) {
+        return std::make_unique<ActiveQtExcelWriter>();
+    }
+    if (type == ExcelWriterType::Xlsx) {
+        return std::make_unique<XlsxExcelWriter>();
+    }
+    return std::make_unique<CSVExcelWriter>();
+}
+
+// A task's rule references resolved to positions in a CompiledRuleSet (-1 = no such rule)
+struct TaskRuleIndices {
+    RuleLogic logic = RuleLogic::OR;
+    std::vector<std::pair<int, std::vector<int>>> entries; // Include rules and their granular exclusions
+    std::vector<int> excludes;                             // Global exclusions
+};
+
+// Rule answers for the rows of one chunk: one bitmap per rule of a CompiledRuleSet, computed on first
+// use and shared by every task working on the chunk, so a rule runs at most once per row however many
+// tasks include or exclude it. A task's rows are then bitwise OR / AND / AND NOT of these bitmaps.
+class ChunkRuleBitmaps {
+public:
+    using Bitmap = std::vector<uint64_t>;
+
+    // Starts a new chunk; rows must stay unchanged until the next reset
+    void reset(const CompiledRuleSet& ruleSet, const std::vector<DataRow>& rows) {
+        ruleSet_ = &ruleSet;
+        rows_ = &rows;
+        computed_ = false;
+    }
+
+    // Rows the task keeps: its include rules (OR / AND of each rule minus its granular exclusions,
+    // all rows if it has none) minus its global exclusions
+    void taskRows(const TaskRuleIndices& task, Bitmap& result) {
+        const size_t words = (rows_->size() + 63) / 64;
+        if (!task.entries.empty() || !task.excludes.empty()) compute();
+
+        if (task.entries.empty()) {
+            allRows(result);
+        } else if (task.logic == RuleLogic::OR) {
+            result.assign(words, 0);
+            for (const auto& [ruleIndex, excludeIndices] : task.entries) {
+                for (size_t w = 0; w < words; ++w) result[w] |= word(ruleIndex, w) & ~anyOf(excludeIndices, w);
+            }
+        } else {
+            allRows(result);
+            for (const auto& [ruleIndex, excludeIndices] : task.entries) {
+                for (size_t w = 0; w < words; ++w) result[w] &= word(ruleIndex, w) & ~anyOf(excludeIndices, w);
             }
-            file << line << std::endl;
         }
+        for (size_t w = 0; w < words; ++w) result[w] &= ~anyOf(task.excludes, w);
+    }
+
+    static bool test(const Bitmap& bitmap, size_t row) { return (bitmap[row / 64] >> (row % 64)) & 1; }
+
+    // Appends the chunk's rows set in bitmap to out, in row order, and returns how many. The rows of
+    // each morsel are counted first, so the morsels copy straight into their own slice of out.
+    size_t appendRows(const Bitmap& bitmap, std::vector<DataRow>& out) const {
+        const size_t rowCount = rows_->size();
+        const size_t morsel = morselRows();
+        const size_t start = out.size();
+        if (morsel >= rowCount || TaskScheduler::shared().threadCount() == 1) {
+            for (size_t row = 0; row < rowCount; ++row) {
+                if (test(bitmap, row)) out.push_back((*rows_)[row]);
+            }
+            return out.size() - start;
+        }
+
+        std::vector<size_t> offsets(1, start);
+        for (size_t begin = 0; begin < rowCount; begin += morsel) {
+            const size_t end = std::min(rowCount, begin + morsel);
+            size_t count = 0;
+            for (size_t w = begin / 64; w < (end + 63) / 64; ++w) {
+                uint64_t bits = bitmap[w];
+                if (w == end / 64) bits &= (uint64_t(1) << (end % 64)) - 1;
+                count += std::bitset<64>(bits).count();
+            }
+            offsets.push_back(offsets.back() + count);
+        }
+        out.resize(offsets.back());
+        TaskScheduler::shared().parallelFor(rowCount, morsel, [this, &bitmap, &out, &offsets, morsel](size_t begin, size_t end) {
+            size_t next = offsets[begin / morsel];
+            for (size_t row = begin; row < end; ++row) {
+                if (test(bitmap, row)) out[next++] = (*rows_)[row];
+            }
+        });
+        return offsets.back() - start;
+    }
+
+    // Whether this chunk's rows have been evaluated
+    bool computed() const { return computed_; }
+
+private:
+    // Rows per work item of compute() and appendRows(): a whole number of bitmap words, small enough
+    // that one 5000-row chunk gives every thread a few morsels
+    size_t morselRows() const {
+        const size_t threads = TaskScheduler::shared().threadCount();
+        const size_t rows = (rows_->size() / (threads * 4) + 63) / 64 * 64;
+        return std::min<size_t>(1024, std::max<size_t>(128, rows));
+    }
+
+    // The rule set evaluates the chunk a column at a time, so only the columns it reads are converted.
+    // Morsels of rows are evaluated on the core's scheduler and their words copied into place.
+    void compute() {
+        if (computed_) return;
+        computed_ = true;
+        const size_t words = (rows_->size() + 63) / 64;
+        const std::vector<int> columns = ruleSet_->columns();
+        ruleBitmaps_.resize(ruleSet_->ruleCount());
+        for (auto& bitmap : ruleBitmaps_) bitmap.assign(words, 0);
+        TaskScheduler::shared().parallelFor(rows_->size(), morselRows(), [this, &columns](size_t begin, size_t end) {
+            thread_local ColumnarChunk columnar;
+            thread_local std::vector<Bitmap> morselBitmaps;
+            columnar.assign(*rows_, begin, end, columns);
+            ruleSet_->evaluateColumns(columnar, morselBitmaps);
+            for (size_t r = 0; r < morselBitmaps.size(); ++r) {
+                std::copy(morselBitmaps[r].begin(), morselBitmaps[r].end(), ruleBitmaps_[r].begin() + begin / 64);
+            }
+        });
+    }
+
+    void allRows(Bitmap& result) const {
+        const size_t rowCount = rows_->size();
+        result.assign((rowCount + 63) / 64, ~uint64_t(0));
+        if (rowCount % 64) result.back() = (uint64_t(1) << (rowCount % 64)) - 1;
+    }
+
+    uint64_t word(int ruleIndex, size_t w) const { return ruleIndex >= 0 ? ruleBitmaps_[ruleIndex][w] : 0; }
+
+    uint64_t anyOf(const std::vector<int>& ruleIndices, size_t w) const {
+        uint64_t bits = 0;
+        for (int ruleIndex : ruleIndices) bits |= word(ruleIndex, w);
+        return bits;
+    }
+
+    const CompiledRuleSet* ruleSet_ = nullptr;
+    const std::vector<DataRow>* rows_ = nullptr;
+    bool computed_ = false;
+    std::vector<Bitmap> ruleBitmaps_;
+};
+
+// Reader stage of the pipelined task loop: reads chunks from the cursor on a background thread,
+// staying at most maxChunksAhead chunks ahead of the consumer. The cursor must outlive the prefetcher.
+class ChunkPrefetcher {
+public:
+    struct Chunk {
+        std::vector<DataRow> rows;
+        bool ok = true;
+        bool atEnd = false;
+    };
+
+    ChunkPrefetcher(ChunkCursor& cursor, int chunkSize, size_t maxChunksAhead) : queue_(maxChunksAhead) {
+        thread_ = std::thread([this, &cursor, chunkSize]() {
+            while (true) {
+                Chunk chunk;
+                chunk.ok = cursor.readNextChunk(chunk.rows, chunkSize);
+                chunk.atEnd = !chunk.ok || chunk.rows.empty() || cursor.atEnd();
+                bool last = chunk.atEnd;
+                if (!queue_.push(std::move(chunk)) || last) break;
+            }
+        });
+    }
+
+    ~ChunkPrefetcher() {
+        queue_.close(); // Unblocks the reader if the consumer stopped early
+        thread_.join();
+    }
+
+    // Next chunk in file order; false once the last chunk has been taken
+    bool next(Chunk& chunk) { return queue_.pop(chunk); }
+
+private:
+    BoundedQueue<Chunk> queue_;
+    std::thread thread_;
+};
+
+// Writer stage of the pipelined task loop: CSV and native .xlsx writes are queued and carried out in
+// order on a background thread, through a persistent CSVExcelWriter and an XlsxExcelWriter.
+// ActiveQt output stays on the calling thread, since its COM objects belong to that thread.
+class AsyncTaskWriter {
+public:
+    enum class WriteMode {
+        NewWorkbook,       // writeExcelFile: replaces the destination
+        Append,            // appendToSheet below the existing rows
+        OverwriteSheet     // appendToSheet into a cleared sheet
+    };
+
+    struct Failure {
+        int taskId;
+        std::string filename;
+    };
 
-        return true;
+    explicit AsyncTaskWriter(size_t maxPendingWrites) : queue_(maxPendingWrites), csvWriter_(true) {
+        thread_ = std::thread([this]() { run(); });
     }
 
-    bool writeMultipleSheets(const std::string& filename,
-                               const std::map<std::string, std::vector<DataRow>>& sheetData) override {
-        // CSV only supports single sheet, write first one
-        if (!sheetData.empty()) {
-            return writeExcelFile(filename + "_" + sheetData.begin()->first + ".csv",
-                              sheetData.begin()->second,
-                              sheetData.begin()->first);
-        }
-        return true;
+    ~AsyncTaskWriter() {
+        finish();
     }
 
-    bool appendToSheet(const std::string& filename,
-                        const std::vector<DataRow>& data,
-                        const std::string& sheetName,
-                        bool overwrite = false) override {
-        std::ios::openmode mode = std::ios::app;
-        if (overwrite) mode = std::ios::trunc;
-        std::ofstream file(filename, mode);
-        if (!file.is_open()) {
-            return false;
+    // Queues rows for filename (.xlsx goes to the native writer, anything else to CSV); blocks while the queue is full
+    void write(int taskId, const std::string& filename, const std::string& sheetName, std::vector<DataRow> rows, WriteMode mode) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++pending_;
         }
+        queue_.push(Job{ taskId, filename, sheetName, std::move(rows), mode });
+    }
 
-        // Write data
-        for (const auto& row : data) {
-            std::string line;
-            for (size_t i = 0; i < row.data.size(); ++i) {
-                if (i > 0) line += ",";
-                line += formatCellValue(row.data[i]);
-            }
-            file << line << std::endl;
-        }
+    // Answered once every write queued before it has reached the sink
+    bool isSheetEmpty(const std::string& filename, const std::string& sheetName) {
+        waitIdle();
+        return isXlsx(filename) ? xlsxWriter_.isSheetEmpty(filename, sheetName)
+                                : csvWriter_.isSheetEmpty(filename, sheetName);
+    }
 
-        return true;
+    // Waits for queued writes and returns the ones that failed since the last call
+    std::vector<Failure> takeFailures() {
+        waitIdle();
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<Failure> failures;
+        failures.swap(failures_);
+        return failures;
     }
 
-    bool isSheetEmpty(const std::string& filename, const std::string& sheetName) {
-        std::ifstream file(filename);
-        return file.peek() == std::ifstream::traits_type::eof();
+    // Waits for queued writes, then writes the open .xlsx workbooks to disk; returns those that failed
+    std::vector<std::string> saveWorkbooks() {
+        waitIdle();
+        std::vector<std::string> failedFiles;
+        xlsxWriter_.saveAll(failedFiles); // The worker is idle, so the writer is ours until the next write()
+        return failedFiles;
+    }
+
+    // Drains the queue, stops the thread and closes all destinations
+    void finish() {
+        if (!thread_.joinable()) return;
+        queue_.close();
+        thread_.join();
+        csvWriter_.closeAll();
+        xlsxWriter_.closeAll();
     }
 
 private:
-    std::string formatCellValue(const std::variant<std::string, int, double, bool, std::tm>& value) {
-        std::ostringstream oss;
-        std::visit([&oss](const auto& val) {
-            using ValType = std::decay_t<decltype(val)>;
-            if constexpr (std::is_same_v<ValType, std::string>) {
-                oss << "\"" << val << "\"";
-            } else if constexpr (std::is_same_v<ValType, bool>) {
-                oss << (val ? "true" : "false");
-            } else if constexpr (std::is_same_v<ValType, std::tm>) {
-                oss << std::put_time(&val, "%Y-%m-%d");
-            } else {
-                oss << val;
-            }
-        }, value);
-        return oss.str();
+    struct Job {
+        int taskId = 0;
+        std::string filename;
+        std::string sheetName;
+        std::vector<DataRow> rows;
+        WriteMode mode = WriteMode::Append;
+    };
+
+    static bool isXlsx(const std::string& filename) {
+        std::string ext = filename.substr(filename.find_last_of(".") + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == "xlsx";
+    }
+
+    void run() {
+        Job job;
+        while (queue_.pop(job)) {
+            ExcelWriter& writer = isXlsx(job.filename) ? static_cast<ExcelWriter&>(xlsxWriter_) : csvWriter_;
+            bool ok = job.mode == WriteMode::NewWorkbook
+                          ? writer.writeExcelFile(job.filename, job.rows, job.sheetName)
+                          : writer.appendToSheet(job.filename, job.rows, job.sheetName, job.mode == WriteMode::OverwriteSheet);
+            std::vector<DataRow>().swap(job.rows); // Release the chunk before waiting for the next one
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ok) failures_.push_back({ job.taskId, job.filename });
+            --pending_;
+            idle_.notify_all();
+        }
+    }
+
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]() { return pending_ == 0; });
     }
+
+    BoundedQueue<Job> queue_;
+    CSVExcelWriter csvWriter_;
+    XlsxExcelWriter xlsxWriter_;
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    size_t pending_ = 0;
+    std::vector<Failure> failures_;
 };
 
 // High Performance Data Processor
@@ -840,11 +1800,14 @@ public:
         // Given the "Empty Output" issue, let's assume we proceed with whatever combinations provided.
         // If empty, nothing happens, data remains.
 
-        // Parallel processing optimization
-        const size_t chunkSize = 10000; 
-        const size_t numThreads = std::thread::hardware_concurrency();
+        // Parallel processing optimization: every (combination, morsel of rows) pair is one work item on
+        // the core's scheduler. Morsels are whole bitmap words, so items never write the same word.
+        const size_t morselRows = 8192;
+        const size_t morselCount = (data.size() + morselRows - 1) / morselRows;
 
-        std::vector<std::future<std::vector<size_t>>> futures;
+        // Each combination's matches as a bitmap over the rows: bit i % 64 of word i / 64
+        using RowBitmap = std::vector<uint64_t>;
+        const size_t words = (data.size() + 63) / 64;
 
         // We need to determine if we are in "Keep" mode (Filter) or "Delete" mode.
         // This can be complex with multiple combinations.
@@ -856,44 +1819,58 @@ public:
         // For now, let's assume the primary use case is FILTER (Keep matches).
         // If any rule in a combination is DELETE, we treat that combination as a "Delete Signal".
 
+        // Rules are looked up by ID (the first rule with an ID wins) and compiled once per call; the
+        // compiled rules are read-only and shared by the combination workers
+        auto ruleEngine = createRuleEngine();
+        std::unordered_map<int, const Rule*> rulesById;
+        for (const auto& rule : rules) rulesById.emplace(rule.id, &rule);
+        std::unordered_map<int, std::unique_ptr<CompiledRule>> compiledRules;
+        std::map<int, std::vector<const CompiledRule*>> comboRules;
+        for (const auto& [comboId, ruleIds] : combinations) {
+            auto& compiled = comboRules[comboId];
+            for (int rid : ruleIds) {
+                auto it = rulesById.find(rid);
+                if (it == rulesById.end()) continue; // Unknown IDs are skipped
+                auto& rule = compiledRules[rid];
+                if (!rule) rule = ruleEngine->compileRule(*it->second);
+                compiled.push_back(rule.get());
+            }
+        }
+
         // Map comboId to type (true=Filter/Keep, false=Delete)
         std::map<int, bool> comboTypes;
         for (const auto& [comboId, ruleIds] : combinations) {
              bool isDelete = false;
              for(int rid : ruleIds) {
-                 if (rid > 0 && rid <= (int)rules.size()) {
-                     if (rules[rid-1].type == RuleType::DELETE_ROW) {
-                         isDelete = true;
-                         break;
-                     }
+                 auto it = rulesById.find(rid);
+                 if (it != rulesById.end() && it->second->type == RuleType::DELETE_ROW) {
+                     isDelete = true;
+                     break;
                  }
              }
              comboTypes[comboId] = !isDelete; // true = Keep, false = Delete
         }
 
-        for (const auto& [comboId, ruleIds] : combinations) {
-            futures.push_back(std::async(std::launch::async, [this, &data, &rules, ruleIds, chunkSize]() -> std::vector<size_t> {
-                std::vector<size_t> matchedIndices;
-
-                // Process in chunks
-                for (size_t start = 0; start < data.size(); start += chunkSize) {
-                    size_t end = std::min(start + chunkSize, data.size());
-
-                    // Process current chunk
-                    for (size_t i = start; i < end; ++i) {
-                        if (evaluateRuleCombination(data[i], rules, ruleIds)) {
-                            matchedIndices.push_back(i);
-                        }
+        std::vector<const std::vector<const CompiledRule*>*> comboList;
+        for (const auto& [comboId, compiled] : comboRules) comboList.push_back(&compiled);
+        std::vector<RowBitmap> comboMatches(comboList.size(), RowBitmap(words, 0));
+        TaskScheduler::shared().parallelFor(comboList.size() * morselCount, 1, [&](size_t first, size_t last) {
+            for (size_t item = first; item < last; ++item) {
+                const auto& compiled = *comboList[item / morselCount];
+                RowBitmap& matched = comboMatches[item / morselCount];
+                const size_t start = (item % morselCount) * morselRows;
+                const size_t end = std::min(start + morselRows, data.size());
+                for (size_t i = start; i < end; ++i) {
+                    if (evaluateRuleCombination(data[i], compiled)) {
+                        matched[i / 64] |= uint64_t(1) << (i % 64);
                     }
                 }
+            }
+        });
 
-                return matchedIndices;
-            }));
-        }
-
-        // Collect results
-        std::set<size_t> rowsToKeep;
-        std::set<size_t> rowsToDelete;
+        // Collect results: union of the keep and of the delete combinations, a word at a time
+        RowBitmap rowsToKeep(words, 0);
+        RowBitmap rowsToDelete(words, 0);
         
         bool hasFilterRules = false;
         bool hasDeleteRules = false;
@@ -904,57 +1881,45 @@ public:
             else hasDeleteRules = true;
         }
 
-        int futureIdx = 0;
+        int comboIdx = 0;
         int totalCombos = combinations.size();
         for (const auto& [comboId, ruleIds] : combinations) {
-            auto indices = futures[futureIdx++].get();
-            bool isKeep = comboTypes[comboId];
-            
-            for (size_t index : indices) {
-                if (isKeep) rowsToKeep.insert(index);
-                else rowsToDelete.insert(index);
-            }
+            const RowBitmap& matched = comboMatches[comboIdx++];
+            RowBitmap& rows = comboTypes[comboId] ? rowsToKeep : rowsToDelete;
+            for (size_t w = 0; w < words; ++w) rows[w] |= matched[w];
 
             if (progressCallback_) {
-                int p = (futureIdx * 100) / (totalCombos > 0 ? totalCombos : 1);
+                int p = (comboIdx * 100) / (totalCombos > 0 ? totalCombos : 1);
                 progressCallback_(p, "\xE5\xB7\xB2\xE5\xA4\x84\xE7\x90\x86\xE8\xA7\x84\xE5\x88\x99\xE7\xBB\x84\xE5\x90\x88 " + std::to_string(comboId));
             }
         }
 
-        // Construct new data
-        std::vector<DataRow> newData;
-        newData.reserve(data.size());
+        // Logic:
+        // 1. If there are Delete rules, and row matches any Delete rule -> Drop.
+        // 2. If there are Filter rules, and row matches NO Filter rule -> Drop.
+        // 3. If no rules at all? Keep.
+        // 4. If only Delete rules? Keep unless deleted.
+        // 5. If only Filter rules? Keep only if filtered.
+        RowBitmap keepRows(words, ~uint64_t(0));
+        for (size_t w = 0; w < words; ++w) {
+            if (hasFilterRules) keepRows[w] &= rowsToKeep[w];
+            if (hasDeleteRules) keepRows[w] &= ~rowsToDelete[w];
+        }
 
+        // Compact in place: kept rows move down over the dropped ones, in order
+        size_t kept = 0;
         for (size_t i = 0; i < data.size(); ++i) {
-            bool keep = true;
-
-            // Logic:
-            // 1. If there are Delete rules, and row matches any Delete rule -> Drop.
-            if (hasDeleteRules && rowsToDelete.count(i)) {
-                keep = false;
-            }
-            
-            // 2. If there are Filter rules, and row matches NO Filter rule -> Drop.
-            //    (Only if we haven't already dropped it)
-            if (keep && hasFilterRules && !rowsToKeep.count(i)) {
-                keep = false;
-            }
-
-            // 3. If no rules at all? Keep.
-            // 4. If only Delete rules? Keep unless deleted.
-            // 5. If only Filter rules? Keep only if filtered.
-
-            if (keep) {
-                newData.push_back(std::move(data[i]));
-                if (rowsToKeep.count(i)) {
+            if ((keepRows[i / 64] >> (i % 64)) & 1) {
+                if (kept != i) data[kept] = std::move(data[i]);
+                kept++;
+                if ((rowsToKeep[i / 64] >> (i % 64)) & 1) {
                     result.matchedRows++;
                 }
             } else {
                 result.deletedRows++;
             }
         }
-
-        data = std::move(newData);
+        data.erase(data.begin() + kept, data.end());
         result.processedRows = data.size();
 
         auto endTime = std::chrono::high_resolution_clock::now();
@@ -1018,19 +1983,11 @@ public:
 private:
     std::function<void(int, const std::string&)> progressCallback_;
 
-    bool evaluateRuleCombination(const DataRow& row,
-                               const std::vector<Rule>& rules,
-                               const std::vector<int>& ruleIds) {
-        // Get rule engine
-        auto ruleEngine = createRuleEngine();
-
+    bool evaluateRuleCombination(const DataRow& row, const std::vector<const CompiledRule*>& rules) const {
         // AND logic
-        for (int ruleId : ruleIds) {
-            if (ruleId > 0 && ruleId <= static_cast<int>(rules.size())) {
-                const Rule& rule = rules[ruleId - 1];
-                if (!ruleEngine->evaluateRule(rule, row, &rules)) {
-                    return false;
-                }
+        for (const CompiledRule* rule : rules) {
+            if (!rule->matches(row)) {
+                return false;
             }
         }
         return true;
@@ -1382,19 +2339,14 @@ ProcessingResult ExcelProcessorCore::processExcelFile(const std::string& inputFi
     auto processingStartTime = std::chrono::high_resolution_clock::now();
 
     // Determine reader type based on extension
-    std::string ext = inputFile.substr(inputFile.find_last_of(".") + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    
-    if (ext == "xlsx" || ext == "xls") {
-        reader_ = std::make_unique<ActiveQtExcelReader>();
-    } else {
-        reader_ = std::make_unique<CSVExcelReader>();
-    }
+    reader_ = createExcelReader(inputFile);
 
     if (logger_) reader_->setLogger(logger_);
 
     // Read input
-    if (!reader_->readExcelFile(inputFile, currentData_, sheetName)) {
+    bool read = reader_->readExcelFile(inputFile, currentData_, sheetName);
+    reader_->closeInput();
+    if (!read) {
         addError("Unable to read input file: " + inputFile);
         return result;
     }
@@ -1418,14 +2370,21 @@ ProcessingResult ExcelProcessorCore::processExcelFile(const std::string& inputFi
     std::string outExt = outputFile.substr(outputFile.find_last_of(".") + 1);
     std::transform(outExt.begin(), outExt.end(), outExt.begin(), ::tolower);
     
-    if (outExt == "xlsx" || outExt == "xls") {
+    if (outExt == "xlsx") {
+        writer_ = std::make_unique<XlsxExcelWriter>();
+    } else if (outExt == "xls") {
         writer_ = std::make_unique<ActiveQtExcelWriter>();
     } else {
         writer_ = std::make_unique<CSVExcelWriter>();
     }
 
-    // Write output
-    if (!writer_->writeExcelFile(outputFile, currentData_)) {
+    // Write output (the native .xlsx writer only puts the file on disk when it is saved)
+    bool written = writer_->writeExcelFile(outputFile, currentData_);
+    if (auto* xlsxWriter = dynamic_cast<XlsxExcelWriter*>(writer_.get())) {
+        std::vector<std::string> failedFiles;
+        written = xlsxWriter->saveAll(failedFiles) && written;
+    }
+    if (!written) {
         addError("Unable to write output file: " + outputFile);
     }
     
@@ -1444,18 +2403,13 @@ ProcessingResult ExcelProcessorCore::processExcelFile(const std::string& inputFi
 bool ExcelProcessorCore::loadFile(const std::string& filename, const std::string& sheetName, int maxRows, bool includeHeader) {
     std::lock_guard<std::mutex> lock(dataMutex_);
 
-    std::string ext = filename.substr(filename.find_last_of(".") + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-
-    if (ext == "xlsx" || ext == "xls") {
-        reader_ = std::make_unique<ActiveQtExcelReader>();
-    } else {
-        reader_ = std::make_unique<CSVExcelReader>();
-    }
+    reader_ = createExcelReader(filename);
 
     if (logger_) reader_->setLogger(logger_);
 
-    if (!reader_->readExcelFile(filename, currentData_, sheetName, maxRows, 0, includeHeader)) {
+    bool read = reader_->readExcelFile(filename, currentData_, sheetName, maxRows, 0, includeHeader);
+    reader_->closeInput();
+    if (!read) {
         addError("Unable to read file: " + filename);
         return false;
     }
@@ -1487,16 +2441,8 @@ bool ExcelProcessorCore::loadFile(const std::string& filename, const std::string
 }
 
 std::vector<std::string> ExcelProcessorCore::getSheetNames(const std::string& filename) {
-    std::unique_ptr<ExcelReader> tempReader;
-    std::string ext = filename.substr(filename.find_last_of(".") + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    std::unique_ptr<ExcelReader> tempReader = createExcelReader(filename);
 
-    if (ext == "xlsx" || ext == "xls") {
-        tempReader = std::make_unique<ActiveQtExcelReader>();
-    } else {
-        tempReader = std::make_unique<CSVExcelReader>();
-    }
-    
     if (logger_) tempReader->setLogger(logger_);
 
     std::vector<std::string> names;
@@ -1504,6 +2450,14 @@ std::vector<std::string> ExcelProcessorCore::getSheetNames(const std::string& fi
     return names;
 }
 
+int ExcelProcessorCore::inputFileOpenCount() const {
+    return reader_ ? reader_->fileOpenCount() : 0;
+}
+
+int64_t ExcelProcessorCore::ruleRowEvaluationCount() const {
+    return ruleRowEvaluations_;
+}
+
 void ExcelProcessorCore::setLogger(std::function<void(const std::string&)> logger) {
     logger_ = logger;
     if (reader_) {
@@ -1515,6 +2469,49 @@ void ExcelProcessorCore::setProgressCallback(std::function<void(int, const std::
     progressCallback_ = callback;
 }
 
+void ExcelProcessorCore::setPipelinedProcessing(bool enabled) {
+    pipelinedProcessing_ = enabled;
+}
+
+bool ExcelProcessorCore::isPipelinedProcessing() const {
+    return pipelinedProcessing_;
+}
+
+void ExcelProcessorCore::setThreadCount(int threads) {
+    TaskScheduler::shared().setThreadCount(static_cast<size_t>(std::max(0, threads)));
+}
+
+int ExcelProcessorCore::getThreadCount() {
+    return static_cast<int>(TaskScheduler::shared().threadCount());
+}
+
+std::vector<WorkerUtilization> ExcelProcessorCore::getWorkerUtilization() {
+    const TaskScheduler& scheduler = TaskScheduler::shared();
+    const double seconds = scheduler.statsSeconds();
+    std::vector<WorkerUtilization> utilization;
+    for (const auto& stats : scheduler.workerStats()) {
+        WorkerUtilization entry;
+        entry.morsels = stats.morsels;
+        entry.steals = stats.steals;
+        entry.busySeconds = stats.busySeconds;
+        entry.utilization = seconds > 0.0 ? stats.busySeconds / seconds : 0.0;
+        utilization.push_back(entry);
+    }
+    return utilization;
+}
+
+void ExcelProcessorCore::resetWorkerUtilization() {
+    TaskScheduler::shared().resetStats();
+}
+
+void ExcelProcessorCore::setConcurrentFiles(int files) {
+    concurrentFiles_ = std::max(0, files);
+}
+
+int ExcelProcessorCore::getConcurrentFiles() const {
+    return concurrentFiles_;
+}
+
 bool ExcelProcessorCore::previewResults(const std::string& inputFile, const std::string& sheetName, int maxPreviewRows) {
     if (logger_) logger_("Previewing file: " + inputFile + ", Sheet: " + (sheetName.empty() ? "Default" : sheetName) + ", Max Rows: " + std::to_string(maxPreviewRows));
     
@@ -2012,6 +3009,189 @@ ProcessingResult ExcelProcessorCore::processTask(int taskId) {
     return result;
 }
 
+// Whether the task's filename pattern selects inputFile (a task without one takes any file)
+static bool taskTakesInputFile(const ProcessingTask& task, const std::string& inputFile) {
+    if (task.inputFilenamePattern.empty()) return true;
+    QString qPattern = QString::fromStdString(task.inputFilenamePattern);
+    QFileInfo patternInfo(qPattern);
+    if (patternInfo.isAbsolute()) {
+        QString absInput = QFileInfo(QString::fromStdString(inputFile)).absoluteFilePath();
+        return absInput.compare(patternInfo.absoluteFilePath(), Qt::CaseInsensitive) == 0;
+    }
+    QRegExp rx(qPattern, Qt::CaseInsensitive, QRegExp::Wildcard);
+    return rx.exactMatch(QFileInfo(QString::fromStdString(inputFile)).fileName());
+}
+
+struct TaskOutputTarget {
+    std::string file;               // Empty when a New Sheet task has neither an output nor an input file
+    std::string sheet = "Sheet1";
+    std::string ext;                // Lowercased; "xlsx" for a name without one
+};
+
+// Where the task writes what it reads from inputFile: New Sheet mode adds a sheet to the output file (or
+// to the input file without one), New Workbook mode writes the named workbook next to it
+static TaskOutputTarget taskOutputTarget(const ProcessingTask& task, const std::string& inputFile, const std::string& defaultOutputFile) {
+    TaskOutputTarget target;
+    if (task.outputMode == OutputMode::NEW_SHEET) {
+        target.file = defaultOutputFile.empty() ? inputFile : defaultOutputFile;
+        target.sheet = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
+    } else {
+        std::string name = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
+        if (QFileInfo(QString::fromStdString(name)).isRelative()) {
+            const std::string& base = defaultOutputFile.empty() ? inputFile : defaultOutputFile;
+            target.file = QFileInfo(QString::fromStdString(base)).absolutePath().toStdString() + "/" + name;
+        } else {
+            target.file = name;
+        }
+    }
+    if (target.file.empty()) return target;
+
+    // Normalize extension
+    target.ext = target.file.substr(target.file.find_last_of(".") + 1);
+    std::transform(target.ext.begin(), target.ext.end(), target.ext.begin(), ::tolower);
+    if (target.ext == target.file) { target.file += ".xlsx"; target.ext = "xlsx"; }
+    return target;
+}
+
+// Files a run over inputFile reads or writes: the input itself and the destination of every enabled task
+// that takes it, resolved as the task loop does, as lowercased absolute paths
+static std::set<std::string> filesTouchedBy(const std::vector<ProcessingTask>& tasks, const std::string& inputFile, const std::string& defaultOutputFile) {
+    auto absolute = [](const std::string& file) {
+        return QFileInfo(QString::fromStdString(file)).absoluteFilePath().toLower().toStdString();
+    };
+
+    std::set<std::string> touched = { absolute(inputFile) };
+    for (const auto& task : tasks) {
+        if (!task.enabled || task.outputMode == OutputMode::NONE || !taskTakesInputFile(task, inputFile)) continue;
+
+        std::string targetFile = taskOutputTarget(task, inputFile, defaultOutputFile).file;
+        if (!targetFile.empty()) touched.insert(absolute(targetFile));
+    }
+    return touched;
+}
+
+// Each file runs in its own ExcelProcessorCore on one of a few file threads; the rows inside a file
+// still go through the shared scheduler. A file waits for every earlier file it shares an input or
+// output with, so a destination is written by one file at a time, in the order of a serial run, and
+// the results, errors and warnings are gathered in file order.
+std::vector<ProcessingResult> ExcelProcessorCore::processFilesConcurrently(const std::vector<ProcessingTask>& tasksToProcess, const std::vector<std::string>& files, const std::string& defaultOutputFile, const std::string& sheetName) {
+    const size_t fileCount = files.size();
+    std::vector<std::vector<size_t>> waitsFor(fileCount);
+    {
+        std::vector<std::set<std::string>> touched;
+        for (const auto& file : files) touched.push_back(filesTouchedBy(tasksToProcess, file, defaultOutputFile));
+        for (size_t i = 0; i < fileCount; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                bool shared = std::any_of(touched[i].begin(), touched[i].end(),
+                                          [&](const std::string& file) { return touched[j].count(file) > 0; });
+                if (shared) waitsFor[i].push_back(j);
+            }
+        }
+    }
+
+    enum class FileState { Waiting, Running, Done };
+    std::vector<FileState> states(fileCount, FileState::Waiting);
+    std::mutex stateMutex;
+    std::condition_variable stateChanged;
+    std::mutex callbackMutex; // The logger and progress callback are called by one file at a time
+    std::atomic<size_t> filesDone{ 0 };
+    // Progress is reported as rows done over all files, like a single file's row offset. Guarded by callbackMutex.
+    std::vector<int> fileOffsets(fileCount, 0); // Last offset each file reported; it restarts with every sheet
+    int64_t rowsDone = 0;
+
+    std::vector<std::vector<ProcessingResult>> fileResults(fileCount);
+    std::vector<std::vector<std::string>> fileErrors(fileCount);
+    std::vector<std::vector<std::string>> fileWarnings(fileCount);
+    std::vector<int64_t> fileEvaluations(fileCount, 0);
+    const std::vector<Rule> rules = getRules();
+
+    auto processFile = [&](size_t index) {
+        const std::string fileName = QFileInfo(QString::fromStdString(files[index])).fileName().toStdString();
+        const std::string prefix = "[" + std::to_string(index + 1) + "/" + std::to_string(fileCount) + " " + fileName + "] ";
+
+        ExcelProcessorCore fileCore;
+        fileCore.rules_ = rules;
+        fileCore.pipelinedProcessing_ = pipelinedProcessing_;
+        if (logger_) {
+            fileCore.logger_ = [this, &callbackMutex, prefix](const std::string& msg) {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                logger_(prefix + msg);
+            };
+        }
+        if (progressCallback_) {
+            fileCore.progressCallback_ = [this, &callbackMutex, &fileOffsets, &rowsDone, index, prefix](int rows, const std::string& msg) {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                int& last = fileOffsets[index];
+                rowsDone += rows >= last ? rows - last : rows;
+                last = rows;
+                progressCallback_(static_cast<int>(rowsDone), prefix + msg);
+            };
+        }
+
+        try {
+            fileResults[index] = fileCore.processTasksInternal(tasksToProcess, files[index], defaultOutputFile, sheetName);
+        } catch (const std::exception& e) {
+            fileCore.addError("Error processing file " + files[index] + ": " + e.what());
+        }
+        fileErrors[index] = fileCore.getErrors();
+        fileWarnings[index] = fileCore.getWarnings();
+        fileEvaluations[index] = fileCore.ruleRowEvaluations_;
+
+        size_t done = ++filesDone;
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        std::string msg = "Finished file " + std::to_string(done) + "/" + std::to_string(fileCount) + ": " + fileName;
+        if (progressCallback_) progressCallback_(static_cast<int>(rowsDone), msg);
+        if (logger_) logger_(msg);
+    };
+
+    // Each thread takes the first waiting file whose earlier neighbours are done
+    auto fileThread = [&]() {
+#ifdef _WIN32
+        CoInitialize(nullptr); // ActiveQt readers and writers are created on this thread
+#endif
+        std::unique_lock<std::mutex> lock(stateMutex);
+        for (;;) {
+            size_t next = fileCount;
+            bool anyWaiting = false;
+            for (size_t i = 0; i < fileCount && next == fileCount; ++i) {
+                if (states[i] != FileState::Waiting) continue;
+                anyWaiting = true;
+                if (std::all_of(waitsFor[i].begin(), waitsFor[i].end(), [&](size_t j) { return states[j] == FileState::Done; })) next = i;
+            }
+            if (!anyWaiting) break;
+            if (next == fileCount) {
+                stateChanged.wait(lock);
+                continue;
+            }
+            states[next] = FileState::Running;
+            lock.unlock();
+            processFile(next);
+            lock.lock();
+            states[next] = FileState::Done;
+            stateChanged.notify_all();
+        }
+#ifdef _WIN32
+        CoUninitialize();
+#endif
+    };
+
+    size_t threadCount = concurrentFiles_ > 0 ? static_cast<size_t>(concurrentFiles_)
+                                              : std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < std::min(threadCount, fileCount); ++t) threads.emplace_back(fileThread);
+    for (auto& thread : threads) thread.join();
+
+    std::vector<ProcessingResult> allResults;
+    ruleRowEvaluations_ = 0;
+    for (size_t i = 0; i < fileCount; ++i) {
+        allResults.insert(allResults.end(), fileResults[i].begin(), fileResults[i].end());
+        for (const auto& error : fileErrors[i]) addError(error);
+        for (const auto& warning : fileWarnings[i]) addWarning(warning);
+        ruleRowEvaluations_ += fileEvaluations[i];
+    }
+    return allResults;
+}
+
 std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std::vector<ProcessingTask>& tasksToProcess, const std::string& inputFile, const std::string& defaultOutputFile, const std::string& sheetName) {
     // Dispatcher Mode: If inputFile is empty, scan for files based on enabled tasks
     if (inputFile.empty()) {
@@ -2069,6 +3249,13 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
              return allResults;
         }
         
+        size_t concurrentFiles = concurrentFiles_ > 0 ? static_cast<size_t>(concurrentFiles_)
+                                                      : std::max<size_t>(1, std::thread::hardware_concurrency());
+        if (concurrentFiles > 1 && uniqueFiles.size() > 1) {
+            std::vector<std::string> files(uniqueFiles.begin(), uniqueFiles.end());
+            return processFilesConcurrently(tasksToProcess, files, defaultOutputFile, sheetName);
+        }
+
         // Process each unique file sequentially
         for (const auto& file : uniqueFiles) {
             // Call processTasks with specific file (will lock internally)
@@ -2090,9 +3277,16 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         return results;
     }
     
+    // One reader serves the whole run. It keeps the input's workbook metadata between calls, so listing
+    // the sheets and opening each sheet's cursor parse the file (or open it in Excel) only once.
+    reader_ = createExcelReader(inputFile);
+
+    if (logger_) reader_->setLogger(logger_);
+
     // Determine sheets to process
     // Get actual sheets for validation
-    std::vector<std::string> actualSheets = getSheetNames(inputFile);
+    std::vector<std::string> actualSheets;
+    reader_->getSheetNames(inputFile, actualSheets);
     
     std::vector<std::string> sheetsToProcess;
     if (sheetName.empty()) {
@@ -2120,27 +3314,10 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         sheetsToProcess.push_back(sheetName);
     }
 
-    // Determine reader based on input file extension for robustness
-    std::string ext = inputFile.substr(inputFile.find_last_of(".") + 1);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    
-    if (ext == "xlsx" || ext == "xls") {
-        reader_ = std::make_unique<ActiveQtExcelReader>();
-    } else {
-        reader_ = std::make_unique<CSVExcelReader>();
-    }
-
-    if (logger_) reader_->setLogger(logger_);
-
     auto tasks = tasksToProcess;
     auto rules = getRules(); // Thread-safe copy
 
-    auto findRule = [&rules](int id) -> const Rule* {
-        for (const auto& r : rules) {
-            if (r.id == id) return &r;
-        }
-        return nullptr;
-    };
+    ruleRowEvaluations_ = 0;
 
     // Calculate actual active tasks for progress calculation
     int activeTaskCount = 0;
@@ -2159,23 +3336,7 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         if (!task.enabled) continue;
         
         // Check if task applies to this file (filename pattern)
-        bool fileMatches = true;
-        if (!task.inputFilenamePattern.empty()) {
-            QString qInputFile = QFileInfo(QString::fromStdString(inputFile)).fileName();
-            QString qPattern = QString::fromStdString(task.inputFilenamePattern);
-            QFileInfo patternInfo(qPattern);
-
-            if (patternInfo.isAbsolute()) {
-                 QString absInput = QFileInfo(QString::fromStdString(inputFile)).absoluteFilePath();
-                 QString absPattern = patternInfo.absoluteFilePath();
-                 if (absInput.compare(absPattern, Qt::CaseInsensitive) != 0) fileMatches = false;
-            } else {
-                QRegExp rx(qPattern, Qt::CaseInsensitive, QRegExp::Wildcard);
-                if (!rx.exactMatch(qInputFile)) fileMatches = false;
-            }
-        }
-        
-        if (fileMatches) {
+        if (taskTakesInputFile(task, inputFile)) {
             anyTaskMatchesFile = true;
             if (task.inputSheetName.empty()) {
                 processAllSheets = true;
@@ -2224,6 +3385,29 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         sheetsToProcess = filteredSheets;
     }
 
+    // CSV destinations are opened once for the whole run and closed after the last chunk.
+    // In pipelined mode they (and native .xlsx output) are written by a background thread while the
+    // next chunk is evaluated; the queue holds about two chunks of output per task so memory stays bounded.
+    CSVExcelWriter sharedCsvWriter(true);
+    std::unique_ptr<AsyncTaskWriter> asyncWriter;
+    if (pipelinedProcessing_) {
+        asyncWriter = std::make_unique<AsyncTaskWriter>(2 * activeTaskCount);
+    }
+
+    // .xlsx destinations that do not exist yet, or that NEW_WORKBOOK replaces, are written natively and
+    // stay native for the rest of the run. Existing workbooks are still appended to through Excel, which
+    // keeps their formatting and formulas.
+    std::set<std::string> nativeXlsxTargets;
+    auto writesNativeXlsx = [&nativeXlsxTargets](const std::string& file, bool replacesWorkbook) {
+        if (nativeXlsxTargets.count(file)) return true;
+        if (!replacesWorkbook && QFile::exists(QString::fromStdString(file))) return false;
+        nativeXlsxTargets.insert(file);
+        return true;
+    };
+    // Native .xlsx output stays open across sheets and is written to disk once, after the last sheet
+    XlsxExcelWriter sharedXlsxWriter;
+    std::map<std::string, std::set<size_t>> xlsxTargetResults; // Native .xlsx destination -> entries of results writing to it
+
     for (const auto& currentSheet : sheetsToProcess) {
         // Store results for this sheet: TaskID -> ProcessingResult
         std::map<int, ProcessingResult> sheetTaskResults;
@@ -2234,20 +3418,7 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
             if (!task.enabled) continue;
             
             // Filter by Input Filename (Multi-workbook support)
-            if (!task.inputFilenamePattern.empty()) {
-                QString qInputFile = QFileInfo(QString::fromStdString(inputFile)).fileName();
-                QString qPattern = QString::fromStdString(task.inputFilenamePattern);
-                QFileInfo patternInfo(qPattern);
-
-                if (patternInfo.isAbsolute()) {
-                     QString absInput = QFileInfo(QString::fromStdString(inputFile)).absoluteFilePath();
-                     QString absPattern = patternInfo.absoluteFilePath();
-                     if (absInput.compare(absPattern, Qt::CaseInsensitive) != 0) continue;
-                } else {
-                    QRegExp rx(qPattern, Qt::CaseInsensitive, QRegExp::Wildcard);
-                    if (!rx.exactMatch(qInputFile)) continue;
-                }
-            }
+            if (!taskTakesInputFile(task, inputFile)) continue;
 
             // Filter by Input Sheet Name (Multi-workbook support)
             if (!task.inputSheetName.empty()) {
@@ -2259,6 +3430,39 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
             taskHasStarted[task.id] = false;
         }
 
+        // The rules this sheet's tasks reference are compiled into one set (as with a linear search of
+        // rules, the first rule with a given id wins) and each task's references resolved to positions in it
+        std::set<int> referencedRuleIds;
+        for (const auto& task : tasks) {
+            if (!sheetTaskResults.count(task.id)) continue;
+            referencedRuleIds.insert(task.excludeRuleIds.begin(), task.excludeRuleIds.end());
+            for (const auto& ruleEntry : task.rules) {
+                referencedRuleIds.insert(ruleEntry.ruleId);
+                referencedRuleIds.insert(ruleEntry.excludeRuleIds.begin(), ruleEntry.excludeRuleIds.end());
+            }
+        }
+        std::vector<Rule> sheetRules;
+        std::set<int> compiledRuleIds;
+        for (const auto& r : rules) {
+            if (referencedRuleIds.count(r.id) && compiledRuleIds.insert(r.id).second) sheetRules.push_back(r);
+        }
+        std::unique_ptr<CompiledRuleSet> sheetRuleSet = ruleEngine_->compileRuleSet(sheetRules);
+
+        std::map<int, TaskRuleIndices> taskRuleIndices;
+        for (const auto& task : tasks) {
+            if (!sheetTaskResults.count(task.id)) continue;
+            TaskRuleIndices& indices = taskRuleIndices[task.id];
+            indices.logic = task.ruleLogic;
+            for (const auto& ruleEntry : task.rules) {
+                std::vector<int> excludes;
+                for (int exId : ruleEntry.excludeRuleIds) excludes.push_back(sheetRuleSet->ruleIndex(exId));
+                indices.entries.push_back({ sheetRuleSet->ruleIndex(ruleEntry.ruleId), std::move(excludes) });
+            }
+            for (int exId : task.excludeRuleIds) indices.excludes.push_back(sheetRuleSet->ruleIndex(exId));
+        }
+        ChunkRuleBitmaps chunkRules;
+        ChunkRuleBitmaps::Bitmap taskRows;
+
         if (logger_) {
             std::string displaySheet = currentSheet.empty() ? "[Default Sheet]" : currentSheet;
             std::string msg = "\xE5\xBC\x80\xE5\xA7\x8B\xE5\xA4\x84\xE7\x90\x86\xE6\x96\x87\xE4\xBB\xB6: " + inputFile + " | \xE5\xB7\xA5\xE4\xBD\x9C\xE8\xA1\xA8: " + displaySheet + " | \xE5\x8C\xB9\xE9\x85\x8D\xE4\xBB\xBB\xE5\x8A\xA1\xE6\x95\xB0: " + std::to_string(sheetTaskResults.size()); 
@@ -2272,22 +3476,14 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
                     if (!task.enabled) continue;
                     std::string taskInfo = "Task '" + task.taskName + "' mismatch: ";
                     
-                    if (!task.inputFilenamePattern.empty()) {
-                        QString qInputFile = QFileInfo(QString::fromStdString(inputFile)).fileName();
-                        QString qPattern = QString::fromStdString(task.inputFilenamePattern);
-                        QFileInfo patternInfo(qPattern);
+                    if (!taskTakesInputFile(task, inputFile)) {
+                        QFileInfo inputInfo(QString::fromStdString(inputFile));
+                        QFileInfo patternInfo(QString::fromStdString(task.inputFilenamePattern));
 
                         if (patternInfo.isAbsolute()) {
-                             QString absInput = QFileInfo(QString::fromStdString(inputFile)).absoluteFilePath();
-                             QString absPattern = patternInfo.absoluteFilePath();
-                             if (absInput.compare(absPattern, Qt::CaseInsensitive) != 0) {
-                                 taskInfo += "File Absolute Path Mismatch (Input: " + absInput.toStdString() + " vs Pattern: " + absPattern.toStdString() + "); ";
-                             }
+                            taskInfo += "File Absolute Path Mismatch (Input: " + inputInfo.absoluteFilePath().toStdString() + " vs Pattern: " + patternInfo.absoluteFilePath().toStdString() + "); ";
                         } else {
-                            QRegExp rx(qPattern, Qt::CaseInsensitive, QRegExp::Wildcard);
-                            if (!rx.exactMatch(qInputFile)) {
-                                taskInfo += "Filename Wildcard Mismatch (Input: " + qInputFile.toStdString() + " vs Pattern: " + qPattern.toStdString() + "); ";
-                            }
+                            taskInfo += "Filename Wildcard Mismatch (Input: " + inputInfo.fileName().toStdString() + " vs Pattern: " + task.inputFilenamePattern + "); ";
                         }
                     }
 
@@ -2308,10 +3504,34 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         bool isFirstChunk = true;
         
         ActiveQtExcelWriter sharedQtWriter; // Persistent writer for this file processing
+        std::map<std::string, std::set<int>> xlsxTargetTasks; // Native .xlsx destination -> this sheet's tasks writing to it
 
         auto sheetStartTime = std::chrono::high_resolution_clock::now();
 
-        while (true) {
+        // Determine if we need to read header
+        bool includeHeader = false;
+        for (const auto& task : tasks) {
+            if (task.enabled && task.useHeader) {
+                includeHeader = true;
+                break;
+            }
+        }
+
+        // Open the sheet once; the cursor keeps its position between chunks
+        std::unique_ptr<ChunkCursor> cursor = reader_->openChunkCursor(inputFile, currentSheet, includeHeader);
+        if (!cursor) {
+            std::string err = "Unable to read input file: " + inputFile + " (Sheet: " + (currentSheet.empty() ? "Default" : currentSheet) + ")";
+            addError(err);
+            if (logger_) logger_("ERROR: " + err);
+        }
+
+        // Pipelined mode reads up to two chunks ahead while the current one is evaluated
+        std::unique_ptr<ChunkPrefetcher> prefetcher;
+        if (cursor && pipelinedProcessing_ && cursor->supportsBackgroundRead()) {
+            prefetcher = std::make_unique<ChunkPrefetcher>(*cursor, chunkSize, 2);
+        }
+
+        while (cursor) {
             currentData_.clear();
             
             // Notify Progress (Before Read)
@@ -2319,21 +3539,23 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
                 progressCallback_(offset, "Reading " + currentSheet + " (Row " + std::to_string(offset) + ")...");
             }
 
-            // Determine if we need to read header
-            // Calculate for every chunk to ensure correct offset calculation in reader
-            bool includeHeader = false;
-            for (const auto& task : tasks) {
-                  if (task.enabled && task.useHeader) {
-                      includeHeader = true;
-                      break;
-                  }
-             }
-
              if (logger_) {
                  logger_("[DEBUG] Chunk: Offset=" + std::to_string(offset) + " | HeaderReq=" + (includeHeader ? "YES" : "NO"));
              }
 
-             if (!reader_->readExcelFile(inputFile, currentData_, currentSheet, chunkSize, offset, includeHeader)) {
+             bool readOk = false;
+             bool isLastChunk = false;
+             if (prefetcher) {
+                 ChunkPrefetcher::Chunk chunk;
+                 readOk = prefetcher->next(chunk) && chunk.ok;
+                 currentData_.swap(chunk.rows);
+                 isLastChunk = chunk.atEnd;
+             } else {
+                 readOk = cursor->readNextChunk(currentData_, chunkSize);
+                 isLastChunk = cursor->atEnd();
+             }
+
+             if (!readOk) {
                 std::string err = "Unable to read input file: " + inputFile + " (Sheet: " + (currentSheet.empty() ? "Default" : currentSheet) + ")";
                 if (isFirstChunk) {
                     addError(err);
@@ -2372,6 +3594,7 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
             // dataProcessor_->optimizeProcessing(currentData_); // DISABLED: This sorts data and breaks header position
 
             // Process this chunk for each applicable task
+            chunkRules.reset(*sheetRuleSet, currentData_);
             for (const auto& task : tasks) {
                 if (sheetTaskResults.find(task.id) == sheetTaskResults.end()) continue;
 
@@ -2409,152 +3632,65 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
                         shouldWriteHeader = true;
                     } else {
                         // Check if target sheet/file is empty
-                        std::string targetFile;
-                        std::string targetSheet = "Sheet1";
-
-                        if (task.outputMode == OutputMode::NEW_SHEET) {
-                            targetFile = defaultOutputFile;
-                            if (targetFile.empty()) targetFile = inputFile;
-                            targetSheet = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
-                        } else {
-                            // NEW_WORKBOOK
-                            std::string name = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
-                            QFileInfo fileInfo(QString::fromStdString(name));
-                            if (fileInfo.isRelative()) {
-                                std::string baseDir;
-                                if (!defaultOutputFile.empty()) {
-                                    baseDir = QFileInfo(QString::fromStdString(defaultOutputFile)).absolutePath().toStdString();
-                                } else {
-                                    baseDir = QFileInfo(QString::fromStdString(inputFile)).absolutePath().toStdString();
-                                }
-                                targetFile = baseDir + "/" + name;
-                            } else {
-                                targetFile = name;
-                            }
-                        }
-
-                        // Normalize extension
-                        std::string ext = targetFile.substr(targetFile.find_last_of(".") + 1);
-                        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                        if (ext == targetFile) { targetFile += ".xlsx"; ext = "xlsx"; }
-
-                        if (ext == "xlsx" || ext == "xls") {
+                        TaskOutputTarget target = taskOutputTarget(task, inputFile, defaultOutputFile);
+                        const std::string& targetFile = target.file;
+                        const std::string& targetSheet = target.sheet;
+                        const std::string& ext = target.ext;
+
+                        if (ext == "xlsx" && writesNativeXlsx(targetFile, false)) {
+                             shouldWriteHeader = asyncWriter ? asyncWriter->isSheetEmpty(targetFile, targetSheet)
+                                                             : sharedXlsxWriter.isSheetEmpty(targetFile, targetSheet);
+                        } else if (ext == "xlsx" || ext == "xls") {
                              shouldWriteHeader = sharedQtWriter.isSheetEmpty(targetFile, targetSheet);
+                        } else if (asyncWriter) {
+                             shouldWriteHeader = asyncWriter->isSheetEmpty(targetFile, targetSheet);
                         } else {
-                             CSVExcelWriter csv;
-                             shouldWriteHeader = csv.isSheetEmpty(targetFile, targetSheet);
+                             shouldWriteHeader = sharedCsvWriter.isSheetEmpty(targetFile, targetSheet);
                         }
                     }
                 }
                 
-                int processedRowsInChunk = 0;
-                
-                int rowIdx = 0;
-                for (const auto& row : currentData_) {
-                    bool isHeaderRow = (isFirstChunk && includeHeader && rowIdx == 0);
-                    
-                    if (isHeaderRow) {
-                         if (shouldWriteHeader) {
-                             taskData.push_back(row);
-                             if (logger_ && task.useHeader) {
-                                  std::string hStr;
-                                  for(const auto& c : row.data) {
-                                      std::string valStr = std::visit([](auto&& arg) -> std::string {
-                                          using T = std::decay_t<decltype(arg)>;
-                                          if constexpr (std::is_same_v<T, std::string>) return arg;
-                                          else if constexpr (std::is_same_v<T, int>) return std::to_string(arg);
-                                          else if constexpr (std::is_same_v<T, double>) return std::to_string(arg);
-                                          else if constexpr (std::is_same_v<T, bool>) return arg ? "TRUE" : "FALSE";
-                                          else if constexpr (std::is_same_v<T, std::tm>) {
-                                              char buf[64];
-                                              std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &arg);
-                                              return buf;
-                                          }
-                                          return "";
-                                      }, c);
-                                      hStr += valStr + " | ";
-                                  }
-                                  // "Writing Header"
-                                  logger_(std::string("[DEBUG] \xE5\x86\x99\xE5\x85\xA5\xE8\xA1\xA8\xE5\xA4\xB4: ") + hStr);
-                                  // "Header Consistency Check: PASSED (Output Header == Input Header)"
-                                  logger_(std::string("[DEBUG] \xE8\xA1\xA8\xE5\xA4\xB4\xE4\xB8\x80\xE8\x87\xB4\xE6\x80\xA7\xE6\xA3\x80\xE6\xB5\x8B: \xE9\x80\x9A\xE8\xBF\x87 (\xE8\xBE\x93\xE5\x87\xBA\xE8\xA1\xA8\xE5\xA4\xB4 == \xE8\xBE\x93\xE5\x85\xA5\xE8\xA1\xA8\xE5\xA4\xB4)"));
-                              }
-                         } else {
-                             if (logger_ && task.useHeader) {
-                                 // "SKIPPING Header Write. Reason: Target sheet not empty or overwrite disabled."
-                                 logger_(std::string("[DEBUG] \xE8\xB7\xB3\xE8\xBF\x87\xE8\xA1\xA8\xE5\xA4\xB4\xE5\x86\x99\xE5\x85\xA5\xE3\x80\x82\xE5\x8E\x9F\xE5\x9B\xA0: \xE7\x9B\xAE\xE6\xA0\x87\xE5\xB7\xA5\xE4\xBD\x9C\xE8\xA1\xA8\xE9\x9D\x9E\xE7\xA9\xBA \xE6\x88\x96 \xE6\x9C\xAA\xE5\x90\xAF\xE7\x94\xA8\xE8\xA6\x86\xE7\x9B\x96\xE6\xA8\xA1\xE5\xBC\x8F\xE3\x80\x82"));
+                chunkRules.taskRows(taskRuleIndices[task.id], taskRows);
+
+                // The header row is written as is (or not at all) and never counted as a match
+                if (isFirstChunk && includeHeader) {
+                    if (shouldWriteHeader) {
+                        taskData.push_back(currentData_[0]);
+                        if (logger_ && task.useHeader) {
+                             std::string hStr;
+                             for(const auto& c : currentData_[0].data) {
+                                 std::string valStr = std::visit([](auto&& arg) -> std::string {
+                                     using T = std::decay_t<decltype(arg)>;
+                                     if constexpr (std::is_same_v<T, std::string>) return arg;
+                                     else if constexpr (std::is_same_v<T, int>) return std::to_string(arg);
+                                     else if constexpr (std::is_same_v<T, double>) return std::to_string(arg);
+                                     else if constexpr (std::is_same_v<T, bool>) return arg ? "TRUE" : "FALSE";
+                                     else if constexpr (std::is_same_v<T, CellDate>) {
+                                         std::tm tm = arg.toTm();
+                                         char buf[64];
+                                         std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+                                         return buf;
+                                     }
+                                     return "";
+                                 }, c);
+                                 hStr += valStr + " | ";
                              }
+                             // "Writing Header"
+                             logger_(std::string("[DEBUG] \xE5\x86\x99\xE5\x85\xA5\xE8\xA1\xA8\xE5\xA4\xB4: ") + hStr);
+                             // "Header Consistency Check: PASSED (Output Header == Input Header)"
+                             logger_(std::string("[DEBUG] \xE8\xA1\xA8\xE5\xA4\xB4\xE4\xB8\x80\xE8\x87\xB4\xE6\x80\xA7\xE6\xA3\x80\xE6\xB5\x8B: \xE9\x80\x9A\xE8\xBF\x87 (\xE8\xBE\x93\xE5\x87\xBA\xE8\xA1\xA8\xE5\xA4\xB4 == \xE8\xBE\x93\xE5\x85\xA5\xE8\xA1\xA8\xE5\xA4\xB4)"));
                          }
-                         rowIdx++;
-                         continue;
-                    }
-                    
-                    bool include = false;
-                    
-                    // Check Inclusion (AND/OR logic)
-                    if (task.rules.empty()) {
-                        include = true; // Default include all
                     } else {
-                        if (task.ruleLogic == RuleLogic::OR) {
-                            include = false;
-                            for (const auto& ruleEntry : task.rules) {
-                                const Rule* rule = findRule(ruleEntry.ruleId);
-                                if (rule && ruleEngine_->evaluateRule(*rule, row, &rules)) {
-                                    bool granularExcluded = false;
-                                    if (!ruleEntry.excludeRuleIds.empty()) {
-                                        for (int exId : ruleEntry.excludeRuleIds) {
-                                            const Rule* exRule = findRule(exId);
-                                            if (exRule && ruleEngine_->evaluateRule(*exRule, row, &rules)) {
-                                                granularExcluded = true;
-                                                break;
-                                            }
-                                        }
-                                    }
-                                    if (!granularExcluded) {
-                                        include = true;
-                                        break; 
-                                    }
-                                }
-                            }
-                        } else { // AND logic
-                            include = true;
-                            for (const auto& ruleEntry : task.rules) {
-                                const Rule* rule = findRule(ruleEntry.ruleId);
-                                bool matched = (rule && ruleEngine_->evaluateRule(*rule, row, &rules));
-                                if (matched) {
-                                    for (int exId : ruleEntry.excludeRuleIds) {
-                                        const Rule* exRule = findRule(exId);
-                                        if (exRule && ruleEngine_->evaluateRule(*exRule, row, &rules)) {
-                                            matched = false;
-                                            break;
-                                        }
-                                    }
-                                }
-                                if (!matched) {
-                                    include = false;
-                                    break; 
-                                }
-                            }
-                        }
-                    }
-
-                    // Check Exclusion (Global Exclusion)
-                    if (include && !task.excludeRuleIds.empty()) {
-                        for (int ruleId : task.excludeRuleIds) {
-                            const Rule* rule = findRule(ruleId);
-                            if (rule && ruleEngine_->evaluateRule(*rule, row, &rules)) {
-                                include = false;
-                                break; 
-                            }
+                        if (logger_ && task.useHeader) {
+                            // "SKIPPING Header Write. Reason: Target sheet not empty or overwrite disabled."
+                            logger_(std::string("[DEBUG] \xE8\xB7\xB3\xE8\xBF\x87\xE8\xA1\xA8\xE5\xA4\xB4\xE5\x86\x99\xE5\x85\xA5\xE3\x80\x82\xE5\x8E\x9F\xE5\x9B\xA0: \xE7\x9B\xAE\xE6\xA0\x87\xE5\xB7\xA5\xE4\xBD\x9C\xE8\xA1\xA8\xE9\x9D\x9E\xE7\xA9\xBA \xE6\x88\x96 \xE6\x9C\xAA\xE5\x90\xAF\xE7\x94\xA8\xE8\xA6\x86\xE7\x9B\x96\xE6\xA8\xA1\xE5\xBC\x8F\xE3\x80\x82"));
                         }
                     }
-
-                    if (include) {
-                        taskData.push_back(row);
-                        processedRowsInChunk++;
-                    }
-                    rowIdx++;
+                    taskRows[0] &= ~uint64_t(1);
                 }
+
+                // Matching rows are copied in row order on the core's scheduler
+                int processedRowsInChunk = static_cast<int>(chunkRules.appendRows(taskRows, taskData));
                 
                 // Update stats
                 result.totalRows += currentData_.size();
@@ -2569,68 +3705,63 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
 
                 // Write Output (Chunk)
                 bool writeSuccess = false;
-                std::string targetFile;
-                std::string targetSheet = "Sheet1";
+                TaskOutputTarget target;
+                if (task.outputMode != OutputMode::NONE) target = taskOutputTarget(task, inputFile, defaultOutputFile);
+                const std::string& targetFile = target.file;
+                const std::string& targetSheet = target.sheet;
+                const std::string& ext = target.ext;
 
                 if (task.outputMode == OutputMode::NONE) {
                     writeSuccess = true;
                 } else if (task.outputMode == OutputMode::NEW_SHEET) {
-                    targetFile = defaultOutputFile;
-                    if (targetFile.empty()) targetFile = inputFile;
-
                     if (targetFile.empty()) {
                         if (isTaskFirstChunk) {
                             addError("Task '" + task.taskName + "' requires output file for New Sheet mode");
                             result.errors.push_back("No output file specified for New Sheet mode");
                         }
                     } else {
-                        targetSheet = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
-                        
-                        std::string ext = targetFile.substr(targetFile.find_last_of(".") + 1);
-                        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                        if (ext == targetFile) { targetFile += ".xlsx"; ext = "xlsx"; }
-
                         bool overwrite = isTaskFirstChunk ? task.overwriteSheet : false;
+                        bool nativeXlsx = ext == "xlsx" && writesNativeXlsx(targetFile, false);
+                        if (nativeXlsx) xlsxTargetTasks[targetFile].insert(task.id);
 
-                        if (ext == "xlsx" || ext == "xls") {
+                        if ((ext == "xlsx" || ext == "xls") && !nativeXlsx) {
                             writeSuccess = sharedQtWriter.appendToSheet(targetFile, taskData, targetSheet, overwrite);
+                        } else if (asyncWriter) {
+                            asyncWriter->write(task.id, targetFile, targetSheet, std::move(taskData),
+                                               overwrite ? AsyncTaskWriter::WriteMode::OverwriteSheet : AsyncTaskWriter::WriteMode::Append);
+                            writeSuccess = true; // Failures are collected when the sheet is finished
+                        } else if (nativeXlsx) {
+                            writeSuccess = sharedXlsxWriter.appendToSheet(targetFile, taskData, targetSheet, overwrite);
                         } else {
-                            CSVExcelWriter csvWriter;
-                            writeSuccess = csvWriter.appendToSheet(targetFile, taskData, targetSheet, overwrite);
+                            writeSuccess = sharedCsvWriter.appendToSheet(targetFile, taskData, targetSheet, overwrite);
                         }
                     }
                 } else {
                     // NEW_WORKBOOK
-                    std::string name = task.outputWorkbookName.empty() ? task.taskName : task.outputWorkbookName;
-                    QFileInfo fileInfo(QString::fromStdString(name));
-                    if (fileInfo.isRelative()) {
-                        std::string baseDir;
-                        if (!defaultOutputFile.empty()) {
-                            baseDir = QFileInfo(QString::fromStdString(defaultOutputFile)).absolutePath().toStdString();
-                        } else {
-                            baseDir = QFileInfo(QString::fromStdString(inputFile)).absolutePath().toStdString();
-                        }
-                        targetFile = baseDir + "/" + name;
-                    } else {
-                        targetFile = name;
-                    }
-
-                    std::string ext = targetFile.substr(targetFile.find_last_of(".") + 1);
-                    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                    if (ext == targetFile) { targetFile += ".xlsx"; ext = "xlsx"; }
+                    bool nativeXlsx = ext == "xlsx" && writesNativeXlsx(targetFile, isTaskFirstChunk);
+                    if (nativeXlsx) xlsxTargetTasks[targetFile].insert(task.id);
 
-                    if (ext == "xlsx" || ext == "xls") {
+                    if ((ext == "xlsx" || ext == "xls") && !nativeXlsx) {
                         if (isTaskFirstChunk) {
                             writeSuccess = sharedQtWriter.writeExcelFile(targetFile, taskData);
                         } else {
                             writeSuccess = sharedQtWriter.appendToSheet(targetFile, taskData, "Sheet1", false);
                         }
+                    } else if (asyncWriter) {
+                        asyncWriter->write(task.id, targetFile, "Sheet1", std::move(taskData),
+                                           isTaskFirstChunk ? AsyncTaskWriter::WriteMode::NewWorkbook : AsyncTaskWriter::WriteMode::Append);
+                        writeSuccess = true;
+                    } else if (nativeXlsx) {
+                        if (isTaskFirstChunk) {
+                            writeSuccess = sharedXlsxWriter.writeExcelFile(targetFile, taskData);
+                        } else {
+                            writeSuccess = sharedXlsxWriter.appendToSheet(targetFile, taskData, "Sheet1", false);
+                        }
                     } else {
-                        CSVExcelWriter csvWriter;
                         if (isTaskFirstChunk) {
-                            writeSuccess = csvWriter.writeExcelFile(targetFile, taskData);
+                            writeSuccess = sharedCsvWriter.writeExcelFile(targetFile, taskData);
                         } else {
-                            writeSuccess = csvWriter.appendToSheet(targetFile, taskData, "Sheet1", false);
+                            writeSuccess = sharedCsvWriter.appendToSheet(targetFile, taskData, "Sheet1", false);
                         }
                     }
                 }
@@ -2640,6 +3771,7 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
                      result.errors.push_back("Write failed: " + targetFile);
                 }
             } // End Task Loop
+            if (chunkRules.computed()) ruleRowEvaluations_ += static_cast<int64_t>(currentData_.size());
             
             if (isFirstChunk && includeHeader && !currentData_.empty()) {
                 offset += (currentData_.size() - 1);
@@ -2653,13 +3785,23 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
                 progressCallback_(offset, "Processed " + std::to_string(offset) + " rows...");
             }
             
-            // Check if we read less than chunkSize, meaning EOF
-            if (currentData_.size() < chunkSize) break;
+            if (isLastChunk) break;
 
         } // End Chunk Loop
         
         sharedQtWriter.closeAll();
 
+        // Wait for this sheet's queued output and report failed writes against their tasks
+        if (asyncWriter) {
+            for (const auto& failure : asyncWriter->takeFailures()) {
+                addError("Unable to write task output: " + failure.filename);
+                auto it = sheetTaskResults.find(failure.taskId);
+                if (it != sheetTaskResults.end()) {
+                    it->second.errors.push_back("Write failed: " + failure.filename);
+                }
+            }
+        }
+
         // Finalize results for this sheet
         auto sheetEndTime = std::chrono::high_resolution_clock::now();
         double sheetDuration = std::chrono::duration<double, std::milli>(sheetEndTime - sheetStartTime).count() / 1000.0;
@@ -2667,10 +3809,31 @@ std::vector<ProcessingResult> ExcelProcessorCore::processTasksInternal(const std
         for (const auto& task : tasks) {
             if (sheetTaskResults.find(task.id) != sheetTaskResults.end()) {
                 sheetTaskResults[task.id].processingTime = sheetDuration; 
+                for (const auto& [file, taskIds] : xlsxTargetTasks) {
+                    if (taskIds.count(task.id)) xlsxTargetResults[file].insert(results.size());
+                }
                 results.push_back(sheetTaskResults[task.id]);
             }
         }
     }
 
+    // Native .xlsx workbooks are written to disk once, now that every sheet is done
+    std::vector<std::string> failedWorkbooks;
+    if (asyncWriter) {
+        failedWorkbooks = asyncWriter->saveWorkbooks();
+    } else {
+        sharedXlsxWriter.saveAll(failedWorkbooks);
+    }
+    for (const auto& file : failedWorkbooks) {
+        addError("Unable to write task output: " + file);
+        for (size_t resultIndex : xlsxTargetResults[file]) {
+            results[resultIndex].errors.push_back("Write failed: " + file);
+        }
+    }
+
+    sharedCsvWriter.closeAll();
+    if (asyncWriter) asyncWriter->finish();
+    reader_->closeInput();
+
     return results;
 }
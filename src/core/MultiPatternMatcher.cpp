@@ -0,0 +1,102 @@
+#include "MultiPatternMatcher.h"
+
+size_t MultiPatternMatcher::add(const std::string& pattern) {
+    uint32_t index = static_cast<uint32_t>(patternCount_++);
+    if (pattern.empty()) {
+        emptyPatterns_.push_back(index);
+        return index;
+    }
+    int node = 0;
+    for (unsigned char c : pattern) {
+        if (trie_[node].children[c] < 0) {
+            trie_[node].children[c] = static_cast<int>(trie_.size());
+            trie_.emplace_back();
+        }
+        node = trie_[node].children[c];
+    }
+    trie_[node].patterns.push_back(index);
+    return index;
+}
+
+// Turns the trie into a full transition table: a missing edge follows the failure link (the longest
+// proper suffix that is also a trie prefix), so scanning never backtracks
+void MultiPatternMatcher::build() {
+    const int nodeCount = static_cast<int>(trie_.size());
+
+    // Every byte used by a pattern gets its own column, all other bytes share column 0; with all
+    // 256 bytes in use there are 257 columns
+    int classByte[257];
+    classCount_ = 1;
+    std::fill(std::begin(byteClass_), std::end(byteClass_), 0);
+    for (const auto& node : trie_) {
+        for (int b = 0; b < 256; ++b) {
+            if (node.children[b] >= 0 && byteClass_[b] == 0) {
+                byteClass_[b] = static_cast<uint16_t>(classCount_);
+                classByte[classCount_++] = b;
+            }
+        }
+    }
+
+    next_.assign(static_cast<size_t>(nodeCount) * classCount_, 0);
+    std::vector<int> fail(nodeCount, 0);
+    std::vector<int> order;
+    order.reserve(nodeCount);
+
+    for (int c = 1; c < classCount_; ++c) {
+        int child = trie_[0].children[classByte[c]];
+        if (child >= 0) {
+            next_[c] = child;
+            order.push_back(child);
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        int node = order[i];
+        for (int c = 1; c < classCount_; ++c) {
+            int child = trie_[node].children[classByte[c]];
+            int fallback = next_[static_cast<size_t>(fail[node]) * classCount_ + c];
+            if (child >= 0) {
+                fail[child] = fallback;
+                next_[static_cast<size_t>(node) * classCount_ + c] = child;
+                order.push_back(child);
+            } else {
+                next_[static_cast<size_t>(node) * classCount_ + c] = fallback;
+            }
+        }
+    }
+
+    // A state reports its own patterns and those of its failure chain; breadth-first order
+    // handles every failure target before the states that point to it
+    std::vector<std::vector<uint32_t>> outputs(nodeCount);
+    for (int node : order) {
+        outputs[node] = trie_[node].patterns;
+        const auto& inherited = outputs[fail[node]];
+        outputs[node].insert(outputs[node].end(), inherited.begin(), inherited.end());
+    }
+    outputStart_.assign(nodeCount + 1, 0);
+    outputs_.clear();
+    for (int node = 0; node < nodeCount; ++node) {
+        outputStart_[node] = static_cast<uint32_t>(outputs_.size());
+        outputs_.insert(outputs_.end(), outputs[node].begin(), outputs[node].end());
+    }
+    outputStart_[nodeCount] = static_cast<uint32_t>(outputs_.size());
+
+    trie_.clear();
+    trie_.shrink_to_fit();
+}
+
+void MultiPatternMatcher::scan(std::string_view text, uint64_t* found) const {
+    std::fill(found, found + wordCount(), 0);
+    for (uint32_t index : emptyPatterns_) found[index / 64] |= uint64_t(1) << (index % 64);
+    if (next_.empty()) return;
+
+    const int32_t* next = next_.data();
+    const uint32_t* start = outputStart_.data();
+    int state = 0;
+    for (unsigned char c : text) {
+        state = next[static_cast<size_t>(state) * classCount_ + byteClass_[c]];
+        for (uint32_t i = start[state]; i < start[state + 1]; ++i) {
+            uint32_t index = outputs_[i];
+            found[index / 64] |= uint64_t(1) << (index % 64);
+        }
+    }
+}
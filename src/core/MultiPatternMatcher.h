@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Finds which of a set of substrings occur in a text with a single pass over it (Aho-Corasick).
+// Add every pattern, call build(), then scan() is read-only and safe to share between threads.
+// Bytes that appear in no pattern share one column of the transition table, so the table stays
+// small for keyword lists and the scan is one lookup per input byte.
+class MultiPatternMatcher {
+public:
+    // Adds a pattern and returns its index; the same text may be added more than once
+    size_t add(const std::string& pattern);
+    void build();
+
+    size_t patternCount() const { return patternCount_; }
+    // Number of 64-bit words scan() writes
+    size_t wordCount() const { return (patternCount_ + 63) / 64; }
+
+    // Sets bit i of found (wordCount() words, cleared first) for every pattern i that occurs in text.
+    // An empty pattern occurs in every text.
+    void scan(std::string_view text, uint64_t* found) const;
+
+private:
+    struct TrieNode {
+        int children[256];
+        std::vector<uint32_t> patterns;
+        TrieNode() { std::fill(std::begin(children), std::end(children), -1); }
+    };
+
+    size_t patternCount_ = 0;
+    std::vector<TrieNode> trie_{ 1 };        // Only used until build()
+    std::vector<uint32_t> emptyPatterns_;
+
+    int classCount_ = 1;
+    uint16_t byteClass_[256] = {};           // Byte -> table column; 0 for bytes in no pattern
+    std::vector<int32_t> next_;              // State * classCount_ + column -> next state
+    std::vector<uint32_t> outputStart_;      // State -> first pattern ending there in outputs_
+    std::vector<uint32_t> outputs_;          // Patterns ending at each state, suffix matches included
+};
@@ -0,0 +1,308 @@
+#include "RegexMatcher.h"
+#include <bitset>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+using ByteClass = std::bitset<256>;
+
+// One pattern element: a set of bytes repeated between min and max times (max -1 = unbounded)
+struct Atom {
+    ByteClass bytes;
+    int min = 1;
+    int max = 1;
+};
+
+constexpr int kEscapeFailed = -1;
+constexpr int kEscapeClass = -2;
+
+bool isAsciiDigit(int c) { return c >= '0' && c <= '9'; }
+bool isAsciiAlnum(int c) { return isAsciiDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+int hexValue(int c) {
+    if (isAsciiDigit(c)) return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Recognizes the subset of ECMAScript patterns the automaton handles; anything else is rejected
+// so the caller falls back to std::regex, which also decides whether the pattern is valid at all
+class PatternParser {
+public:
+    explicit PatternParser(const std::string& pattern) : p_(pattern) {}
+
+    bool parse(std::vector<Atom>& atoms) {
+        for (unsigned char c : p_) {
+            if (c >= 0x80) return false;
+        }
+
+        // Anchors at the ends change nothing for a whole-string match
+        pos_ = !p_.empty() && p_[0] == '^' ? 1 : 0;
+        end_ = p_.size();
+        if (end_ > pos_ && p_[end_ - 1] == '$') {
+            size_t backslashes = 0;
+            while (end_ - 1 - backslashes > pos_ && p_[end_ - 2 - backslashes] == '\\') backslashes++;
+            if (backslashes % 2 == 0) end_--;
+        }
+
+        while (pos_ < end_) {
+            Atom atom;
+            char c = p_[pos_];
+            switch (c) {
+                case '.':
+                    atom.bytes.set();
+                    atom.bytes.reset('\n');
+                    atom.bytes.reset('\r');
+                    pos_++;
+                    break;
+                case '\\': {
+                    pos_++;
+                    int single = parseEscape(atom.bytes);
+                    if (single == kEscapeFailed) return false;
+                    if (single >= 0) atom.bytes.set(single);
+                    break;
+                }
+                case '[':
+                    pos_++;
+                    if (!parseBracket(atom.bytes)) return false;
+                    break;
+                case '(': case ')': case '|': case '^': case '$':
+                case ']': case '{': case '}': case '*': case '+': case '?':
+                    return false;
+                default:
+                    atom.bytes.set(static_cast<unsigned char>(c));
+                    pos_++;
+            }
+            if (pos_ < end_ && isQuantifier(p_[pos_]) && !parseQuantifier(atom)) return false;
+            atoms.push_back(atom);
+        }
+        return true;
+    }
+
+private:
+    static bool isQuantifier(char c) { return c == '*' || c == '+' || c == '?' || c == '{'; }
+
+    // After a backslash: returns the byte for a single-character escape, kEscapeClass after adding
+    // a class escape (\d \w \s and their negations) to bytes, or kEscapeFailed
+    int parseEscape(ByteClass& bytes) {
+        if (pos_ >= end_) return kEscapeFailed;
+        char e = p_[pos_++];
+        switch (e) {
+            case 'd': case 'D': case 'w': case 'W': case 's': case 'S': {
+                ByteClass cls;
+                for (int b = 0; b < 128; ++b) {
+                    bool member = false;
+                    if (e == 'd' || e == 'D') member = isAsciiDigit(b);
+                    else if (e == 'w' || e == 'W') member = isAsciiAlnum(b) || b == '_';
+                    else member = b == ' ' || (b >= '\t' && b <= '\r');
+                    cls.set(b, member);
+                }
+                if (e == 'D' || e == 'W' || e == 'S') cls.flip();
+                bytes |= cls;
+                return kEscapeClass;
+            }
+            case 't': return '\t';
+            case 'n': return '\n';
+            case 'r': return '\r';
+            case 'f': return '\f';
+            case 'v': return '\v';
+            case 'x': {
+                if (pos_ + 2 > end_) return kEscapeFailed;
+                int high = hexValue(p_[pos_]);
+                int low = hexValue(p_[pos_ + 1]);
+                if (high < 0 || low < 0) return kEscapeFailed;
+                pos_ += 2;
+                return high * 16 + low;
+            }
+            default:
+                // Escaped punctuation is literal; other letters and digits (\b, \1, \u...) are not handled here
+                if (isAsciiAlnum(static_cast<unsigned char>(e))) return kEscapeFailed;
+                return static_cast<unsigned char>(e);
+        }
+    }
+
+    // After '[': literal bytes, escapes and a-z ranges up to the closing ']', optionally negated
+    bool parseBracket(ByteClass& bytes) {
+        bool negate = false;
+        if (pos_ < end_ && p_[pos_] == '^') {
+            negate = true;
+            pos_++;
+        }
+        if (pos_ < end_ && p_[pos_] == ']') return false; // [] and []...] differ between grammars
+
+        while (pos_ < end_) {
+            char c = p_[pos_];
+            if (c == ']') {
+                pos_++;
+                if (negate) bytes.flip();
+                return true;
+            }
+            if (c == '[') return false; // [:alpha:], [=a=], [.a.]
+
+            int low;
+            if (c == '\\') {
+                pos_++;
+                low = parseEscape(bytes);
+                if (low == kEscapeFailed) return false;
+                if (low == kEscapeClass) {
+                    if (pos_ + 1 < end_ && p_[pos_] == '-' && p_[pos_ + 1] != ']') return false; // [\d-z]
+                    continue;
+                }
+            } else {
+                low = static_cast<unsigned char>(c);
+                pos_++;
+            }
+
+            if (pos_ + 1 < end_ && p_[pos_] == '-' && p_[pos_ + 1] != ']') {
+                pos_++;
+                int high;
+                if (p_[pos_] == '[') return false;
+                if (p_[pos_] == '\\') {
+                    pos_++;
+                    ByteClass unused;
+                    high = parseEscape(unused);
+                    if (high < 0) return false;
+                } else {
+                    high = static_cast<unsigned char>(p_[pos_]);
+                    pos_++;
+                }
+                if (low > high) return false;
+                for (int b = low; b <= high; ++b) bytes.set(b);
+            } else {
+                bytes.set(low);
+            }
+        }
+        return false; // Unterminated
+    }
+
+    // * + ? {n} {n,} {n,m}, optionally lazy (same result for a whole-string match)
+    bool parseQuantifier(Atom& atom) {
+        char q = p_[pos_++];
+        if (q == '*') {
+            atom.min = 0;
+            atom.max = -1;
+        } else if (q == '+') {
+            atom.min = 1;
+            atom.max = -1;
+        } else if (q == '?') {
+            atom.min = 0;
+            atom.max = 1;
+        } else {
+            int n = 0;
+            if (!parseNumber(n)) return false;
+            int m = n;
+            if (pos_ < end_ && p_[pos_] == ',') {
+                pos_++;
+                m = -1;
+                if (pos_ < end_ && isAsciiDigit(p_[pos_]) && !parseNumber(m)) return false;
+            }
+            if (pos_ >= end_ || p_[pos_] != '}') return false;
+            pos_++;
+            if (m != -1 && m < n) return false;
+            atom.min = n;
+            atom.max = m;
+        }
+        if (pos_ < end_ && p_[pos_] == '?') pos_++;
+        return pos_ >= end_ || !isQuantifier(p_[pos_]); // Stacked quantifiers are left to std::regex
+    }
+
+    bool parseNumber(int& value) {
+        size_t start = pos_;
+        value = 0;
+        while (pos_ < end_ && isAsciiDigit(p_[pos_])) {
+            value = value * 10 + (p_[pos_++] - '0');
+            if (value > 1000) return false;
+        }
+        return pos_ > start;
+    }
+
+    const std::string& p_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+};
+
+// Adds the positions reachable by skipping optional atoms
+inline uint64_t skipClosure(uint64_t states, uint64_t skipMask) {
+    while (true) {
+        uint64_t next = states | ((states & skipMask) << 1);
+        if (next == states) return states;
+        states = next;
+    }
+}
+
+} // namespace
+
+RegexMatcher::RegexMatcher(const std::string& pattern, Engine engine) {
+    if (engine == Engine::Automatic && compileAutomaton(pattern)) return;
+    try {
+        regex_ = std::make_unique<std::regex>(pattern);
+    } catch (const std::regex_error&) {
+        regex_.reset(); // Invalid pattern: never matches
+    }
+}
+
+// Expands the atoms into positions (x{2,3} -> x x x?, x+ -> x x*) and builds, for each byte, the mask
+// of positions that accept it. A set bit in the state word means "the next atom to match is this one".
+bool RegexMatcher::compileAutomaton(const std::string& pattern) {
+    std::vector<Atom> atoms;
+    if (!PatternParser(pattern).parse(atoms)) return false;
+
+    std::vector<std::pair<ByteClass, int>> positions; // Byte set, 0 = once, 1 = optional, 2 = repeated
+    for (const auto& atom : atoms) {
+        for (int i = 0; i < atom.min; ++i) positions.push_back({ atom.bytes, 0 });
+        if (atom.max == -1) {
+            positions.push_back({ atom.bytes, 2 });
+        } else {
+            for (int i = atom.min; i < atom.max; ++i) positions.push_back({ atom.bytes, 1 });
+        }
+        if (positions.size() > static_cast<size_t>(kMaxPositions)) return false;
+    }
+
+    for (size_t p = 0; p < positions.size(); ++p) {
+        uint64_t bit = uint64_t(1) << p;
+        for (int b = 0; b < 256; ++b) {
+            if (positions[p].first[b]) classMask_[b] |= bit;
+        }
+        if (positions[p].second != 0) skipMask_ |= bit;
+        if (positions[p].second == 2) repeatMask_ |= bit;
+    }
+    positionCount_ = static_cast<int>(positions.size());
+    initial_ = skipClosure(1, skipMask_);
+    automaton_ = true;
+    return true;
+}
+
+bool RegexMatcher::matches(const std::string& text) const {
+    if (automaton_) {
+        uint64_t states = initial_;
+        for (unsigned char c : text) {
+            uint64_t matched = states & classMask_[c];
+            states = skipClosure(((matched & ~repeatMask_) << 1) | (matched & repeatMask_), skipMask_);
+            if (!states) return false;
+        }
+        return (states >> positionCount_) & 1;
+    }
+    if (!regex_) return false;
+    try {
+        return std::regex_match(text, *regex_);
+    } catch (const std::regex_error&) {
+        return false; // Complexity or stack limits
+    }
+}
+
+std::shared_ptr<const RegexMatcher> RegexMatcher::cached(const std::string& pattern, Engine engine) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const RegexMatcher>> cache[2];
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& patterns = cache[engine == Engine::StdRegex ? 1 : 0];
+    auto it = patterns.find(pattern);
+    if (it != patterns.end()) return it->second;
+
+    if (patterns.size() >= 1024) patterns.clear(); // Bounded: rule edits keep adding new patterns
+    auto matcher = std::make_shared<const RegexMatcher>(pattern, engine);
+    patterns.emplace(pattern, matcher);
+    return matcher;
+}
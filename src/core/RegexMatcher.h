@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <regex>
+#include <cstdint>
+
+// Whole-string regular expression match (std::regex_match, ECMAScript grammar) compiled once and
+// safe to share read-only between threads.
+// Patterns built only from literals, '.', escapes such as \d \w \s, bracket classes and quantifiers
+// (* + ? {n,m}), optionally anchored with ^ and $, run on a bit-parallel automaton: one table lookup
+// and a few bit operations per input byte, no backtracking and no allocation. Groups, alternation,
+// word boundaries, back references and non-ASCII patterns fall back to std::regex.
+class RegexMatcher {
+public:
+    enum class Engine {
+        Automatic,  // Automaton when the pattern allows it, std::regex otherwise
+        StdRegex    // Always std::regex
+    };
+
+    explicit RegexMatcher(const std::string& pattern, Engine engine = Engine::Automatic);
+
+    // False if the pattern does not compile; such a matcher never matches
+    bool valid() const { return automaton_ || regex_; }
+    bool usesAutomaton() const { return automaton_; }
+
+    bool matches(const std::string& text) const;
+
+    // Matcher for pattern from a process-wide cache, so every caller shares one compiled pattern
+    static std::shared_ptr<const RegexMatcher> cached(const std::string& pattern, Engine engine = Engine::Automatic);
+
+private:
+    static constexpr int kMaxPositions = 63;
+
+    bool compileAutomaton(const std::string& pattern);
+
+    bool automaton_ = false;
+    int positionCount_ = 0;             // Number of atoms; reaching position positionCount_ accepts
+    uint64_t classMask_[256] = {};      // Byte -> atoms whose character class contains it
+    uint64_t repeatMask_ = 0;           // Atoms that may repeat (x*)
+    uint64_t skipMask_ = 0;             // Atoms that may be skipped (x? and x*)
+    uint64_t initial_ = 0;              // Start position with skippable atoms applied
+    std::unique_ptr<std::regex> regex_;
+};
@@ -1,15 +1,985 @@
 #include "ExcelProcessorCore.h"
+#include "RegexMatcher.h"
+#include "MultiPatternMatcher.h"
 #include <algorithm>
-#include <regex>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
 #include <cstring>
+#include <cctype>
 #include <ctime>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Same whitespace set as the interpreted string comparison
+std::string_view trimView(std::string_view s) {
+    size_t first = s.find_first_not_of(" \t\r\n");
+    if (first == std::string_view::npos) return std::string_view();
+    size_t last = s.find_last_not_of(" \t\r\n");
+    return s.substr(first, last - first + 1);
+}
+
+// Whole-string std::stod, the interpreted engine's test for numeric text
+bool parseWholeNumber(const std::string& text, double& number) {
+    // Text that cannot start a number is rejected without the cost of std::stod throwing
+    if (text.empty()) return false;
+    unsigned char first = static_cast<unsigned char>(text[0]);
+    if (!std::isdigit(first) && !std::isspace(first) && !std::strchr("+-.iInN", first)) return false;
+    try {
+        size_t idx = 0;
+        number = std::stod(text, &idx);
+        return idx == text.size();
+    } catch (...) {
+        return false;
+    }
+}
+
+// Items of an IN_LIST value: comma-separated, trimmed, empty items ignored
+std::vector<std::string> splitListItems(const std::string& value) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= value.size()) {
+        size_t end = value.find(',', start);
+        if (end == std::string::npos) end = value.size();
+        std::string_view item = trimView(std::string_view(value).substr(start, end - start));
+        if (!item.empty()) items.emplace_back(item);
+        start = end + 1;
+    }
+    return items;
+}
+
+// Bit j of the result is flags[j] (each 0 or 1): multiplying by 0x0102040810204080 moves the 8 flags
+// of a word into its top byte
+inline uint64_t packFlags(const uint8_t* flags) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t word;
+        std::memcpy(&word, flags + i * 8, sizeof(word));
+        bits |= ((word * 0x0102040810204080ULL) >> 56) << (i * 8);
+    }
+    return bits;
+}
+
+inline int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Text trimmed, lowercased unless case sensitive
+void normalizeText(std::string_view text, bool caseSensitive, std::string& out) {
+    text = trimView(text);
+    out.assign(text.data(), text.size());
+    if (!caseSensitive) std::transform(out.begin(), out.end(), out.begin(), ::tolower);
+}
+
+// Cell as string operators see it: numbers, booleans and dates as text, trimmed, lowercased unless case sensitive
+void normalizedCellText(const CellValue& value, bool caseSensitive, std::string& out) {
+    std::string converted;
+    std::string_view text;
+    if (auto strVal = std::get_if<std::string>(&value)) {
+        text = *strVal;
+    } else if (auto intVal = std::get_if<int>(&value)) {
+        converted = std::to_string(*intVal);
+    } else if (auto doubleVal = std::get_if<double>(&value)) {
+        converted = std::to_string(*doubleVal);
+    } else if (auto boolVal = std::get_if<bool>(&value)) {
+        converted = *boolVal ? "true" : "false";
+    } else if (auto dateVal = std::get_if<CellDate>(&value)) {
+        std::tm tm = dateVal->toTm();
+        char buffer[64];
+        converted.assign(buffer, std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm));
+    }
+    if (!std::holds_alternative<std::string>(value)) text = converted;
+    normalizeText(text, caseSensitive, out);
+}
+
+// The text normalizedCellText() starts from, for a cell of a columnar chunk
+std::string_view columnCellText(const ColumnarChunk::Column& column, size_t row, std::string& converted) {
+    switch (column.types[row]) {
+        case ColumnarChunk::CellType::Int:
+            converted = std::to_string(static_cast<int>(column.numbers[row]));
+            return converted;
+        case ColumnarChunk::CellType::Double:
+            converted = std::to_string(column.numbers[row]);
+            return converted;
+        case ColumnarChunk::CellType::Bool:
+            return column.numbers[row] != 0.0 ? "true" : "false";
+        case ColumnarChunk::CellType::String:
+        case ColumnarChunk::CellType::Date:
+            return column.textAt(row);
+        default:
+            return std::string_view();
+    }
+}
+
+class EqualitySet;
+
+// One condition with its constant side prepared for every path the interpreted engine can take:
+// string comparison (trimmed, lowercased, numeric form), number and boolean comparison, split and regex.
+class CompiledCondition {
+public:
+    CompiledCondition(const RuleCondition& condition, RegexMatcher::Engine regexEngine)
+        : column_(static_cast<size_t>(condition.column)), oper_(condition.oper), caseSensitive_(condition.case_sensitive) {
+        // IN_LIST is EQUAL against each item; a non-text value is a list of one
+        if (oper_ == Operator::IN_LIST) {
+            if (auto listVal = std::get_if<std::string>(&condition.value)) {
+                compileList(condition, *listVal, regexEngine);
+                return;
+            }
+            oper_ = Operator::EQUAL;
+        }
+
+        stringOperator_ = oper_ == Operator::CONTAINS || oper_ == Operator::NOT_CONTAINS ||
+                          oper_ == Operator::STARTS_WITH || oper_ == Operator::ENDS_WITH || oper_ == Operator::REGEX;
+
+        split_ = condition.splitTarget != SplitTarget::NONE && !condition.splitSymbol.empty();
+        splitSymbol_ = condition.splitSymbol;
+        splitTarget_ = condition.splitTarget;
+
+        if (auto strVal = std::get_if<std::string>(&condition.value)) {
+            hasText_ = true;
+            text_ = std::string(trimView(*strVal));
+            if (!caseSensitive_) std::transform(text_.begin(), text_.end(), text_.begin(), ::tolower);
+            textIsNumber_ = parseWholeNumber(text_, textNumber_);
+            if (oper_ == Operator::REGEX) {
+                regex_ = std::make_shared<const RegexMatcher>(text_, regexEngine); // Invalid patterns never match
+            }
+
+            // Number and boolean comparisons use the untrimmed value (std::stod skips leading blanks)
+            try {
+                number_ = std::stod(*strVal);
+                hasNumber_ = true;
+            } catch (...) {
+                hasNumber_ = false;
+            }
+            std::string lower = *strVal;
+            std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+            boolean_ = (lower == "true" || lower == "1" || lower == "yes" || lower == "\xe6\x98\xaf");
+        } else if (auto intVal = std::get_if<int>(&condition.value)) {
+            number_ = static_cast<double>(*intVal);
+            boolean_ = *intVal != 0;
+        } else if (auto doubleVal = std::get_if<double>(&condition.value)) {
+            number_ = *doubleVal;
+            boolean_ = *doubleVal != 0.0;
+        } else if (auto boolVal = std::get_if<bool>(&condition.value)) {
+            number_ = *boolVal ? 1.0 : 0.0;
+            boolean_ = *boolVal;
+        }
+    }
+
+    // 1-based column; 0 or beyond the row means the condition has no cell
+    size_t column() const { return column_; }
+
+    // CONTAINS / NOT_CONTAINS of a text constant, answerable from a scan of the normalized cell text
+    bool isSubstringCheck() const {
+        return (oper_ == Operator::CONTAINS || oper_ == Operator::NOT_CONTAINS) && !split_ && hasText_;
+    }
+    bool negated() const { return oper_ == Operator::NOT_CONTAINS; }
+    bool caseSensitive() const { return caseSensitive_; }
+    const std::string& text() const { return text_; }
+
+    // EQUAL of a text constant without split, which an EqualitySet can answer
+    bool isEqualityCheck() const { return oper_ == Operator::EQUAL && !split_ && hasText_; }
+    // IN_LIST whose items are all equality checks
+    bool isListCheck() const { return oper_ == Operator::IN_LIST && listSet_ != nullptr; }
+    // The EQUAL conditions an IN_LIST expands to
+    const std::vector<CompiledCondition>& listItems() const { return listItems_; }
+
+    bool matches(const CellValue& value) const {
+        if (oper_ == Operator::IN_LIST) return matchList(value);
+        try {
+            if (auto strVal = std::get_if<std::string>(&value)) {
+                return matchString(*strVal);
+            } else if (auto intVal = std::get_if<int>(&value)) {
+                return stringOperator_ ? matchString(std::to_string(*intVal)) : matchNumber(static_cast<double>(*intVal));
+            } else if (auto doubleVal = std::get_if<double>(&value)) {
+                return stringOperator_ ? matchString(std::to_string(*doubleVal)) : matchNumber(*doubleVal);
+            } else if (auto boolVal = std::get_if<bool>(&value)) {
+                return stringOperator_ ? matchString(*boolVal ? "true" : "false") : matchBoolean(*boolVal);
+            } else if (auto dateVal = std::get_if<CellDate>(&value)) {
+                std::tm tm = dateVal->toTm();
+                char buffer[64];
+                size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
+                return matchString(std::string(buffer, length));
+            }
+            return false;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    // matches() for row of a columnar chunk
+    bool matchesAt(const ColumnarChunk::Column& column, size_t row) const;
+    // matches() for a String or Date cell with this text
+    bool matchesText(std::string_view text) const;
+
+    // matches() over a whole column: out ((rowCount + 63) / 64 words) gets a bit per row, 0 for missing
+    // cells. Numbers compared as numbers go 64 rows at a time through a branch-free loop the compiler
+    // can vectorize, text is matched once per dictionary entry and looked up by code; the remaining
+    // cells are matched on their own.
+    void matchColumn(const ColumnarChunk::Column& column, size_t rowCount, uint64_t* out) const {
+        using CellType = ColumnarChunk::CellType;
+        const CellType* types = column.types.data();
+        const double* numbers = column.numbers.data();
+        const uint32_t* codes = column.codes.data();
+        const bool numberKernel = oper_ != Operator::IN_LIST && !stringOperator_;
+
+        thread_local std::vector<uint8_t> entryMatches;
+        entryMatches.resize(column.dictionary.size());
+        for (size_t e = 0; e < column.dictionary.size(); ++e) entryMatches[e] = matchesText(column.dictionary[e]);
+        const bool textKernel = !entryMatches.empty();
+
+        for (size_t w = 0, base = 0; base < rowCount; ++w, base += 64) {
+            const size_t count = std::min<size_t>(64, rowCount - base);
+            uint64_t numeric = 0;
+            if (numberKernel) {
+                uint8_t flags[64] = {};
+                for (size_t j = 0; j < count; ++j) {
+                    CellType type = types[base + j];
+                    flags[j] = type == CellType::Int || type == CellType::Double;
+                }
+                numeric = packFlags(flags);
+            }
+            uint64_t text = 0, textBits = 0;
+            if (textKernel) {
+                uint8_t flags[64] = {}, hits[64] = {};
+                for (size_t j = 0; j < count; ++j) {
+                    CellType type = types[base + j];
+                    flags[j] = type == CellType::String || type == CellType::Date;
+                    hits[j] = flags[j] & entryMatches[codes[base + j]];
+                }
+                text = packFlags(flags);
+                textBits = packFlags(hits);
+            }
+            uint64_t bits = (numeric ? compareNumbers(numbers + base, count) & numeric : 0) | textBits;
+            for (uint64_t others = column.present[w] & ~numeric & ~text; others != 0; others &= others - 1) {
+                int j = countTrailingZeros(others);
+                if (matchesAt(column, base + j)) bits |= uint64_t(1) << j;
+            }
+            out[w] = bits;
+        }
+    }
+
+private:
+    friend class EqualitySet;
+
+    // matchNumber() of count (at most 64) values as a bitmap, the operator chosen once per block
+    uint64_t compareNumbers(const double* values, size_t count) const {
+        if (!hasNumber_) return 0;
+        const double n = number_;
+        switch (oper_) {
+            case Operator::EQUAL:
+                return compareBlock(values, count, [n](double v) { return std::fabs(v - n) < 1e-10; });
+            case Operator::NOT_EQUAL:
+                return compareBlock(values, count, [n](double v) { return std::fabs(v - n) >= 1e-10; });
+            case Operator::GREATER:
+                return compareBlock(values, count, [n](double v) { return v > n; });
+            case Operator::LESS:
+                return compareBlock(values, count, [n](double v) { return v < n; });
+            case Operator::GREATER_EQUAL:
+                return compareBlock(values, count, [n](double v) { return v >= n - 1e-10; });
+            case Operator::LESS_EQUAL:
+                return compareBlock(values, count, [n](double v) { return v <= n + 1e-10; });
+            case Operator::NOT_EMPTY:
+                return ~uint64_t(0);
+            default:
+                return 0;
+        }
+    }
+
+    // Compares into one byte per value, then packs 8 bytes at a time. Full blocks use a fixed trip
+    // count, which compilers vectorize even at their cheapest cost model.
+    template <typename Compare>
+    static uint64_t compareBlock(const double* values, size_t count, Compare compare) {
+        uint8_t flags[64] = {};
+        if (count == 64) {
+            for (size_t j = 0; j < 64; ++j) flags[j] = compare(values[j]);
+        } else {
+            for (size_t j = 0; j < count; ++j) flags[j] = compare(values[j]);
+        }
+        return packFlags(flags);
+    }
+
+
+    void compileList(const RuleCondition& condition, const std::string& list, RegexMatcher::Engine regexEngine);
+    bool matchList(const CellValue& value) const;
+
+    bool matchString(std::string_view value) const {
+        if (split_) return matchSplit(value);
+        if (!hasText_) return false;
+
+        // Normalized cell text, in a per-thread buffer so the hot loop does not allocate
+        thread_local std::string left;
+        std::string_view trimmed = trimView(value);
+        left.assign(trimmed.data(), trimmed.size());
+        if (!caseSensitive_) std::transform(left.begin(), left.end(), left.begin(), ::tolower);
+
+        double leftNumber = 0.0;
+        switch (oper_) {
+            case Operator::EQUAL:
+                if (left == text_) return true;
+                return textIsNumber_ && parseWholeNumber(left, leftNumber) && std::fabs(leftNumber - textNumber_) < 1e-10;
+            case Operator::NOT_EQUAL:
+                if (left == text_) return false;
+                if (textIsNumber_ && parseWholeNumber(left, leftNumber)) return std::fabs(leftNumber - textNumber_) >= 1e-10;
+                return true;
+            case Operator::CONTAINS:
+                return left.find(text_) != std::string::npos;
+            case Operator::NOT_CONTAINS:
+                return left.find(text_) == std::string::npos;
+            case Operator::STARTS_WITH:
+                return left.size() >= text_.size() && left.compare(0, text_.size(), text_) == 0;
+            case Operator::ENDS_WITH:
+                return left.size() >= text_.size() &&
+                       left.compare(left.size() - text_.size(), text_.size(), text_) == 0;
+            case Operator::GREATER:
+            case Operator::LESS:
+            case Operator::GREATER_EQUAL:
+            case Operator::LESS_EQUAL:
+                if (!textIsNumber_ || !parseWholeNumber(left, leftNumber)) return false;
+                if (oper_ == Operator::GREATER) return leftNumber > textNumber_;
+                if (oper_ == Operator::LESS) return leftNumber < textNumber_;
+                if (oper_ == Operator::GREATER_EQUAL) return leftNumber >= textNumber_ - 1e-10;
+                return leftNumber <= textNumber_ + 1e-10;
+            case Operator::EMPTY:
+                return left.empty();
+            case Operator::NOT_EMPTY:
+                return !left.empty();
+            case Operator::REGEX:
+                return regex_ && regex_->matches(left);
+            default:
+                return false;
+        }
+    }
+
+    // Compares the numbers before and/or after the split symbol, e.g. "340*12"
+    bool matchSplit(std::string_view value) const {
+        size_t pos = value.find(splitSymbol_);
+        if (pos == std::string::npos) return false;
+
+        double numBefore = 0.0, numAfter = 0.0;
+        bool hasBefore = false, hasAfter = false;
+        try {
+            if (pos > 0) {
+                numBefore = std::stod(std::string(value.substr(0, pos)));
+                hasBefore = true;
+            }
+        } catch (...) {}
+        try {
+            if (pos + splitSymbol_.size() < value.size()) {
+                numAfter = std::stod(std::string(value.substr(pos + splitSymbol_.size())));
+                hasAfter = true;
+            }
+        } catch (...) {}
+
+        switch (splitTarget_) {
+            case SplitTarget::BEFORE:
+                return hasBefore && matchNumber(numBefore);
+            case SplitTarget::AFTER:
+                return hasAfter && matchNumber(numAfter);
+            case SplitTarget::BOTH:
+                return hasBefore && hasAfter && matchNumber(numBefore) && matchNumber(numAfter);
+            default:
+                return false;
+        }
+    }
+
+    bool matchNumber(double value) const {
+        if (!hasNumber_) return false;
+        switch (oper_) {
+            case Operator::EQUAL:
+                return std::fabs(value - number_) < 1e-10;
+            case Operator::NOT_EQUAL:
+                return std::fabs(value - number_) >= 1e-10;
+            case Operator::GREATER:
+                return value > number_;
+            case Operator::LESS:
+                return value < number_;
+            case Operator::GREATER_EQUAL:
+                return value >= number_ - 1e-10;
+            case Operator::LESS_EQUAL:
+                return value <= number_ + 1e-10;
+            case Operator::EMPTY:
+                return false; // Numbers cannot be empty
+            case Operator::NOT_EMPTY:
+                return true;  // Numbers are always non-empty
+            default:
+                return false;
+        }
+    }
+
+    bool matchBoolean(bool value) const {
+        switch (oper_) {
+            case Operator::EQUAL:
+                return value == boolean_;
+            case Operator::NOT_EQUAL:
+                return value != boolean_;
+            case Operator::EMPTY:
+                return false;
+            case Operator::NOT_EMPTY:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    size_t column_;
+    Operator oper_;
+    bool caseSensitive_;
+    bool stringOperator_ = false;
+
+    bool split_ = false;
+    std::string splitSymbol_;
+    SplitTarget splitTarget_ = SplitTarget::NONE;
+
+    bool hasText_ = false;        // String constant: trimmed, lowercased unless case sensitive
+    std::string text_;
+    bool textIsNumber_ = false;
+    double textNumber_ = 0.0;
+    std::shared_ptr<const RegexMatcher> regex_;
+
+    bool hasNumber_ = true;       // Constant as a number (false if it is text std::stod rejects)
+    double number_ = 0.0;
+    bool boolean_ = false;
+
+    std::vector<CompiledCondition> listItems_;
+    std::shared_ptr<const EqualitySet> listSet_; // Set of listItems_ when they are all equality checks
+};
+
+// Answers many EQUAL conditions on one cell at once, each reporting a caller-chosen id: the cell text
+// is normalized once and looked up in a hash map of the text constants, a numeric cell (or numeric
+// text) is located by binary search among the constants' numbers. Gives exactly the answers of
+// CompiledCondition::matches for every condition added.
+class EqualitySet {
+public:
+    explicit EqualitySet(bool caseSensitive) : caseSensitive_(caseSensitive) {}
+
+    // condition must be an equality check with this set's case mode
+    void add(const CompiledCondition& condition, uint32_t id) {
+        idCount_ = std::max(idCount_, id + 1);
+        texts_[condition.text_].push_back(id);
+        if (condition.textIsNumber_ && !std::isnan(condition.textNumber_)) textNumbers_.push_back({ condition.textNumber_, id });
+        if (condition.hasNumber_ && !std::isnan(condition.number_)) numbers_.push_back({ condition.number_, id });
+        (condition.boolean_ ? trueIds_ : falseIds_).push_back(id);
+    }
+
+    void build() {
+        std::sort(textNumbers_.begin(), textNumbers_.end());
+        std::sort(numbers_.begin(), numbers_.end());
+    }
+
+    uint32_t idCount() const { return idCount_; }
+
+    // Sets bit id in found for every condition that matches the cell
+    void scan(const CellValue& value, uint64_t* found) const {
+        if (auto intVal = std::get_if<int>(&value)) {
+            markNumber(numbers_, static_cast<double>(*intVal), found);
+        } else if (auto doubleVal = std::get_if<double>(&value)) {
+            markNumber(numbers_, *doubleVal, found);
+        } else if (auto boolVal = std::get_if<bool>(&value)) {
+            for (uint32_t id : *boolVal ? trueIds_ : falseIds_) mark(id, found);
+        } else {
+            thread_local std::string text;
+            normalizedCellText(value, caseSensitive_, text);
+            scanText(text, found);
+        }
+    }
+
+    // scan() for a String or Date cell with this text
+    void scanCellText(std::string_view text, uint64_t* found) const {
+        thread_local std::string normalized;
+        normalizeText(text, caseSensitive_, normalized);
+        scanText(normalized, found);
+    }
+
+    // scan() for row of a columnar chunk
+    void scanAt(const ColumnarChunk::Column& column, size_t row, uint64_t* found) const {
+        switch (column.types[row]) {
+            case ColumnarChunk::CellType::Int:
+            case ColumnarChunk::CellType::Double:
+                markNumber(numbers_, column.numbers[row], found);
+                break;
+            case ColumnarChunk::CellType::Bool:
+                for (uint32_t id : column.numbers[row] != 0.0 ? trueIds_ : falseIds_) mark(id, found);
+                break;
+            case ColumnarChunk::CellType::String:
+            case ColumnarChunk::CellType::Date:
+                scanCellText(column.textAt(row), found);
+                break;
+            default:
+                break;
+        }
+    }
+
+private:
+    using NumberIds = std::vector<std::pair<double, uint32_t>>;
+
+    static void mark(uint32_t id, uint64_t* found) { found[id / 64] |= uint64_t(1) << (id % 64); }
+
+    void scanText(const std::string& text, uint64_t* found) const {
+        auto it = texts_.find(text);
+        if (it != texts_.end()) {
+            for (uint32_t id : it->second) mark(id, found);
+        }
+        double number = 0.0;
+        if (!textNumbers_.empty() && parseWholeNumber(text, number)) markNumber(textNumbers_, number, found);
+    }
+
+    // Constants within the 1e-10 tolerance of the comparisons; the window is wider and each candidate
+    // is then checked with the comparison's own expression
+    static void markNumber(const NumberIds& numbers, double value, uint64_t* found) {
+        if (std::isnan(value)) return;
+        auto it = std::lower_bound(numbers.begin(), numbers.end(), std::make_pair(value - 1e-9, uint32_t(0)));
+        for (; it != numbers.end() && it->first <= value + 1e-9; ++it) {
+            if (std::fabs(value - it->first) < 1e-10) mark(it->second, found);
+        }
+    }
+
+    bool caseSensitive_;
+    uint32_t idCount_ = 0;
+    std::unordered_map<std::string, std::vector<uint32_t>> texts_;
+    NumberIds textNumbers_;   // Text constants that parse as whole numbers
+    NumberIds numbers_;       // Constants as numbers, for numeric cells
+    std::vector<uint32_t> trueIds_;
+    std::vector<uint32_t> falseIds_;
+};
+
+void CompiledCondition::compileList(const RuleCondition& condition, const std::string& list, RegexMatcher::Engine regexEngine) {
+    RuleCondition item = condition;
+    item.oper = Operator::EQUAL;
+    bool allEqualityChecks = true;
+    for (const auto& text : splitListItems(list)) {
+        item.value = text;
+        listItems_.emplace_back(item, regexEngine);
+        allEqualityChecks = allEqualityChecks && listItems_.back().isEqualityCheck();
+    }
+    if (!allEqualityChecks) return; // Split items are compared one by one
+
+    auto set = std::make_shared<EqualitySet>(caseSensitive_);
+    for (const auto& listItem : listItems_) set->add(listItem, 0);
+    set->build();
+    listSet_ = std::move(set);
+}
+
+bool CompiledCondition::matchesText(std::string_view text) const {
+    if (oper_ == Operator::IN_LIST) {
+        if (listSet_) {
+            uint64_t found = 0;
+            listSet_->scanCellText(text, &found);
+            return found != 0;
+        }
+        for (const auto& item : listItems_) {
+            if (item.matchesText(text)) return true;
+        }
+        return false;
+    }
+    try {
+        return matchString(text);
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool CompiledCondition::matchesAt(const ColumnarChunk::Column& column, size_t row) const {
+    using CellType = ColumnarChunk::CellType;
+    if (column.types[row] == CellType::String || column.types[row] == CellType::Date) return matchesText(column.textAt(row));
+    if (oper_ == Operator::IN_LIST) {
+        if (listSet_) {
+            uint64_t found = 0;
+            listSet_->scanAt(column, row, &found);
+            return found != 0;
+        }
+        for (const auto& item : listItems_) {
+            if (item.matchesAt(column, row)) return true;
+        }
+        return false;
+    }
+    try {
+        const double number = column.numbers[row];
+        switch (column.types[row]) {
+            case CellType::Int:
+                return stringOperator_ ? matchString(std::to_string(static_cast<int>(number))) : matchNumber(number);
+            case CellType::Double:
+                return stringOperator_ ? matchString(std::to_string(number)) : matchNumber(number);
+            case CellType::Bool:
+                return stringOperator_ ? matchString(number != 0.0 ? "true" : "false") : matchBoolean(number != 0.0);
+            default:
+                return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool CompiledCondition::matchList(const CellValue& value) const {
+    if (listSet_) {
+        uint64_t found = 0;
+        listSet_->scan(value, &found);
+        return found != 0;
+    }
+    for (const auto& item : listItems_) {
+        if (item.matches(value)) return true;
+    }
+    return false;
+}
+
+// Rules evaluated together. Substring conditions on the same column and case mode form one
+// MultiPatternMatcher, so a keyword list of any length costs one pass over the cell; EQUAL and
+// IN_LIST conditions form one EqualitySet, so a list of values costs one lookup. Every other
+// condition is evaluated on its own.
+class DefaultCompiledRuleSet : public CompiledRuleSet {
+public:
+    DefaultCompiledRuleSet(const std::vector<Rule>& rules, RegexMatcher::Engine regexEngine) {
+        for (const auto& rule : rules) {
+            if (!ruleIndices_.count(rule.id)) ruleIndices_.emplace(rule.id, static_cast<int>(rules_.size()));
+            CompiledRuleEntry entry;
+            entry.logic = rule.logic;
+            // Every rule type is a condition check; disabled rules and unknown types never match
+            switch (rule.type) {
+                case RuleType::FILTER:
+                case RuleType::DELETE_ROW:
+                case RuleType::SPLIT:
+                case RuleType::TRANSFORM:
+                    entry.neverMatches = !rule.enabled;
+                    break;
+                default:
+                    entry.neverMatches = true;
+            }
+            for (const auto& condition : rule.conditions) {
+                entry.terms.push_back({ conditions_.size() });
+                conditions_.emplace_back(condition, regexEngine);
+            }
+            rules_.push_back(std::move(entry));
+        }
+
+        // A lone substring or equality condition is evaluated directly; two or more on a column
+        // (counting every IN_LIST as several) share one scan or one lookup of the cell
+        std::map<std::pair<size_t, bool>, std::vector<std::pair<size_t, size_t>>> substringTerms; // -> (rule, term)
+        std::map<std::pair<size_t, bool>, std::vector<std::pair<size_t, size_t>>> equalityTerms;
+        std::map<std::pair<size_t, bool>, size_t> equalityValues;
+        for (size_t r = 0; r < rules_.size(); ++r) {
+            for (size_t t = 0; t < rules_[r].terms.size(); ++t) {
+                const CompiledCondition& condition = conditions_[rules_[r].terms[t].condition];
+                if (condition.column() == 0) continue;
+                std::pair<size_t, bool> key{ condition.column(), condition.caseSensitive() };
+                if (condition.isSubstringCheck()) substringTerms[key].push_back({ r, t });
+                if (condition.isEqualityCheck() || condition.isListCheck()) {
+                    equalityTerms[key].push_back({ r, t });
+                    equalityValues[key] += condition.isListCheck() ? condition.listItems().size() : 1;
+                }
+            }
+        }
+
+        for (const auto& [key, terms] : substringTerms) {
+            if (terms.size() < 2) continue;
+            SubstringGroup group;
+            group.column = key.first;
+            group.caseSensitive = key.second;
+            group.firstWord = wordCount_;
+            for (const auto& [r, t] : terms) {
+                Term& term = rules_[r].terms[t];
+                term.kind = TermKind::Substring;
+                term.group = static_cast<int>(substringGroups_.size());
+                term.bit = static_cast<uint32_t>(group.matcher.add(conditions_[term.condition].text()));
+            }
+            group.matcher.build();
+            wordCount_ += group.matcher.wordCount();
+            substringGroups_.push_back(std::move(group));
+        }
+
+        for (const auto& [key, terms] : equalityTerms) {
+            if (equalityValues[key] < 2) continue;
+            EqualityGroup group{ key.first, wordCount_, EqualitySet(key.second) };
+            uint32_t bit = 0;
+            std::map<size_t, uint32_t> orRuleBits; // The terms of an OR rule share one bit
+            for (const auto& [r, t] : terms) {
+                Term& term = rules_[r].terms[t];
+                term.kind = TermKind::Equality;
+                term.group = static_cast<int>(equalityGroups_.size());
+                if (rules_[r].logic == RuleLogic::OR) {
+                    auto inserted = orRuleBits.emplace(r, bit);
+                    term.bit = inserted.first->second;
+                    if (inserted.second) bit++;
+                } else {
+                    term.bit = bit++;
+                }
+                const CompiledCondition& condition = conditions_[term.condition];
+                if (condition.isListCheck()) {
+                    for (const auto& item : condition.listItems()) group.set.add(item, term.bit);
+                } else {
+                    group.set.add(condition, term.bit);
+                }
+            }
+            group.set.build();
+            wordCount_ += (bit + 63) / 64;
+            equalityGroups_.push_back(std::move(group));
+        }
+
+        // An OR rule then needs only one of the terms sharing a bit
+        for (auto& rule : rules_) {
+            if (rule.logic != RuleLogic::OR) continue;
+            std::set<std::pair<int, uint32_t>> seen;
+            rule.terms.erase(std::remove_if(rule.terms.begin(), rule.terms.end(), [&seen](const Term& term) {
+                return term.kind == TermKind::Equality && !seen.insert({ term.group, term.bit }).second;
+            }), rule.terms.end());
+        }
+    }
+
+    int ruleCount() const override { return static_cast<int>(rules_.size()); }
+
+    int ruleIndex(int ruleId) const override {
+        auto it = ruleIndices_.find(ruleId);
+        return it != ruleIndices_.end() ? it->second : -1;
+    }
+
+    void evaluate(const DataRow& row, std::vector<uint64_t>& results) const override {
+        results.assign((rules_.size() + 63) / 64, 0);
+        const size_t cellCount = row.data.size();
+
+        // One scan per column group; found holds the bits of every group's patterns
+        thread_local std::vector<uint64_t> found;
+        thread_local std::string text;
+        found.assign(wordCount_, 0);
+        for (const auto& group : substringGroups_) {
+            if (group.column > cellCount) continue;
+            normalizedCellText(row.data[group.column - 1], group.caseSensitive, text);
+            group.matcher.scan(text, found.data() + group.firstWord);
+        }
+        for (const auto& group : equalityGroups_) {
+            if (group.column <= cellCount) group.set.scan(row.data[group.column - 1], found.data() + group.firstWord);
+        }
+
+        for (size_t r = 0; r < rules_.size(); ++r) {
+            if (matchesRule(rules_[r], row, cellCount, found)) results[r / 64] |= uint64_t(1) << (r % 64);
+        }
+    }
+
+    // Term by term instead of row by row: each term becomes a bitmap over the chunk's rows (a column
+    // kernel, or the scattered answers of its group's per-row scan) and rules combine them with AND / OR
+    void evaluateColumns(const ColumnarChunk& chunk, std::vector<std::vector<uint64_t>>& ruleRows) const override {
+        const size_t rowCount = chunk.rowCount();
+        const size_t words = (rowCount + 63) / 64;
+
+        // Group answers per pattern / value bit: bit row of groupRows[firstWord * 64 + bit]
+        thread_local std::vector<std::vector<uint64_t>> groupRows;
+        thread_local std::vector<uint64_t> found, entryFound;
+        thread_local std::string text, converted;
+        if (groupRows.size() < wordCount_ * 64) groupRows.resize(wordCount_ * 64);
+        for (size_t i = 0; i < wordCount_ * 64; ++i) groupRows[i].assign(words, 0);
+        found.resize(wordCount_);
+
+        // Text cells take their answers from a scan of their dictionary entry, other cells are scanned
+        // on their own; scanText / scanRow write groupWords words, cleared beforehand
+        auto scanColumn = [&](const ColumnarChunk::Column& column, size_t firstWord, size_t groupWords,
+                              auto scanText, auto scanRow) {
+            entryFound.assign(column.dictionary.size() * groupWords, 0);
+            for (size_t e = 0; e < column.dictionary.size(); ++e) scanText(column.dictionary[e], entryFound.data() + e * groupWords);
+            for (size_t row = 0; row < rowCount; ++row) {
+                if (!((column.present[row / 64] >> (row % 64)) & 1)) continue;
+                const uint64_t* rowFound = found.data();
+                const ColumnarChunk::CellType type = column.types[row];
+                if (type == ColumnarChunk::CellType::String || type == ColumnarChunk::CellType::Date) {
+                    rowFound = entryFound.data() + column.codes[row] * groupWords;
+                } else {
+                    std::fill(found.begin(), found.begin() + groupWords, 0);
+                    scanRow(column, row, found.data());
+                }
+                for (size_t w = 0; w < groupWords; ++w) {
+                    for (uint64_t bits = rowFound[w]; bits != 0; bits &= bits - 1) {
+                        groupRows[(firstWord + w) * 64 + countTrailingZeros(bits)][row / 64] |= uint64_t(1) << (row % 64);
+                    }
+                }
+            }
+        };
+        for (const auto& group : substringGroups_) {
+            if (group.column > chunk.columnCount()) continue;
+            auto scanText = [&](std::string_view cellText, uint64_t* out) {
+                normalizeText(cellText, group.caseSensitive, text);
+                group.matcher.scan(text, out);
+            };
+            auto scanRow = [&](const ColumnarChunk::Column& column, size_t row, uint64_t* out) {
+                scanText(columnCellText(column, row, converted), out);
+            };
+            scanColumn(chunk.column(group.column - 1), group.firstWord, group.matcher.wordCount(), scanText, scanRow);
+        }
+        for (const auto& group : equalityGroups_) {
+            if (group.column > chunk.columnCount()) continue;
+            auto scanText = [&](std::string_view cellText, uint64_t* out) { group.set.scanCellText(cellText, out); };
+            auto scanRow = [&](const ColumnarChunk::Column& column, size_t row, uint64_t* out) { group.set.scanAt(column, row, out); };
+            scanColumn(chunk.column(group.column - 1), group.firstWord, (group.set.idCount() + 63) / 64, scanText, scanRow);
+        }
+
+        std::vector<uint64_t> allRows(words, ~uint64_t(0));
+        if (rowCount % 64) allRows.back() = (uint64_t(1) << (rowCount % 64)) - 1;
+        thread_local std::vector<uint64_t> termRows;
+        termRows.resize(words);
+
+        ruleRows.resize(rules_.size());
+        for (size_t r = 0; r < rules_.size(); ++r) {
+            const CompiledRuleEntry& rule = rules_[r];
+            std::vector<uint64_t>& rows = ruleRows[r];
+            if (rule.neverMatches) {
+                rows.assign(words, 0);
+                continue;
+            }
+            if (rule.terms.empty()) {
+                rows = allRows;
+                continue;
+            }
+
+            // Same column handling as matchesRule: a term is false on rows without its cell
+            const bool andLogic = rule.logic == RuleLogic::AND;
+            rows.assign(words, andLogic ? ~uint64_t(0) : 0);
+            for (const auto& term : rule.terms) {
+                const size_t column = conditions_[term.condition].column();
+                if (column == 0 || column > chunk.columnCount()) {
+                    std::fill(termRows.begin(), termRows.end(), 0);
+                } else {
+                    termColumn(term, chunk.column(column - 1), rowCount, groupRows, termRows.data());
+                }
+                uint64_t any = 0;
+                for (size_t w = 0; w < words; ++w) {
+                    rows[w] = andLogic ? rows[w] & termRows[w] : rows[w] | termRows[w];
+                    any |= rows[w];
+                }
+                if (andLogic && any == 0) break; // No row left to match
+            }
+            for (size_t w = 0; w < words; ++w) rows[w] &= allRows[w];
+        }
+    }
+
+    std::vector<int> columns() const override {
+        std::set<int> used;
+        for (const auto& condition : conditions_) {
+            if (condition.column() > 0) used.insert(static_cast<int>(condition.column()));
+        }
+        return std::vector<int>(used.begin(), used.end());
+    }
+
+private:
+    enum class TermKind {
+        Condition,              // Evaluated on its own
+        Substring,              // Answered by a substring group
+        Equality                // Answered by an equality group
+    };
+
+    struct Term {
+        size_t condition;       // Index into conditions_
+        TermKind kind = TermKind::Condition;
+        int group = -1;
+        uint32_t bit = 0;       // Bit within the group's found words
+    };
+
+    struct CompiledRuleEntry {
+        RuleLogic logic = RuleLogic::AND;
+        bool neverMatches = false;
+        std::vector<Term> terms;
+    };
+
+    struct SubstringGroup {
+        size_t column = 0;
+        bool caseSensitive = false;
+        size_t firstWord = 0;   // Offset of this group's bits in the found words
+        MultiPatternMatcher matcher;
+    };
+
+    struct EqualityGroup {
+        size_t column;
+        size_t firstWord;
+        EqualitySet set;
+    };
+
+    bool matchesTerm(const Term& term, const DataRow& row, const std::vector<uint64_t>& found) const {
+        const CompiledCondition& condition = conditions_[term.condition];
+        if (term.kind == TermKind::Condition) return condition.matches(row.data[condition.column() - 1]);
+        size_t bit = term.bit;
+        if (term.kind == TermKind::Substring) {
+            bit += substringGroups_[term.group].firstWord * 64;
+            bool contains = (found[bit / 64] >> (bit % 64)) & 1;
+            return contains != condition.negated();
+        }
+        bit += equalityGroups_[term.group].firstWord * 64;
+        return (found[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    // A term over every row of its column, false where the row has no cell
+    void termColumn(const Term& term, const ColumnarChunk::Column& column, size_t rowCount,
+                    const std::vector<std::vector<uint64_t>>& groupRows, uint64_t* out) const {
+        const CompiledCondition& condition = conditions_[term.condition];
+        const size_t words = (rowCount + 63) / 64;
+        if (term.kind == TermKind::Condition) {
+            condition.matchColumn(column, rowCount, out);
+            return;
+        }
+        size_t bit = term.bit;
+        bit += (term.kind == TermKind::Substring ? substringGroups_[term.group].firstWord
+                                                 : equalityGroups_[term.group].firstWord) * 64;
+        const std::vector<uint64_t>& rows = groupRows[bit];
+        const bool negate = term.kind == TermKind::Substring && condition.negated();
+        for (size_t w = 0; w < words; ++w) out[w] = (negate ? ~rows[w] : rows[w]) & column.present[w];
+    }
+
+    // Same logic and column handling as the interpreter's evaluateConditions
+    bool matchesRule(const CompiledRuleEntry& rule, const DataRow& row, size_t cellCount, const std::vector<uint64_t>& found) const {
+        if (rule.neverMatches) return false;
+        if (rule.terms.empty()) return true;
+
+        if (rule.logic == RuleLogic::AND) {
+            for (const auto& term : rule.terms) {
+                size_t column = conditions_[term.condition].column();
+                if (column == 0 || column > cellCount) return false; // Column out of range
+                if (!matchesTerm(term, row, found)) return false;
+            }
+            return true;
+        }
+        for (const auto& term : rule.terms) {
+            size_t column = conditions_[term.condition].column();
+            if (column != 0 && column <= cellCount && matchesTerm(term, row, found)) return true;
+        }
+        return false;
+    }
+
+    std::vector<CompiledCondition> conditions_;
+    std::vector<CompiledRuleEntry> rules_;
+    std::unordered_map<int, int> ruleIndices_;
+    std::vector<SubstringGroup> substringGroups_;
+    std::vector<EqualityGroup> equalityGroups_;
+    size_t wordCount_ = 0;
+};
+
+// A single rule is compiled as a set of one, so OR'ed EQUAL conditions on a column still share a lookup
+class DefaultCompiledRule : public CompiledRule {
+public:
+    DefaultCompiledRule(const Rule& rule, RegexMatcher::Engine regexEngine) : set_({ rule }, regexEngine) {}
+
+    bool matches(const DataRow& row) const override {
+        thread_local std::vector<uint64_t> results;
+        set_.evaluate(row, results);
+        return results[0] & 1;
+    }
+
+private:
+    DefaultCompiledRuleSet set_;
+};
+
+} // namespace
 
 // Rule engine implementation class
 class DefaultRuleEngine : public RuleEngine {
 public:
+    explicit DefaultRuleEngine(RegexMatcher::Engine regexEngine) : regexEngine_(regexEngine) {}
+
     bool evaluateRule(const Rule& rule, const DataRow& row, const std::vector<Rule>* allRules = nullptr) const override {
         if (!rule.enabled) return false;
 
@@ -46,8 +1016,29 @@ public:
         }
     }
 
+    std::unique_ptr<CompiledRule> compileRule(const Rule& rule) const override {
+        return std::make_unique<DefaultCompiledRule>(rule, regexEngine_);
+    }
+
+    std::unique_ptr<CompiledRuleSet> compileRuleSet(const std::vector<Rule>& rules) const override {
+        return std::make_unique<DefaultCompiledRuleSet>(rules, regexEngine_);
+    }
+
     bool evaluateCondition(const RuleCondition& condition,
-                           const std::variant<std::string, int, double, bool, std::tm>& value) const override {
+                           const CellValue& value) const override {
+        // IN_LIST: EQUAL against each comma-separated item (a non-text value is a list of one)
+        if (condition.oper == Operator::IN_LIST) {
+            RuleCondition item = condition;
+            item.oper = Operator::EQUAL;
+            auto listVal = std::get_if<std::string>(&condition.value);
+            if (!listVal) return evaluateCondition(item, value);
+            for (const auto& text : splitListItems(*listVal)) {
+                item.value = text;
+                if (evaluateCondition(item, value)) return true;
+            }
+            return false;
+        }
+
         // Helper to check if operator is string-only
         auto isStringOperator = [](Operator op) {
             return op == Operator::CONTAINS || 
@@ -77,10 +1068,11 @@ public:
                     return evaluateStringCondition(condition, *boolVal ? "true" : "false");
                 }
                 return evaluateBooleanCondition(condition, *boolVal);
-            } else if (auto tmVal = std::get_if<std::tm>(&value)) {
-                // Convert tm to string for comparison
+            } else if (auto dateVal = std::get_if<CellDate>(&value)) {
+                // Convert the date to string for comparison
+                std::tm tm = dateVal->toTm();
                 std::ostringstream oss;
-                oss << std::put_time(tmVal, "%Y-%m-%d");
+                oss << std::put_time(&tm, "%Y-%m-%d");
                 return evaluateStringCondition(condition, oss.str());
             }
             return false;
@@ -123,6 +1115,8 @@ public:
     }
 
 private:
+    RegexMatcher::Engine regexEngine_;
+
     bool evaluateConditions(const Rule& rule, const DataRow& row) const {
         if (rule.conditions.empty()) return true;
 
@@ -165,7 +1159,7 @@ private:
         return evaluateConditions(rule, row);
     }
 
-    bool evaluateSingleCondition(const RuleCondition& condition, const std::variant<std::string, int, double, bool, std::tm>& value) const {
+    bool evaluateSingleCondition(const RuleCondition& condition, const CellValue& value) const {
         // Delegate to type-specific evaluation
         return evaluateCondition(condition, value);
     }
@@ -314,20 +1308,16 @@ private:
             case Operator::NOT_EMPTY:
                 return !leftValue.empty();
             case Operator::REGEX:
-                try {
-                    std::regex pattern(rightValue);
-                    // For regex, we use the original (trimmed?) value. 
-                    // Usually regex should match against the trimmed value to be consistent, 
-                    // but sometimes users want to match spaces. 
-                    // Given the "EQUAL" issue was whitespace, let's use trimmed value for consistency 
-                    // OR use original value? 
-                    // Let's use leftValue (trimmed/lowercased if insensitive) for consistency with other operators.
-                    // BUT regex usually expects case sensitivity handling via flags.
-                    // Here we already lowercased if not case_sensitive.
-                    return std::regex_match(leftValue, pattern);
-                } catch (const std::regex_error&) {
-                    return false;
-                }
+                // For regex, we use the original (trimmed?) value. 
+                // Usually regex should match against the trimmed value to be consistent, 
+                // but sometimes users want to match spaces. 
+                // Given the "EQUAL" issue was whitespace, let's use trimmed value for consistency 
+                // OR use original value? 
+                // Let's use leftValue (trimmed/lowercased if insensitive) for consistency with other operators.
+                // BUT regex usually expects case sensitivity handling via flags.
+                // Here we already lowercased if not case_sensitive.
+                // The pattern is compiled once per process, not per cell.
+                return RegexMatcher::cached(rightValue, regexEngine_)->matches(leftValue);
             default:
                 return false;
         }
@@ -409,6 +1399,7 @@ private:
 };
 
 // Factory function
-std::unique_ptr<RuleEngine> createRuleEngine() {
-    return std::make_unique<DefaultRuleEngine>();
+std::unique_ptr<RuleEngine> createRuleEngine(RegexEngine regexEngine) {
+    return std::make_unique<DefaultRuleEngine>(regexEngine == RegexEngine::StdRegex ? RegexMatcher::Engine::StdRegex
+                                                                                    : RegexMatcher::Engine::Automatic);
 }
@@ -0,0 +1,179 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t resolveThreadCount(size_t threadCount) {
+    if (threadCount > 0) return threadCount;
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t threadCount) {
+    start(resolveThreadCount(threadCount));
+}
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+void TaskScheduler::setThreadCount(size_t threadCount) {
+    threadCount = resolveThreadCount(threadCount);
+    if (threadCount == slots_.size()) return;
+    stop();
+    start(threadCount);
+}
+
+void TaskScheduler::start(size_t threadCount) {
+    stopping_ = false;
+    slots_.clear();
+    for (size_t i = 0; i < threadCount; ++i) slots_.push_back(std::make_unique<Slot>());
+    statsStart_ = nowNanoseconds();
+    for (size_t i = 1; i < threadCount; ++i) workers_.emplace_back([this, i]() { workerLoop(i); });
+}
+
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+    workers_.clear();
+}
+
+void TaskScheduler::parallelFor(size_t count, size_t morselSize, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    morselSize = std::max<size_t>(1, morselSize);
+    const size_t morselCount = (count + morselSize - 1) / morselSize;
+
+    Batch batch;
+    batch.body = &body;
+    batch.remaining = morselCount;
+
+    // A single morsel, or no workers to share with: run in order on this thread
+    if (morselCount == 1 || slots_.size() == 1) {
+        for (size_t begin = 0; begin < count; begin += morselSize) {
+            run({ &batch, begin, std::min(count, begin + morselSize) }, *slots_[0], false);
+        }
+        if (batch.error) std::rethrow_exception(batch.error);
+        return;
+    }
+
+    // Each queue gets a contiguous run of morsels, so a thread that is not stolen from walks its rows in order
+    const size_t queues = slots_.size();
+    queued_ += morselCount;
+    for (size_t q = 0; q < queues; ++q) {
+        const size_t first = morselCount * q / queues;
+        const size_t last = morselCount * (q + 1) / queues;
+        if (first == last) continue;
+        std::lock_guard<std::mutex> lock(slots_[q]->mutex);
+        for (size_t m = first; m < last; ++m) {
+            slots_[q]->queue.push_back({ &batch, m * morselSize, std::min(count, (m + 1) * morselSize) });
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+    }
+    wake_.notify_all();
+
+    // Help until the queues are empty, then wait for the morsels still running elsewhere
+    Morsel morsel;
+    bool stolen = false;
+    while (take(0, morsel, stolen)) {
+        run(morsel, *slots_[0], stolen);
+    }
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&batch]() { return batch.remaining == 0; });
+    if (batch.error) std::rethrow_exception(batch.error);
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    Morsel morsel;
+    bool stolen = false;
+    for (;;) {
+        if (take(index, morsel, stolen)) {
+            run(morsel, *slots_[index], stolen);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) return;
+    }
+}
+
+// The own queue from the front, the others from the back
+bool TaskScheduler::take(size_t index, Morsel& morsel, bool& stolen) {
+    if (queued_ == 0) return false;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        Slot& slot = *slots_[(index + i) % slots_.size()];
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        if (slot.queue.empty()) continue;
+        if (i == 0) {
+            morsel = slot.queue.front();
+            slot.queue.pop_front();
+        } else {
+            morsel = slot.queue.back();
+            slot.queue.pop_back();
+        }
+        stolen = i != 0;
+        --queued_;
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::run(const Morsel& morsel, Slot& slot, bool stolen) {
+    Batch& batch = *morsel.batch;
+    const int64_t start = nowNanoseconds();
+    std::exception_ptr error;
+    try {
+        (*batch.body)(morsel.begin, morsel.end);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    slot.busyNanoseconds += static_cast<uint64_t>(nowNanoseconds() - start);
+    slot.morsels++;
+    if (stolen) slot.steals++;
+
+    // The batch lives on its caller's stack: once remaining reaches 0 and the lock is released it may be gone
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (error && !batch.error) batch.error = error;
+    if (--batch.remaining == 0) batch.done.notify_all();
+}
+
+std::vector<TaskScheduler::WorkerStats> TaskScheduler::workerStats() const {
+    std::vector<WorkerStats> stats;
+    for (const auto& slot : slots_) {
+        WorkerStats entry;
+        entry.morsels = slot->morsels;
+        entry.steals = slot->steals;
+        entry.busySeconds = static_cast<double>(slot->busyNanoseconds) / 1e9;
+        stats.push_back(entry);
+    }
+    return stats;
+}
+
+double TaskScheduler::statsSeconds() const {
+    return static_cast<double>(nowNanoseconds() - statsStart_) / 1e9;
+}
+
+void TaskScheduler::resetStats() {
+    for (auto& slot : slots_) {
+        slot->morsels = 0;
+        slot->steals = 0;
+        slot->busyNanoseconds = 0;
+    }
+    statsStart_ = nowNanoseconds();
+}
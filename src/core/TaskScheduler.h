@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing scheduler shared by the whole core. Work is split into morsels (small ranges of rows,
+// records or other items) that are dealt out to per-thread queues; a thread whose queue runs dry takes
+// morsels from the others, so uneven morsels still keep every thread busy. The thread calling
+// parallelFor() runs morsels too, which makes nested calls from inside a morsel safe.
+class TaskScheduler {
+public:
+    struct WorkerStats {
+        uint64_t morsels = 0;       // Morsels run
+        uint64_t steals = 0;        // Of those, taken from another thread's queue
+        double busySeconds = 0.0;   // Time spent running morsels
+    };
+
+    // threadCount includes the calling thread, so 1 runs everything inline; 0 means one per hardware thread
+    explicit TaskScheduler(size_t threadCount = 0);
+    ~TaskScheduler();
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // The scheduler the reader, processData and the task loop share
+    static TaskScheduler& shared();
+
+    size_t threadCount() const { return slots_.size(); }
+    // Restarts the workers with a new count (0: one per hardware thread); must not overlap parallelFor()
+    void setThreadCount(size_t threadCount);
+
+    // Calls body(begin, end) for consecutive ranges of at most morselSize items covering [0, count) and
+    // returns once all of them have run. Ranges may run concurrently and in any order. If body throws,
+    // the remaining ranges still run and the first exception is rethrown here.
+    void parallelFor(size_t count, size_t morselSize, const std::function<void(size_t, size_t)>& body);
+
+    // One entry per thread: [0] is the threads waiting in parallelFor(), the rest are the workers
+    std::vector<WorkerStats> workerStats() const;
+    // Wall time the counters cover, for turning busySeconds into utilisation
+    double statsSeconds() const;
+    void resetStats();
+
+private:
+    struct Batch {
+        const std::function<void(size_t, size_t)>* body = nullptr;
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining = 0;       // Guarded by mutex
+        std::exception_ptr error;
+    };
+
+    struct Morsel {
+        Batch* batch;
+        size_t begin;
+        size_t end;
+    };
+
+    struct Slot {
+        std::mutex mutex;
+        std::deque<Morsel> queue;
+        std::atomic<uint64_t> morsels{ 0 };
+        std::atomic<uint64_t> steals{ 0 };
+        std::atomic<uint64_t> busyNanoseconds{ 0 };
+    };
+
+    void start(size_t threadCount);
+    void stop();
+    void workerLoop(size_t index);
+    bool take(size_t index, Morsel& morsel, bool& stolen);
+    void run(const Morsel& morsel, Slot& slot, bool stolen);
+
+    std::vector<std::unique_ptr<Slot>> slots_;  // [0] is shared by calling threads, [i] belongs to worker i
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> queued_{ 0 };           // Morsels in the queues, counted before they are pushed
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::atomic<int64_t> statsStart_{ 0 };
+};
@@ -0,0 +1,1187 @@
+#include "XlsxParser.h"
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+// Zip archive
+// ---------------------------------------------------------------------------
+
+namespace {
+
+uint16_t readLE16(const char* p) {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint16_t>(b[0] | (b[1] << 8));
+}
+
+uint32_t readLE32(const char* p) {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+uint64_t readLE64(const char* p) {
+    return static_cast<uint64_t>(readLE32(p)) | (static_cast<uint64_t>(readLE32(p + 4)) << 32);
+}
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+const uint32_t kLocalHeaderSignature = 0x04034b50;
+const uint32_t kCentralHeaderSignature = 0x02014b50;
+const uint32_t kEndOfCentralDirSignature = 0x06054b50;
+const uint32_t kZip64EndOfCentralDirSignature = 0x06064b50;
+const uint32_t kZip64LocatorSignature = 0x07064b50;
+
+} // namespace
+
+bool ZipArchive::open(const char* data, size_t size) {
+    data_ = data;
+    size_ = size;
+    entries_.clear();
+    index_.clear();
+    if (!data || size < 22) return false;
+
+    // The end-of-central-directory record is followed by a comment of up to 64 KB
+    size_t eocd = std::string::npos;
+    size_t lowest = size > 22 + 0xFFFF ? size - 22 - 0xFFFF : 0;
+    for (size_t pos = size - 22 + 1; pos-- > lowest;) {
+        if (readLE32(data + pos) == kEndOfCentralDirSignature) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd == std::string::npos) return false;
+
+    uint64_t entryCount = readLE16(data + eocd + 10);
+    uint64_t directorySize = readLE32(data + eocd + 12);
+    uint64_t directoryOffset = readLE32(data + eocd + 16);
+
+    // ZIP64: the real values live in a separate record located just before
+    if (eocd >= 20 && readLE32(data + eocd - 20) == kZip64LocatorSignature) {
+        uint64_t recordOffset = readLE64(data + eocd - 20 + 8);
+        if (recordOffset + 56 <= size && readLE32(data + recordOffset) == kZip64EndOfCentralDirSignature) {
+            entryCount = readLE64(data + recordOffset + 32);
+            directorySize = readLE64(data + recordOffset + 40);
+            directoryOffset = readLE64(data + recordOffset + 48);
+        }
+    }
+    if (directoryOffset > size || directorySize > size - directoryOffset) return false;
+
+    const char* p = data + directoryOffset;
+    const char* end = p + directorySize;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (end - p < 46 || readLE32(p) != kCentralHeaderSignature) return false;
+        uint16_t flags = readLE16(p + 8);
+        ZipEntry entry;
+        entry.method = readLE16(p + 10);
+        entry.compressedSize = readLE32(p + 20);
+        entry.uncompressedSize = readLE32(p + 24);
+        uint16_t nameLength = readLE16(p + 28);
+        uint16_t extraLength = readLE16(p + 30);
+        uint16_t commentLength = readLE16(p + 32);
+        entry.localHeaderOffset = readLE32(p + 42);
+        if (end - p < 46 + nameLength + extraLength + commentLength) return false;
+        entry.name.assign(p + 46, nameLength);
+
+        // ZIP64 extended information: only the fields saturated in the header are present, in this order
+        const char* extra = p + 46 + nameLength;
+        const char* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            uint16_t id = readLE16(extra);
+            uint16_t length = readLE16(extra + 2);
+            const char* field = extra + 4;
+            if (extraEnd - field < length) break;
+            if (id == 0x0001) {
+                const char* q = field;
+                const char* qEnd = field + length;
+                if (entry.uncompressedSize == 0xFFFFFFFFu && qEnd - q >= 8) { entry.uncompressedSize = readLE64(q); q += 8; }
+                if (entry.compressedSize == 0xFFFFFFFFu && qEnd - q >= 8) { entry.compressedSize = readLE64(q); q += 8; }
+                if (entry.localHeaderOffset == 0xFFFFFFFFu && qEnd - q >= 8) { entry.localHeaderOffset = readLE64(q); }
+            }
+            extra = field + length;
+        }
+        p += 46 + nameLength + extraLength + commentLength;
+
+        if (flags & 0x0001) continue; // Encrypted entries cannot be read
+        index_.emplace(toLower(entry.name), entries_.size());
+        entries_.push_back(std::move(entry));
+    }
+    return true;
+}
+
+const ZipEntry* ZipArchive::find(const std::string& name) const {
+    std::string key = toLower(name);
+    if (!key.empty() && key[0] == '/') key.erase(0, 1);
+    auto it = index_.find(key);
+    return it == index_.end() ? nullptr : &entries_[it->second];
+}
+
+bool ZipArchive::entryData(const ZipEntry& entry, const char*& begin, size_t& size) const {
+    uint64_t offset = entry.localHeaderOffset;
+    if (offset > size_ || size_ - offset < 30 || readLE32(data_ + offset) != kLocalHeaderSignature) return false;
+    // Sizes come from the central directory; the local header may defer them to a data descriptor
+    uint64_t dataOffset = offset + 30 + readLE16(data_ + offset + 26) + readLE16(data_ + offset + 28);
+    if (dataOffset > size_ || entry.compressedSize > size_ - dataOffset) return false;
+    begin = data_ + dataOffset;
+    size = static_cast<size_t>(entry.compressedSize);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Inflate
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const size_t kWindowSize = 32768;
+
+const uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                     257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                     7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const uint8_t kCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+} // namespace
+
+bool InflateStream::Huffman::build(const uint8_t* lengths, int n) {
+    std::memset(fast, 0, sizeof(fast));
+    std::memset(count, 0, sizeof(count));
+    for (int i = 0; i < n; ++i) count[lengths[i]]++;
+    count[0] = 0;
+
+    // Reject over-subscribed codes (incomplete ones are allowed, e.g. a single distance code)
+    int left = 1;
+    for (int len = 1; len < 16; ++len) {
+        left <<= 1;
+        left -= count[len];
+        if (left < 0) return false;
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int len = 1; len < 15; ++len) offsets[len + 1] = offsets[len] + count[len];
+    for (int i = 0; i < n; ++i) {
+        if (lengths[i]) symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+    }
+
+    // Canonical codes are assigned in (length, symbol) order; the stream stores them bit-reversed
+    int code = 0;
+    int index = 0;
+    for (int len = 1; len <= kFastBits; ++len) {
+        for (int k = 0; k < count[len]; ++k, ++code, ++index) {
+            int reversed = 0;
+            for (int b = 0; b < len; ++b) reversed |= ((code >> b) & 1) << (len - 1 - b);
+            uint16_t entry = static_cast<uint16_t>((symbol[index] << 4) | len);
+            for (int fill = reversed; fill < (1 << kFastBits); fill += 1 << len) fast[fill] = entry;
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+InflateStream::InflateStream() : window_(kWindowSize) {}
+
+void InflateStream::reset(const char* data, size_t size) {
+    in_ = reinterpret_cast<const uint8_t*>(data);
+    inEnd_ = in_ + size;
+    bitBuffer_ = 0;
+    bitCount_ = 0;
+    state_ = State::BlockHeader;
+    finalBlock_ = false;
+    storedRemaining_ = 0;
+    copyLength_ = 0;
+    copyDistance_ = 0;
+    produced_ = 0;
+}
+
+void InflateStream::refill() {
+    while (bitCount_ <= 56 && in_ < inEnd_) {
+        bitBuffer_ |= static_cast<uint64_t>(*in_++) << bitCount_;
+        bitCount_ += 8;
+    }
+}
+
+bool InflateStream::needBits(int n) {
+    if (bitCount_ < n) refill();
+    if (bitCount_ < n) {
+        state_ = State::Error;
+        return false;
+    }
+    return true;
+}
+
+uint32_t InflateStream::takeBits(int n) {
+    if (n == 0 || !needBits(n)) return 0;
+    uint32_t value = static_cast<uint32_t>(bitBuffer_ & ((uint64_t(1) << n) - 1));
+    bitBuffer_ >>= n;
+    bitCount_ -= n;
+    return value;
+}
+
+int InflateStream::decodeSymbol(const Huffman& table) {
+    if (bitCount_ < 15) refill();
+    uint16_t entry = table.fast[bitBuffer_ & ((1u << Huffman::kFastBits) - 1)];
+    if (entry) {
+        int len = entry & 15;
+        if (len > bitCount_) {
+            state_ = State::Error;
+            return -1;
+        }
+        bitBuffer_ >>= len;
+        bitCount_ -= len;
+        return entry >> 4;
+    }
+
+    // Longer code: canonical decoding one bit at a time
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; ++len) {
+        if (bitCount_ < 1) {
+            state_ = State::Error;
+            return -1;
+        }
+        code |= static_cast<int>(bitBuffer_ & 1);
+        bitBuffer_ >>= 1;
+        bitCount_ -= 1;
+        int count = table.count[len];
+        if (code - count < first) return table.symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    state_ = State::Error;
+    return -1;
+}
+
+bool InflateStream::readDynamicTables() {
+    int literalCount = static_cast<int>(takeBits(5)) + 257;
+    int distanceCount = static_cast<int>(takeBits(5)) + 1;
+    int codeLengthCount = static_cast<int>(takeBits(4)) + 4;
+    if (state_ == State::Error || literalCount > 286 || distanceCount > 30) return false;
+
+    uint8_t lengths[320] = {};
+    for (int i = 0; i < codeLengthCount; ++i) lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(takeBits(3));
+    Huffman codeLengths;
+    if (state_ == State::Error || !codeLengths.build(lengths, 19)) return false;
+
+    std::memset(lengths, 0, sizeof(lengths));
+    int total = literalCount + distanceCount;
+    for (int i = 0; i < total;) {
+        int symbol = decodeSymbol(codeLengths);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[i++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16) {
+            if (i == 0) return false;
+            value = lengths[i - 1];
+            repeat = 3 + static_cast<int>(takeBits(2));
+        } else if (symbol == 17) {
+            repeat = 3 + static_cast<int>(takeBits(3));
+        } else {
+            repeat = 11 + static_cast<int>(takeBits(7));
+        }
+        if (state_ == State::Error || i + repeat > total) return false;
+        while (repeat--) lengths[i++] = value;
+    }
+    if (lengths[256] == 0) return false; // No end-of-block code
+
+    return literals_.build(lengths, literalCount) && distances_.build(lengths + literalCount, distanceCount);
+}
+
+size_t InflateStream::read(char* out, size_t capacity) {
+    size_t n = 0;
+    while (n < capacity) {
+        // Finish a pending back reference first
+        if (copyLength_ > 0) {
+            while (copyLength_ > 0 && n < capacity) {
+                char c = window_[(produced_ - copyDistance_) & (kWindowSize - 1)];
+                window_[produced_++ & (kWindowSize - 1)] = c;
+                out[n++] = c;
+                --copyLength_;
+            }
+            continue;
+        }
+
+        if (state_ == State::BlockHeader) {
+            if (finalBlock_) {
+                state_ = State::Done;
+                break;
+            }
+            finalBlock_ = takeBits(1) != 0;
+            uint32_t type = takeBits(2);
+            if (state_ == State::Error) break;
+
+            if (type == 0) {
+                // Stored block: skip to the byte boundary, then LEN and its complement
+                takeBits(bitCount_ & 7);
+                uint32_t length = takeBits(16);
+                uint32_t complement = takeBits(16);
+                if (state_ == State::Error || (length ^ 0xFFFF) != complement) {
+                    state_ = State::Error;
+                    break;
+                }
+                storedRemaining_ = length;
+                state_ = State::Stored;
+            } else if (type == 1) {
+                static Huffman fixedLiterals;
+                static Huffman fixedDistances;
+                static const bool fixedBuilt = []() {
+                    uint8_t lengths[288];
+                    for (int i = 0; i < 144; ++i) lengths[i] = 8;
+                    for (int i = 144; i < 256; ++i) lengths[i] = 9;
+                    for (int i = 256; i < 280; ++i) lengths[i] = 7;
+                    for (int i = 280; i < 288; ++i) lengths[i] = 8;
+                    fixedLiterals.build(lengths, 288);
+                    for (int i = 0; i < 30; ++i) lengths[i] = 5;
+                    fixedDistances.build(lengths, 30);
+                    return true;
+                }();
+                (void)fixedBuilt;
+                literals_ = fixedLiterals;
+                distances_ = fixedDistances;
+                state_ = State::Compressed;
+            } else if (type == 2) {
+                if (!readDynamicTables()) {
+                    state_ = State::Error;
+                    break;
+                }
+                state_ = State::Compressed;
+            } else {
+                state_ = State::Error;
+                break;
+            }
+            continue;
+        }
+
+        if (state_ == State::Stored) {
+            if (storedRemaining_ == 0) {
+                state_ = State::BlockHeader;
+                continue;
+            }
+            if (bitCount_ == 0 && in_ < inEnd_) {
+                // Bit buffer drained: copy straight from the input
+                size_t count = std::min({ storedRemaining_, capacity - n, static_cast<size_t>(inEnd_ - in_) });
+                std::memcpy(out + n, in_, count);
+                for (size_t i = count > kWindowSize ? count - kWindowSize : 0; i < count; ++i) {
+                    window_[(produced_ + i) & (kWindowSize - 1)] = static_cast<char>(in_[i]);
+                }
+                produced_ += count;
+                in_ += count;
+                n += count;
+                storedRemaining_ -= count;
+                continue;
+            }
+            char c;
+            if (bitCount_ >= 8) {
+                c = static_cast<char>(takeBits(8)); // Whole bytes still in the bit buffer
+            } else {
+                state_ = State::Error;
+                break;
+            }
+            window_[produced_++ & (kWindowSize - 1)] = c;
+            out[n++] = c;
+            --storedRemaining_;
+            continue;
+        }
+
+        if (state_ != State::Compressed) break;
+
+        int symbol = decodeSymbol(literals_);
+        if (symbol < 0) break;
+        if (symbol < 256) {
+            char c = static_cast<char>(symbol);
+            window_[produced_++ & (kWindowSize - 1)] = c;
+            out[n++] = c;
+        } else if (symbol == 256) {
+            state_ = State::BlockHeader;
+        } else {
+            symbol -= 257;
+            if (symbol >= 29) {
+                state_ = State::Error;
+                break;
+            }
+            int length = kLengthBase[symbol] + static_cast<int>(takeBits(kLengthExtra[symbol]));
+            int distanceSymbol = decodeSymbol(distances_);
+            if (distanceSymbol < 0 || distanceSymbol >= 30) {
+                state_ = State::Error;
+                break;
+            }
+            size_t distance = kDistanceBase[distanceSymbol] + takeBits(kDistanceExtra[distanceSymbol]);
+            if (state_ == State::Error || distance > produced_ || distance > kWindowSize) {
+                state_ = State::Error;
+                break;
+            }
+            copyLength_ = length;
+            copyDistance_ = distance;
+        }
+    }
+    return n;
+}
+
+bool ZipEntryReader::open(const ZipArchive& archive, const ZipEntry& entry) {
+    const char* data = nullptr;
+    size_t size = 0;
+    failed_ = false;
+    position_ = 0;
+    expectedSize_ = entry.uncompressedSize;
+    if (!archive.entryData(entry, data, size)) {
+        failed_ = true;
+        return false;
+    }
+
+    if (entry.method == 0) {
+        deflated_ = false;
+        stored_ = data;
+        storedSize_ = size;
+    } else if (entry.method == 8) {
+        deflated_ = true;
+        inflate_.reset(data, size);
+    } else {
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+size_t ZipEntryReader::read(char* out, size_t capacity) {
+    if (failed_) return 0;
+    size_t n;
+    if (deflated_) {
+        n = inflate_.read(out, capacity);
+        if (inflate_.failed()) failed_ = true;
+    } else {
+        n = std::min(capacity, storedSize_ - position_);
+        std::memcpy(out, stored_ + position_, n);
+    }
+    position_ += n;
+    if (n == 0 && position_ != expectedSize_) failed_ = true; // Truncated or corrupt entry
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// XML
+// ---------------------------------------------------------------------------
+
+namespace {
+
+void appendUtf8(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool isXmlSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view localName(std::string_view name) {
+    size_t colon = name.find(':');
+    return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+// Excel escapes control characters in cell text as _xHHHH_
+void decodeExcelEscapes(std::string& text) {
+    if (text.find("_x") == std::string::npos) return;
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '_' && i + 6 < text.size() && text[i + 1] == 'x' && text[i + 6] == '_' &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 2])) && std::isxdigit(static_cast<unsigned char>(text[i + 3])) &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 4])) && std::isxdigit(static_cast<unsigned char>(text[i + 5]))) {
+            appendUtf8(static_cast<uint32_t>(std::strtoul(text.substr(i + 2, 4).c_str(), nullptr, 16)), out);
+            i += 6;
+        } else {
+            out += text[i];
+        }
+    }
+    text.swap(out);
+}
+
+} // namespace
+
+void decodeXmlText(std::string_view raw, std::string& out) {
+    size_t i = 0;
+    while (i < raw.size()) {
+        size_t amp = raw.find('&', i);
+        if (amp == std::string_view::npos) {
+            out.append(raw.data() + i, raw.size() - i);
+            break;
+        }
+        out.append(raw.data() + i, amp - i);
+        size_t semi = raw.find(';', amp);
+        if (semi == std::string_view::npos || semi - amp > 12) {
+            out += '&';
+            i = amp + 1;
+            continue;
+        }
+        std::string_view entity = raw.substr(amp + 1, semi - amp - 1);
+        if (entity == "lt") out += '<';
+        else if (entity == "gt") out += '>';
+        else if (entity == "amp") out += '&';
+        else if (entity == "quot") out += '"';
+        else if (entity == "apos") out += '\'';
+        else if (entity.size() > 1 && entity[0] == '#') {
+            std::string digits(entity.substr(1));
+            bool hex = !digits.empty() && (digits[0] == 'x' || digits[0] == 'X');
+            appendUtf8(static_cast<uint32_t>(std::strtoul(digits.c_str() + (hex ? 1 : 0), nullptr, hex ? 16 : 10)), out);
+        } else {
+            out.append(raw.data() + amp, semi - amp + 1); // Unknown entity kept as written
+        }
+        i = semi + 1;
+    }
+}
+
+bool XmlPullParser::fill() {
+    if (eof_) return false;
+    if (pos_ > 0) {
+        buffer_.erase(0, pos_);
+        pos_ = 0;
+    }
+    const size_t block = 64 * 1024;
+    size_t old = buffer_.size();
+    buffer_.resize(old + block);
+    size_t n = source_.read(&buffer_[old], block);
+    buffer_.resize(old + n);
+    if (n == 0) eof_ = true;
+    return n > 0;
+}
+
+// Position just past the end of the markup starting at buffer_[from] ('<'), or npos if incomplete
+size_t XmlPullParser::findMarkupEnd(size_t from) const {
+    std::string_view rest(buffer_.data() + from, buffer_.size() - from);
+    auto terminated = [&](std::string_view open, std::string_view close) -> size_t {
+        size_t end = rest.find(close, open.size());
+        return end == std::string_view::npos ? std::string::npos : from + end + close.size();
+    };
+    if (rest.size() < 2) return std::string::npos;
+    if (rest[1] == '?') return terminated("<?", "?>");
+    if (rest[1] == '!') {
+        if (rest.size() < 4) return std::string::npos;
+        if (rest.compare(0, 4, "<!--") == 0) return terminated("<!--", "-->");
+        if (rest.size() < 9) return std::string::npos;
+        if (rest.compare(0, 9, "<![CDATA[") == 0) return terminated("<![CDATA[", "]]>");
+        return terminated("<!", ">");
+    }
+
+    // Element tags: '>' may appear inside quoted attribute values
+    char quote = 0;
+    for (size_t i = 1; i < rest.size(); ++i) {
+        char c = rest[i];
+        if (quote) {
+            if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            return from + i + 1;
+        }
+    }
+    return std::string::npos;
+}
+
+void XmlPullParser::parseStartTag(size_t begin, size_t end) {
+    // buffer_[begin] is '<', buffer_[end - 1] is '>'
+    const char* p = buffer_.data() + begin + 1;
+    const char* stop = buffer_.data() + end - 1;
+    if (stop > p && stop[-1] == '/') {
+        pendingEnd_ = true;
+        --stop;
+    }
+
+    const char* nameBegin = p;
+    while (p < stop && !isXmlSpace(*p)) ++p;
+    name_ = localName(std::string_view(nameBegin, p - nameBegin));
+
+    attributes_.clear();
+    while (p < stop) {
+        while (p < stop && isXmlSpace(*p)) ++p;
+        const char* attrBegin = p;
+        while (p < stop && *p != '=' && !isXmlSpace(*p)) ++p;
+        std::string_view attrName(attrBegin, p - attrBegin);
+        while (p < stop && *p != '"' && *p != '\'') ++p;
+        if (p >= stop) break;
+        char quote = *p++;
+        const char* valueBegin = p;
+        while (p < stop && *p != quote) ++p;
+        attributes_.emplace_back(localName(attrName), std::string_view(valueBegin, p - valueBegin));
+        if (p < stop) ++p;
+    }
+}
+
+XmlPullParser::Event XmlPullParser::next() {
+    if (pendingEnd_) {
+        pendingEnd_ = false;
+        return Event::EndElement;
+    }
+
+    while (true) {
+        if (pos_ >= buffer_.size() && !fill()) return Event::End;
+
+        if (buffer_[pos_] != '<') {
+            // Character data up to the next markup, possibly spanning several input blocks
+            raw_.clear();
+            while (true) {
+                size_t lt = buffer_.find('<', pos_);
+                if (lt != std::string::npos) {
+                    raw_.append(buffer_, pos_, lt - pos_);
+                    pos_ = lt;
+                    break;
+                }
+                raw_.append(buffer_, pos_, std::string::npos);
+                pos_ = buffer_.size();
+                if (!fill()) break;
+            }
+            text_.clear();
+            decodeXmlText(raw_, text_);
+            return Event::Text;
+        }
+
+        size_t end = findMarkupEnd(pos_);
+        while (end == std::string::npos) {
+            if (!fill()) return Event::Error; // Unterminated markup
+            end = findMarkupEnd(pos_);
+        }
+
+        size_t begin = pos_;
+        pos_ = end;
+        char kind = buffer_[begin + 1];
+        if (kind == '/') {
+            const char* nameBegin = buffer_.data() + begin + 2;
+            const char* nameEnd = buffer_.data() + end - 1;
+            while (nameEnd > nameBegin && isXmlSpace(nameEnd[-1])) --nameEnd;
+            name_ = localName(std::string_view(nameBegin, nameEnd - nameBegin));
+            return Event::EndElement;
+        }
+        if (kind == '!') {
+            if (buffer_.compare(begin, 9, "<![CDATA[") == 0) {
+                text_.assign(buffer_, begin + 9, end - begin - 12);
+                return Event::Text;
+            }
+            continue; // Comment or DOCTYPE
+        }
+        if (kind == '?') continue;
+
+        parseStartTag(begin, end);
+        return Event::StartElement;
+    }
+}
+
+bool XmlPullParser::rawAttribute(std::string_view name, std::string_view& value) const {
+    for (const auto& attribute : attributes_) {
+        if (attribute.first == name) {
+            value = attribute.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string XmlPullParser::attribute(std::string_view name) const {
+    std::string value;
+    std::string_view raw;
+    if (rawAttribute(name, raw)) decodeXmlText(raw, value);
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// Workbook
+// ---------------------------------------------------------------------------
+
+CellDate excelSerialToDate(double serial, bool date1904) {
+    long days = static_cast<long>(std::floor(serial));
+    // Days since 1970-01-01. The 1900 system counts a non-existent 1900-02-29 as day 60.
+    long unixDays;
+    if (date1904) {
+        unixDays = days - 24107;
+    } else if (days >= 61) {
+        unixDays = days - 25569;
+    } else {
+        unixDays = days - 25568;
+    }
+
+    CellDate date;
+    date.seconds = static_cast<int64_t>(unixDays) * 86400;
+    return date;
+}
+
+namespace {
+
+// Resolves a relationship target relative to the part that owns the relationship
+std::string resolvePartPath(const std::string& ownerPath, const std::string& target) {
+    if (!target.empty() && target[0] == '/') return target.substr(1);
+    std::string base = ownerPath.substr(0, ownerPath.find_last_of('/') + 1);
+    std::string path = base + target;
+
+    // Collapse "dir/../"
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t slash = path.find('/', start);
+        if (slash == std::string::npos) slash = path.size();
+        std::string part = path.substr(start, slash - start);
+        if (part == "..") {
+            if (!parts.empty()) parts.pop_back();
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = slash + 1;
+    }
+    std::string result;
+    for (const auto& part : parts) {
+        if (!result.empty()) result += '/';
+        result += part;
+    }
+    return result;
+}
+
+std::string relationshipsPath(const std::string& partPath) {
+    size_t slash = partPath.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "" : partPath.substr(0, slash + 1);
+    std::string file = slash == std::string::npos ? partPath : partPath.substr(slash + 1);
+    return dir + "_rels/" + file + ".rels";
+}
+
+// Built-in number formats that Excel reports as dates or times (including the East Asian ones)
+bool isBuiltinDateFormat(int id) {
+    return (id >= 14 && id <= 22) || (id >= 27 && id <= 36) || (id >= 45 && id <= 47) || (id >= 50 && id <= 58);
+}
+
+// A custom format is a date if it uses date/time tokens outside quotes, escapes and [colour] brackets
+bool isDateFormatCode(const std::string& code) {
+    bool inQuotes = false;
+    bool inBrackets = false;
+    for (size_t i = 0; i < code.size(); ++i) {
+        char c = code[i];
+        if (inQuotes) {
+            if (c == '"') inQuotes = false;
+            continue;
+        }
+        if (inBrackets) {
+            if (c == ']') inBrackets = false;
+            continue;
+        }
+        if (c == '"') inQuotes = true;
+        else if (c == '[') inBrackets = true;
+        else if (c == '\\' || c == '_' || c == '*') ++i; // Next character is literal / padding
+        else {
+            char lower = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (lower == 'd' || lower == 'm' || lower == 'y' || lower == 'h' || lower == 's') return true;
+            if (lower == 'g' && code.compare(i, 7, "General") == 0) i += 6;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool XlsxWorkbook::readRelationships(const std::string& partPath, std::map<std::string, std::string>& targets,
+                                     std::map<std::string, std::string>* byType) {
+    std::string relsPath = relationshipsPath(partPath);
+    const ZipEntry* entry = archive_.find(relsPath);
+    if (!entry) return false;
+
+    ZipEntryReader reader;
+    if (!reader.open(archive_, *entry)) return false;
+    XmlPullParser parser(reader);
+    XmlPullParser::Event event;
+    while ((event = parser.next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) return false;
+        if (event != XmlPullParser::Event::StartElement || parser.name() != "Relationship") continue;
+        std::string target = parser.attribute("Target");
+        if (parser.attribute("TargetMode") == "External") continue;
+        std::string resolved = resolvePartPath(partPath, target);
+        targets[parser.attribute("Id")] = resolved;
+        if (byType) {
+            std::string type = parser.attribute("Type");
+            (*byType)[type.substr(type.find_last_of('/') + 1)] = resolved;
+        }
+    }
+    return !reader.failed();
+}
+
+bool XlsxWorkbook::readWorkbook(const std::string& path, std::vector<std::pair<std::string, std::string>>& sheetIds) {
+    const ZipEntry* entry = archive_.find(path);
+    if (!entry) return false;
+
+    ZipEntryReader reader;
+    if (!reader.open(archive_, *entry)) return false;
+    XmlPullParser parser(reader);
+    XmlPullParser::Event event;
+    while ((event = parser.next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) return false;
+        if (event != XmlPullParser::Event::StartElement) continue;
+        if (parser.name() == "workbookPr") {
+            std::string value = parser.attribute("date1904");
+            date1904_ = value == "1" || value == "true";
+        } else if (parser.name() == "sheet") {
+            sheetIds.emplace_back(parser.attribute("name"), parser.attribute("id"));
+        }
+    }
+    return !reader.failed();
+}
+
+bool XlsxWorkbook::readSharedStrings(const std::string& path) {
+    const ZipEntry* entry = archive_.find(path);
+    if (!entry) return true; // Workbooks without text have no shared string table
+
+    ZipEntryReader reader;
+    if (!reader.open(archive_, *entry)) return false;
+    XmlPullParser parser(reader);
+
+    // <si> holds either one <t> or rich-text runs <r><t/></r>; phonetic hints (<rPh>) are not part of the text
+    std::string current;
+    bool inItem = false;
+    bool inText = false;
+    int phoneticDepth = 0;
+    XmlPullParser::Event event;
+    while ((event = parser.next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) return false;
+        if (event == XmlPullParser::Event::StartElement) {
+            if (parser.name() == "sst") {
+                std::string_view count;
+                if (parser.rawAttribute("uniqueCount", count)) {
+                    sharedStrings_.reserve(std::min<size_t>(std::strtoul(std::string(count).c_str(), nullptr, 10), 1 << 24));
+                }
+            } else if (parser.name() == "si") {
+                inItem = true;
+                current.clear();
+            } else if (parser.name() == "rPh") {
+                ++phoneticDepth;
+            } else if (parser.name() == "t") {
+                inText = inItem && phoneticDepth == 0;
+            }
+        } else if (event == XmlPullParser::Event::EndElement) {
+            if (parser.name() == "si") {
+                decodeExcelEscapes(current);
+                sharedStrings_.push_back(current);
+                inItem = false;
+            } else if (parser.name() == "rPh") {
+                --phoneticDepth;
+            } else if (parser.name() == "t") {
+                inText = false;
+            }
+        } else if (inText) {
+            current += parser.text();
+        }
+    }
+    return !reader.failed();
+}
+
+bool XlsxWorkbook::readStyles(const std::string& path) {
+    const ZipEntry* entry = archive_.find(path);
+    if (!entry) return true;
+
+    ZipEntryReader reader;
+    if (!reader.open(archive_, *entry)) return false;
+    XmlPullParser parser(reader);
+
+    std::map<int, bool> customFormats; // numFmtId -> is a date
+    bool inCellXfs = false;
+    XmlPullParser::Event event;
+    while ((event = parser.next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) return false;
+        if (event == XmlPullParser::Event::StartElement) {
+            if (parser.name() == "numFmt") {
+                int id = std::atoi(parser.attribute("numFmtId").c_str());
+                customFormats[id] = isDateFormatCode(parser.attribute("formatCode"));
+            } else if (parser.name() == "cellXfs") {
+                inCellXfs = true;
+            } else if (parser.name() == "xf" && inCellXfs) {
+                int id = std::atoi(parser.attribute("numFmtId").c_str());
+                auto it = customFormats.find(id);
+                dateStyles_.push_back(it != customFormats.end() ? it->second : isBuiltinDateFormat(id));
+            }
+        } else if (event == XmlPullParser::Event::EndElement && parser.name() == "cellXfs") {
+            inCellXfs = false;
+        }
+    }
+    return !reader.failed();
+}
+
+bool XlsxWorkbook::open(const std::string& filename) {
+    sheets_.clear();
+    sharedStrings_.clear();
+    dateStyles_.clear();
+    date1904_ = false;
+    error_.clear();
+
+    if (!file_.open(filename) || !archive_.open(file_.data(), file_.size())) {
+        error_ = "Not a readable xlsx (zip) file: " + filename;
+        return false;
+    }
+
+    // _rels/.rels names the workbook part; fall back to the conventional location
+    std::map<std::string, std::string> rootTargets;
+    std::map<std::string, std::string> rootByType;
+    std::string workbookPath = "xl/workbook.xml";
+    if (readRelationships("", rootTargets, &rootByType) && rootByType.count("officeDocument")) {
+        workbookPath = rootByType["officeDocument"];
+    }
+
+    std::vector<std::pair<std::string, std::string>> sheetIds;
+    if (!readWorkbook(workbookPath, sheetIds)) {
+        error_ = "Unable to read workbook part: " + workbookPath;
+        return false;
+    }
+
+    std::map<std::string, std::string> targets;
+    std::map<std::string, std::string> byType;
+    readRelationships(workbookPath, targets, &byType);
+    for (const auto& sheet : sheetIds) {
+        auto it = targets.find(sheet.second);
+        if (it == targets.end()) continue; // Chart sheets and dangling ids
+        sheets_.push_back({ sheet.first, it->second });
+    }
+
+    std::string base = workbookPath.substr(0, workbookPath.find_last_of('/') + 1);
+    std::string sharedStringsPath = byType.count("sharedStrings") ? byType["sharedStrings"] : base + "sharedStrings.xml";
+    std::string stylesPath = byType.count("styles") ? byType["styles"] : base + "styles.xml";
+    if (!readSharedStrings(sharedStringsPath)) {
+        error_ = "Unable to read shared strings: " + sharedStringsPath;
+        return false;
+    }
+    if (!readStyles(stylesPath)) {
+        error_ = "Unable to read styles: " + stylesPath;
+        return false;
+    }
+    return true;
+}
+
+const XlsxSheetInfo* XlsxWorkbook::findSheet(const std::string& name) const {
+    if (sheets_.empty()) return nullptr;
+    if (name.empty()) return &sheets_.front();
+    std::string key = toLower(name);
+    for (const auto& sheet : sheets_) {
+        if (toLower(sheet.name) == key) return &sheet;
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Worksheet
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// "BC12" -> column 55 (1-based) and row 12; either may be 0 if absent
+void parseCellReference(std::string_view ref, int& column, int& row) {
+    column = 0;
+    row = 0;
+    size_t i = 0;
+    while (i < ref.size() && std::isalpha(static_cast<unsigned char>(ref[i]))) {
+        column = column * 26 + (std::toupper(static_cast<unsigned char>(ref[i])) - 'A' + 1);
+        ++i;
+    }
+    while (i < ref.size() && ref[i] == '$') ++i;
+    while (i < ref.size() && std::isdigit(static_cast<unsigned char>(ref[i]))) {
+        row = row * 10 + (ref[i] - '0');
+        ++i;
+    }
+}
+
+// Cell values are written in the C locale ("1234.5", "1E-3")
+bool parseNumber(const std::string& text, double& value) {
+#if defined(__cpp_lib_to_chars)
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    if (begin < end && *begin == '+') ++begin;
+    auto res = std::from_chars(begin, end, value);
+    return res.ec == std::errc() && res.ptr != text.data();
+#else
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str();
+#endif
+}
+
+int parseInt(std::string_view text) {
+    int value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') break;
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+} // namespace
+
+bool XlsxSheetReader::open(const XlsxWorkbook& workbook, const XlsxSheetInfo& sheet) {
+    workbook_ = &workbook;
+    dimensionColumns_ = 0;
+    dimensionRows_ = 0;
+    lastRow_ = 0;
+    inSheetData_ = false;
+    done_ = false;
+    failed_ = false;
+
+    const ZipEntry* entry = workbook.archive().find(sheet.path);
+    if (!entry || !entry_.open(workbook.archive(), *entry)) {
+        failed_ = true;
+        return false;
+    }
+    parser_ = std::make_unique<XmlPullParser>(entry_);
+
+    // Everything before <sheetData> is metadata; keep the dimension for padding rows
+    XmlPullParser::Event event;
+    while ((event = parser_->next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) {
+            failed_ = true;
+            return false;
+        }
+        if (event != XmlPullParser::Event::StartElement) continue;
+        if (parser_->name() == "dimension") {
+            std::string ref = parser_->attribute("ref");
+            int column = 0, row = 0;
+            parseCellReference(ref.substr(ref.find(':') == std::string::npos ? 0 : ref.find(':') + 1), column, row);
+            dimensionColumns_ = column;
+            dimensionRows_ = row;
+        } else if (parser_->name() == "sheetData") {
+            inSheetData_ = true;
+            return true;
+        }
+    }
+    done_ = true; // No sheet data at all
+    return !entry_.failed();
+}
+
+bool XlsxSheetReader::readCell(std::vector<CellValue>& cells, int& column) {
+    std::string_view raw;
+    int row = 0;
+    int cellColumn = 0;
+    if (parser_->rawAttribute("r", raw)) parseCellReference(raw, cellColumn, row);
+    column = cellColumn > 0 ? cellColumn : column + 1;
+
+    std::string type = parser_->rawAttribute("t", raw) ? std::string(raw) : std::string();
+    int style = parser_->rawAttribute("s", raw) ? parseInt(raw) : 0;
+
+    // Collect the <v> value or the inline string (<is><t>...</t></is>, rich runs concatenated)
+    value_.clear();
+    bool hasValue = false;
+    bool inValue = false;
+    bool inText = false;
+    int phoneticDepth = 0;
+    XmlPullParser::Event event;
+    while ((event = parser_->next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) return false;
+        if (event == XmlPullParser::Event::StartElement) {
+            std::string_view name = parser_->name();
+            if (name == "v") {
+                inValue = true;
+                hasValue = true;
+            } else if (name == "rPh") {
+                ++phoneticDepth;
+            } else if (name == "t") {
+                inText = phoneticDepth == 0;
+                hasValue = true;
+            }
+        } else if (event == XmlPullParser::Event::EndElement) {
+            std::string_view name = parser_->name();
+            if (name == "c") break;
+            if (name == "v") inValue = false;
+            else if (name == "t") inText = false;
+            else if (name == "rPh") --phoneticDepth;
+        } else if (inValue || inText) {
+            value_ += parser_->text();
+        }
+    }
+    if (event == XmlPullParser::Event::End) return false;
+
+    if (static_cast<int>(cells.size()) < column - 1) cells.resize(column - 1, std::string());
+    if (static_cast<int>(cells.size()) < column) cells.emplace_back();
+    auto& cell = cells[column - 1];
+    if (!hasValue) return true; // Styled but empty
+
+    if (type == "s") {
+        size_t index = static_cast<size_t>(std::strtoul(value_.c_str(), nullptr, 10));
+        const auto& strings = workbook_->sharedStrings();
+        cell = index < strings.size() ? strings[index] : std::string();
+    } else if (type == "inlineStr" || type == "str" || type == "e") {
+        decodeExcelEscapes(value_);
+        cell = value_;
+    } else if (type == "b") {
+        cell = value_ == "1" || value_ == "true";
+    } else if (type == "d") {
+        // ISO 8601 date
+        int year = std::atoi(value_.c_str());
+        int month = 1, day = 1;
+        if (value_.size() >= 10) {
+            month = std::atoi(value_.c_str() + 5);
+            day = std::atoi(value_.c_str() + 8);
+        }
+        cell = CellDate::fromDate(year, month, day);
+    } else {
+        double number = 0;
+        if (!parseNumber(value_, number)) {
+            cell = value_;
+        } else if (workbook_->isDateStyle(style)) {
+            cell = excelSerialToDate(number, workbook_->uses1904Dates());
+        } else {
+            cell = number;
+        }
+    }
+    return true;
+}
+
+bool XlsxSheetReader::nextRow(int& rowNumber, std::vector<CellValue>& cells) {
+    if (done_ || failed_ || !parser_) return false;
+
+    XmlPullParser::Event event;
+    while ((event = parser_->next()) != XmlPullParser::Event::End) {
+        if (event == XmlPullParser::Event::Error) break;
+        if (event == XmlPullParser::Event::EndElement && parser_->name() == "sheetData") {
+            done_ = true;
+            return false;
+        }
+        if (event != XmlPullParser::Event::StartElement || parser_->name() != "row") continue;
+
+        std::string_view raw;
+        int number = parser_->rawAttribute("r", raw) ? parseInt(raw) : 0;
+        rowNumber = number > 0 ? number : lastRow_ + 1;
+        lastRow_ = rowNumber;
+        cells.clear();
+
+        int column = 0;
+        while ((event = parser_->next()) != XmlPullParser::Event::End) {
+            if (event == XmlPullParser::Event::Error) break;
+            if (event == XmlPullParser::Event::EndElement && parser_->name() == "row") break;
+            if (event == XmlPullParser::Event::StartElement && parser_->name() == "c") {
+                if (!readCell(cells, column)) {
+                    failed_ = true;
+                    return false;
+                }
+            }
+        }
+        if (event != XmlPullParser::Event::EndElement) break;
+
+        if (static_cast<int>(cells.size()) < dimensionColumns_) cells.resize(dimensionColumns_, std::string());
+        return true;
+    }
+
+    failed_ = true; // Input ended inside <sheetData>
+    return false;
+}
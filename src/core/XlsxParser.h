@@ -0,0 +1,218 @@
+#pragma once
+
+#include "ExcelProcessorCore.h"
+#include "CsvParser.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+// One file stored in a zip archive, as listed in the central directory
+struct ZipEntry {
+    std::string name;
+    uint16_t method = 0;             // 0 = stored, 8 = deflate
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
+};
+
+// Read-only view of a zip archive held in memory. The central directory is read once by open();
+// entry contents are located on demand (ZIP64 archives are supported, encrypted entries are not).
+class ZipArchive {
+public:
+    bool open(const char* data, size_t size);
+
+    const std::vector<ZipEntry>& entries() const { return entries_; }
+    // Looks an entry up by path; zip paths are compared case-insensitively, as Excel does
+    const ZipEntry* find(const std::string& name) const;
+    // Locates the (possibly compressed) bytes of an entry inside the archive
+    bool entryData(const ZipEntry& entry, const char*& begin, size_t& size) const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<ZipEntry> entries_;
+    std::map<std::string, size_t> index_;  // Lower-case name -> entries_ position
+};
+
+// Streaming raw DEFLATE (RFC 1951) decoder over a memory buffer.
+// Output is produced in caller-sized pieces; only the 32 KB history window is kept between calls.
+class InflateStream {
+public:
+    InflateStream();
+    void reset(const char* data, size_t size);
+
+    // Inflates up to capacity bytes into out; returns the number written (0 once the stream has ended)
+    size_t read(char* out, size_t capacity);
+
+    bool atEnd() const { return state_ == State::Done; }
+    bool failed() const { return state_ == State::Error; }
+
+    // Huffman decoding table: a direct lookup for codes up to kFastBits long, canonical decoding beyond that
+    struct Huffman {
+        static constexpr int kFastBits = 10;
+        uint16_t fast[1 << kFastBits];   // (symbol << 4) | length, 0 if the code is longer than kFastBits
+        uint16_t count[16];
+        uint16_t symbol[288];
+        bool build(const uint8_t* lengths, int n);
+    };
+
+private:
+    enum class State { BlockHeader, Stored, Compressed, Done, Error };
+
+    void refill();
+    bool needBits(int n);
+    uint32_t takeBits(int n);
+    int decodeSymbol(const Huffman& table);
+    bool readDynamicTables();
+
+    const uint8_t* in_ = nullptr;
+    const uint8_t* inEnd_ = nullptr;
+    uint64_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+
+    State state_ = State::Done;
+    bool finalBlock_ = false;
+    size_t storedRemaining_ = 0;
+    int copyLength_ = 0;
+    size_t copyDistance_ = 0;
+
+    Huffman literals_;
+    Huffman distances_;
+
+    std::vector<char> window_;       // Last 32 KB of output, for back references
+    size_t produced_ = 0;            // Total bytes produced so far
+};
+
+// Reads the uncompressed contents of one zip entry, stored or deflated
+class ZipEntryReader {
+public:
+    bool open(const ZipArchive& archive, const ZipEntry& entry);
+    size_t read(char* out, size_t capacity);
+    bool failed() const { return failed_; }
+
+private:
+    const char* stored_ = nullptr;
+    size_t storedSize_ = 0;
+    size_t position_ = 0;
+    bool deflated_ = false;
+    uint64_t expectedSize_ = 0;
+    bool failed_ = false;
+    InflateStream inflate_;
+};
+
+// Minimal pull XML tokenizer for the SpreadsheetML parts of an .xlsx file.
+// Input is pulled from the entry in blocks, so memory use does not depend on the part size.
+// Element and attribute names are reported without their namespace prefix; a self-closing
+// element produces a StartElement followed by an EndElement. Comments, processing instructions
+// and DOCTYPE are skipped. Names and raw attribute values are valid until the next call to next().
+class XmlPullParser {
+public:
+    enum class Event { StartElement, EndElement, Text, End, Error };
+
+    explicit XmlPullParser(ZipEntryReader& source) : source_(source) {}
+
+    Event next();
+
+    std::string_view name() const { return name_; }
+    // Attribute value as written (entities not decoded); false if absent
+    bool rawAttribute(std::string_view localName, std::string_view& value) const;
+    // Attribute value with entities decoded; empty if absent
+    std::string attribute(std::string_view localName) const;
+    // Decoded text of the last Text event
+    const std::string& text() const { return text_; }
+
+private:
+    bool fill();
+    size_t findMarkupEnd(size_t from) const;
+    void parseStartTag(size_t begin, size_t end);
+
+    ZipEntryReader& source_;
+    std::string buffer_;
+    size_t pos_ = 0;
+    bool eof_ = false;
+    bool pendingEnd_ = false;
+
+    std::string_view name_;
+    std::vector<std::pair<std::string_view, std::string_view>> attributes_;
+    std::string raw_;
+    std::string text_;
+};
+
+// Appends text with XML entities (&amp; &#123; ...) decoded
+void decodeXmlText(std::string_view raw, std::string& out);
+
+// Converts an Excel date serial number to a calendar date (time of day is dropped)
+CellDate excelSerialToDate(double serial, bool date1904);
+
+struct XlsxSheetInfo {
+    std::string name;
+    std::string path;                // Part name inside the archive, e.g. "xl/worksheets/sheet1.xml"
+};
+
+// Workbook-level parts of an .xlsx file, parsed once by open(): the sheet list, the shared string
+// table and which cell styles are dates. The file stays memory-mapped until the workbook is destroyed.
+class XlsxWorkbook {
+public:
+    bool open(const std::string& filename);
+
+    const std::vector<XlsxSheetInfo>& sheets() const { return sheets_; }
+    // Case-insensitive lookup; an empty name selects the first sheet
+    const XlsxSheetInfo* findSheet(const std::string& name) const;
+
+    const std::vector<std::string>& sharedStrings() const { return sharedStrings_; }
+    bool isDateStyle(int styleIndex) const {
+        return styleIndex >= 0 && styleIndex < static_cast<int>(dateStyles_.size()) && dateStyles_[styleIndex];
+    }
+    bool uses1904Dates() const { return date1904_; }
+    const ZipArchive& archive() const { return archive_; }
+    const std::string& error() const { return error_; }
+
+private:
+    bool readRelationships(const std::string& partPath, std::map<std::string, std::string>& targets,
+                           std::map<std::string, std::string>* byType = nullptr);
+    bool readWorkbook(const std::string& path, std::vector<std::pair<std::string, std::string>>& sheetIds);
+    bool readSharedStrings(const std::string& path);
+    bool readStyles(const std::string& path);
+
+    MappedFile file_;
+    ZipArchive archive_;
+    std::vector<XlsxSheetInfo> sheets_;
+    std::vector<std::string> sharedStrings_;
+    std::vector<bool> dateStyles_;   // Per cellXfs index
+    bool date1904_ = false;
+    std::string error_;
+};
+
+// Streams one worksheet row by row; only the current row is held in memory.
+// Cells are placed by their column reference, with gaps (and short rows, up to the sheet's
+// <dimension>) filled with empty strings. Numbers are doubles, date-formatted numbers become
+// CellDate, booleans bool, and shared/inline/formula strings std::string.
+class XlsxSheetReader {
+public:
+    bool open(const XlsxWorkbook& workbook, const XlsxSheetInfo& sheet);
+
+    // Reads the next <row>; returns false at the end of the sheet data or on error (see failed())
+    bool nextRow(int& rowNumber, std::vector<CellValue>& cells);
+
+    // Last column / row of the <dimension> reference, 0 if the sheet has none
+    int dimensionColumns() const { return dimensionColumns_; }
+    int dimensionRows() const { return dimensionRows_; }
+    bool failed() const { return failed_; }
+
+private:
+    bool readCell(std::vector<CellValue>& cells, int& column);
+
+    const XlsxWorkbook* workbook_ = nullptr;
+    ZipEntryReader entry_;
+    std::unique_ptr<XmlPullParser> parser_;
+    int dimensionColumns_ = 0;
+    int dimensionRows_ = 0;
+    int lastRow_ = 0;
+    bool inSheetData_ = false;
+    bool done_ = false;
+    bool failed_ = false;
+    std::string value_;
+};
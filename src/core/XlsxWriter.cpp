@@ -0,0 +1,1166 @@
+#include "XlsxWriter.h"
+#include <QSaveFile>
+#include <QTemporaryFile>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// CRC-32
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct Crc32Table {
+    uint32_t entries[256];
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            entries[i] = crc;
+        }
+    }
+};
+
+const Crc32Table kCrc32Table;
+
+// Multiplies a 32x32 bit matrix over GF(2) by a vector
+uint32_t gf2MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+    uint32_t sum = 0;
+    for (; vector; vector >>= 1, ++matrix) {
+        if (vector & 1) sum ^= *matrix;
+    }
+    return sum;
+}
+
+void gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+    for (int n = 0; n < 32; ++n) square[n] = gf2MatrixTimes(matrix, matrix[n]);
+}
+
+} // namespace
+
+uint32_t crc32Update(uint32_t crc, const char* data, size_t size) {
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) crc = kCrc32Table.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Same method as zlib's crc32_combine: applies lengthB zero bytes to crcA by repeated matrix squaring
+uint32_t crc32Combine(uint32_t crcA, uint32_t crcB, uint64_t lengthB) {
+    if (lengthB == 0) return crcA;
+
+    uint32_t even[32];
+    uint32_t odd[32];
+    odd[0] = 0xEDB88320u; // Operator for one zero bit
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    gf2MatrixSquare(even, odd); // Two zero bits
+    gf2MatrixSquare(odd, even); // Four zero bits
+
+    do {
+        gf2MatrixSquare(even, odd);
+        if (lengthB & 1) crcA = gf2MatrixTimes(even, crcA);
+        lengthB >>= 1;
+        if (lengthB == 0) break;
+        gf2MatrixSquare(odd, even);
+        if (lengthB & 1) crcA = gf2MatrixTimes(odd, crcA);
+        lengthB >>= 1;
+    } while (lengthB != 0);
+    return crcA ^ crcB;
+}
+
+// ---------------------------------------------------------------------------
+// Deflate
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const size_t kWindowSize = 32768;
+const size_t kBlockInput = 65536;
+const int kHashBits = 15;
+const size_t kMinMatch = 3;
+const size_t kMaxMatch = 258;
+const int kMaxChain = 24;             // Hash chain entries tried per position
+const size_t kNiceLength = 128;       // Stop searching once a match is this long
+const size_t kMaxInsertLength = 16;   // Longer matches are not indexed position by position
+const uint32_t kMatchFlag = 0x80000000u;
+
+const uint16_t kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                   35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t kDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                     257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const uint8_t kDistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                     7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const uint8_t kCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Symbol lookups: length - 3 -> length code, and distance - 1 -> distance code as in zlib
+// (below 256 directly, above that by (distance - 1) >> 7, since those bases are 128-aligned)
+struct SymbolTables {
+    uint8_t lengthCode[256];
+    uint8_t distanceCode[512];
+    SymbolTables() {
+        for (int code = 0; code < 29; ++code) {
+            int end = code == 28 ? 256 : kLengthBase[code + 1] - 3;
+            for (int length = kLengthBase[code] - 3; length < end; ++length) lengthCode[length] = static_cast<uint8_t>(code);
+        }
+        for (int d = 0; d < 512; ++d) {
+            int distance = d < 256 ? d + 1 : ((d - 256) << 7) + 1;
+            int code = 29;
+            while (kDistanceBase[code] > distance) --code;
+            distanceCode[d] = static_cast<uint8_t>(code);
+        }
+    }
+};
+
+const SymbolTables kSymbols;
+
+inline int distanceCode(uint32_t distance) {
+    uint32_t d = distance - 1;
+    return d < 256 ? kSymbols.distanceCode[d] : kSymbols.distanceCode[256 + (d >> 7)];
+}
+
+inline uint32_t hash3(const uint8_t* p) {
+    uint32_t v = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16);
+    return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+inline int countTrailingZeros(uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline size_t matchLength(const uint8_t* a, const uint8_t* b, size_t maxLength) {
+    size_t n = 0;
+    while (n + 8 <= maxLength) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, a + n, 8);
+        std::memcpy(&y, b + n, 8);
+        if (x != y) return n + countTrailingZeros(x ^ y) / 8; // Little-endian: lowest byte first
+        n += 8;
+    }
+    while (n < maxLength && a[n] == b[n]) ++n;
+    return n;
+}
+
+inline uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t result = 0;
+    for (int i = 0; i < length; ++i) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+// Huffman code lengths for the given frequencies, at most maxBits long. Lengths come from the
+// Huffman tree; overlong codes are then folded back within maxBits the way miniz does it.
+void buildCodeLengths(const uint32_t* frequency, int n, int maxBits, uint8_t* lengths) {
+    std::memset(lengths, 0, n);
+    std::vector<int> symbols;
+    for (int s = 0; s < n; ++s) {
+        if (frequency[s]) symbols.push_back(s);
+    }
+    if (symbols.empty()) return;
+    if (symbols.size() == 1) {
+        lengths[symbols[0]] = 1;
+        return;
+    }
+    std::stable_sort(symbols.begin(), symbols.end(), [&](int a, int b) { return frequency[a] < frequency[b]; });
+
+    // Two-queue construction: leaves in frequency order, internal nodes in creation order
+    size_t leafCount = symbols.size();
+    std::vector<uint64_t> weight(2 * leafCount - 1);
+    std::vector<int> parent(2 * leafCount - 1, -1);
+    for (size_t i = 0; i < leafCount; ++i) weight[i] = frequency[symbols[i]];
+    size_t nextLeaf = 0;
+    size_t nextInternal = leafCount;
+    for (size_t node = leafCount; node < 2 * leafCount - 1; ++node) {
+        size_t picked[2];
+        for (size_t& pick : picked) {
+            if (nextLeaf < leafCount && (nextInternal >= node || weight[nextLeaf] <= weight[nextInternal])) pick = nextLeaf++;
+            else pick = nextInternal++;
+        }
+        weight[node] = weight[picked[0]] + weight[picked[1]];
+        parent[picked[0]] = static_cast<int>(node);
+        parent[picked[1]] = static_cast<int>(node);
+    }
+
+    std::vector<int> depth(2 * leafCount - 1, 0);
+    int lengthCount[33] = {};
+    for (size_t node = 2 * leafCount - 1; node-- > 0;) {
+        if (parent[node] >= 0) depth[node] = depth[parent[node]] + 1;
+        if (node < leafCount) lengthCount[std::min(depth[node], 32)]++;
+    }
+
+    for (int len = maxBits + 1; len <= 32; ++len) {
+        lengthCount[maxBits] += lengthCount[len];
+        lengthCount[len] = 0;
+    }
+    uint32_t total = 0;
+    for (int len = maxBits; len > 0; --len) total += static_cast<uint32_t>(lengthCount[len]) << (maxBits - len);
+    while (total != (1u << maxBits)) {
+        lengthCount[maxBits]--;
+        for (int len = maxBits - 1; len > 0; --len) {
+            if (lengthCount[len]) {
+                lengthCount[len]--;
+                lengthCount[len + 1] += 2;
+                break;
+            }
+        }
+        total--;
+    }
+
+    // Shortest codes for the most frequent symbols
+    size_t next = leafCount;
+    for (int len = 1; len <= maxBits; ++len) {
+        for (int i = 0; i < lengthCount[len]; ++i) lengths[symbols[--next]] = static_cast<uint8_t>(len);
+    }
+}
+
+// Canonical codes, bit-reversed because DEFLATE writes Huffman codes starting from their top bit
+void buildCodes(const uint8_t* lengths, int n, uint32_t* codes) {
+    int count[16] = {};
+    for (int s = 0; s < n; ++s) count[lengths[s]]++;
+    count[0] = 0;
+    uint32_t next[16] = {};
+    uint32_t code = 0;
+    for (int len = 1; len < 16; ++len) {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (int s = 0; s < n; ++s) {
+        codes[s] = lengths[s] ? reverseBits(next[lengths[s]]++, lengths[s]) : 0;
+    }
+}
+
+} // namespace
+
+DeflateEncoder::DeflateEncoder()
+    : head_(size_t(1) << kHashBits, -1), prev_(kWindowSize + kBlockInput, -1) {
+    buffer_.reserve(kWindowSize + kBlockInput);
+    tokens_.reserve(kBlockInput);
+}
+
+void DeflateEncoder::write(const char* data, size_t size) {
+    while (size > 0) {
+        size_t room = historySize_ + kBlockInput - buffer_.size();
+        size_t n = std::min(room, size);
+        buffer_.insert(buffer_.end(), reinterpret_cast<const uint8_t*>(data), reinterpret_cast<const uint8_t*>(data) + n);
+        data += n;
+        size -= n;
+        if (buffer_.size() - historySize_ >= kBlockInput) compressPending(false);
+    }
+}
+
+void DeflateEncoder::finish(bool finalBlock) {
+    if (finalBlock || buffer_.size() > historySize_) compressPending(finalBlock);
+    if (!finalBlock) {
+        // Empty stored block: ends the stream on a byte boundary without closing it
+        putBits(0, 3);
+        alignToByte();
+        putBits(0, 16);
+        putBits(0xFFFF, 16);
+    }
+    alignToByte();
+}
+
+void DeflateEncoder::compressPending(bool finalBlock) {
+    std::memset(literalFrequency_, 0, sizeof(literalFrequency_));
+    std::memset(distanceFrequency_, 0, sizeof(distanceFrequency_));
+    tokens_.clear();
+
+    const uint8_t* data = buffer_.data();
+    const size_t start = historySize_;
+    const size_t end = buffer_.size();
+    size_t i = start;
+    while (i < end) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+        if (end - i >= kMinMatch) {
+            uint32_t h = hash3(data + i);
+            int32_t candidate = head_[h];
+            prev_[i] = candidate;
+            head_[h] = static_cast<int32_t>(i);
+
+            size_t maxLength = std::min(kMaxMatch, end - i);
+            for (int chain = kMaxChain; candidate >= 0 && chain > 0; --chain) {
+                size_t distance = i - static_cast<size_t>(candidate);
+                if (distance > kWindowSize) break;
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + i;
+                if (a[bestLength] == b[bestLength] && a[0] == b[0] && a[1] == b[1]) {
+                    size_t length = matchLength(a, b, maxLength);
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length >= kNiceLength || length == maxLength) break;
+                    }
+                }
+                candidate = prev_[candidate];
+            }
+        }
+
+        if (bestLength >= kMinMatch) {
+            tokens_.push_back(kMatchFlag | static_cast<uint32_t>((bestLength - 3) << 15) | static_cast<uint32_t>(bestDistance - 1));
+            literalFrequency_[257 + kSymbols.lengthCode[bestLength - 3]]++;
+            distanceFrequency_[distanceCode(static_cast<uint32_t>(bestDistance))]++;
+            if (bestLength <= kMaxInsertLength) {
+                for (size_t k = i + 1; k < i + bestLength && end - k >= kMinMatch; ++k) {
+                    uint32_t h = hash3(data + k);
+                    prev_[k] = head_[h];
+                    head_[h] = static_cast<int32_t>(k);
+                }
+            }
+            i += bestLength;
+        } else {
+            tokens_.push_back(data[i]);
+            literalFrequency_[data[i]]++;
+            ++i;
+        }
+    }
+    literalFrequency_[256] = 1;
+
+    writeBlock(tokens_.data(), tokens_.size(), data + start, end - start, finalBlock);
+    slideWindow();
+}
+
+void DeflateEncoder::writeBlock(const uint32_t* tokens, size_t tokenCount, const uint8_t* raw, size_t rawSize, bool finalBlock) {
+    uint8_t literalLengths[286];
+    uint8_t distanceLengths[30];
+    buildCodeLengths(literalFrequency_, 286, 15, literalLengths);
+    if (std::all_of(distanceFrequency_, distanceFrequency_ + 30, [](uint32_t f) { return f == 0; })) {
+        distanceFrequency_[0] = 1; // A block still needs one distance code
+    }
+    buildCodeLengths(distanceFrequency_, 30, 15, distanceLengths);
+
+    int literalCount = 286;
+    while (literalCount > 257 && literalLengths[literalCount - 1] == 0) --literalCount;
+    int distanceCount = 30;
+    while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) --distanceCount;
+
+    // Run-length encode both length tables with symbols 16 (repeat), 17 and 18 (zeros)
+    uint8_t all[316];
+    std::memcpy(all, literalLengths, literalCount);
+    std::memcpy(all + literalCount, distanceLengths, distanceCount);
+    int allCount = literalCount + distanceCount;
+    struct Run { uint8_t symbol, extra; };
+    Run runs[316];
+    int runCount = 0;
+    uint32_t codeLengthFrequency[19] = {};
+    for (int i = 0; i < allCount;) {
+        int run = 1;
+        while (i + run < allCount && all[i + run] == all[i]) ++run;
+        if (all[i] == 0 && run >= 11) {
+            run = std::min(run, 138);
+            runs[runCount++] = { 18, static_cast<uint8_t>(run - 11) };
+        } else if (all[i] == 0 && run >= 3) {
+            run = std::min(run, 10);
+            runs[runCount++] = { 17, static_cast<uint8_t>(run - 3) };
+        } else if (i > 0 && all[i] == all[i - 1] && run >= 3) {
+            run = std::min(run, 6);
+            runs[runCount++] = { 16, static_cast<uint8_t>(run - 3) };
+        } else {
+            run = 1;
+            runs[runCount++] = { all[i], 0 };
+        }
+        codeLengthFrequency[runs[runCount - 1].symbol]++;
+        i += run;
+    }
+    uint8_t codeLengthLengths[19];
+    buildCodeLengths(codeLengthFrequency, 19, 7, codeLengthLengths);
+    int codeLengthCount = 19;
+    while (codeLengthCount > 4 && codeLengthLengths[kCodeLengthOrder[codeLengthCount - 1]] == 0) --codeLengthCount;
+
+    // Compare with storing the block as is
+    uint64_t dynamicBits = 3 + 5 + 5 + 4 + 3 * codeLengthCount;
+    for (int r = 0; r < runCount; ++r) {
+        uint8_t symbol = runs[r].symbol;
+        dynamicBits += codeLengthLengths[symbol] + (symbol == 16 ? 2 : symbol == 17 ? 3 : symbol == 18 ? 7 : 0);
+    }
+    for (int s = 0; s < 286; ++s) {
+        dynamicBits += static_cast<uint64_t>(literalFrequency_[s]) * (literalLengths[s] + (s > 256 ? kLengthExtra[s - 257] : 0));
+    }
+    for (int s = 0; s < 30; ++s) dynamicBits += static_cast<uint64_t>(distanceFrequency_[s]) * (distanceLengths[s] + kDistanceExtra[s]);
+    uint64_t storedBits = (rawSize / 65535 + 1) * 40 + 8 + static_cast<uint64_t>(rawSize) * 8;
+
+    if (storedBits < dynamicBits) {
+        size_t offset = 0;
+        do {
+            size_t length = std::min<size_t>(rawSize - offset, 65535);
+            bool last = offset + length == rawSize;
+            putBits(finalBlock && last ? 1 : 0, 1);
+            putBits(0, 2);
+            alignToByte();
+            putBits(static_cast<uint32_t>(length), 16);
+            putBits(static_cast<uint32_t>(length ^ 0xFFFF), 16);
+            output_.append(reinterpret_cast<const char*>(raw + offset), length);
+            offset += length;
+        } while (offset < rawSize);
+        return;
+    }
+
+    uint32_t literalCodes[286];
+    uint32_t distanceCodes[30];
+    uint32_t codeLengthCodes[19];
+    buildCodes(literalLengths, 286, literalCodes);
+    buildCodes(distanceLengths, 30, distanceCodes);
+    buildCodes(codeLengthLengths, 19, codeLengthCodes);
+
+    putBits(finalBlock ? 1 : 0, 1);
+    putBits(2, 2);
+    putBits(literalCount - 257, 5);
+    putBits(distanceCount - 1, 5);
+    putBits(codeLengthCount - 4, 4);
+    for (int i = 0; i < codeLengthCount; ++i) putBits(codeLengthLengths[kCodeLengthOrder[i]], 3);
+    for (int r = 0; r < runCount; ++r) {
+        uint8_t symbol = runs[r].symbol;
+        putBits(codeLengthCodes[symbol], codeLengthLengths[symbol]);
+        if (symbol == 16) putBits(runs[r].extra, 2);
+        else if (symbol == 17) putBits(runs[r].extra, 3);
+        else if (symbol == 18) putBits(runs[r].extra, 7);
+    }
+
+    for (size_t t = 0; t < tokenCount; ++t) {
+        uint32_t token = tokens[t];
+        if (!(token & kMatchFlag)) {
+            putBits(literalCodes[token], literalLengths[token]);
+            continue;
+        }
+        uint32_t length = ((token >> 15) & 0xFF) + 3;
+        uint32_t distance = (token & 0x7FFF) + 1;
+        int lengthSymbol = kSymbols.lengthCode[length - 3];
+        putBits(literalCodes[257 + lengthSymbol], literalLengths[257 + lengthSymbol]);
+        putBits(length - kLengthBase[lengthSymbol], kLengthExtra[lengthSymbol]);
+        int distanceSymbol = distanceCode(distance);
+        putBits(distanceCodes[distanceSymbol], distanceLengths[distanceSymbol]);
+        putBits(distance - kDistanceBase[distanceSymbol], kDistanceExtra[distanceSymbol]);
+    }
+    putBits(literalCodes[256], literalLengths[256]);
+}
+
+void DeflateEncoder::putBits(uint32_t value, int count) {
+    bitBuffer_ |= static_cast<uint64_t>(value) << bitCount_;
+    bitCount_ += count;
+    if (bitCount_ >= 32) {
+        char bytes[4] = { static_cast<char>(bitBuffer_), static_cast<char>(bitBuffer_ >> 8),
+                          static_cast<char>(bitBuffer_ >> 16), static_cast<char>(bitBuffer_ >> 24) };
+        output_.append(bytes, 4);
+        bitBuffer_ >>= 32;
+        bitCount_ -= 32;
+    }
+}
+
+void DeflateEncoder::alignToByte() {
+    while (bitCount_ > 0) {
+        output_ += static_cast<char>(bitBuffer_ & 0xFF);
+        bitBuffer_ >>= 8;
+        bitCount_ -= 8;
+    }
+    bitBuffer_ = 0;
+    bitCount_ = 0;
+}
+
+// Keeps the last 32 KB as history for the next block and rebases the hash chains onto it
+void DeflateEncoder::slideWindow() {
+    size_t keep = std::min(kWindowSize, buffer_.size());
+    size_t shift = buffer_.size() - keep;
+    if (shift > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + shift, keep);
+        buffer_.resize(keep);
+        const int32_t offset = static_cast<int32_t>(shift);
+        for (auto& position : head_) position = position >= offset ? position - offset : -1;
+        for (size_t k = 0; k < keep; ++k) {
+            int32_t position = prev_[k + shift];
+            prev_[k] = position >= offset ? position - offset : -1;
+        }
+    }
+    historySize_ = keep;
+}
+
+// ---------------------------------------------------------------------------
+// Zip writer
+// ---------------------------------------------------------------------------
+
+namespace {
+
+void putLE16(std::string& out, uint32_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>((value >> 8) & 0xFF);
+}
+
+void putLE32(std::string& out, uint32_t value) {
+    putLE16(out, value & 0xFFFF);
+    putLE16(out, value >> 16);
+}
+
+void putLE64(std::string& out, uint64_t value) {
+    putLE32(out, static_cast<uint32_t>(value));
+    putLE32(out, static_cast<uint32_t>(value >> 32));
+}
+
+const uint32_t kSaturated32 = 0xFFFFFFFFu;
+const uint16_t kUtf8NamesFlag = 0x0800;
+
+} // namespace
+
+ZipWriter::ZipWriter() {
+    // Entries are stamped with the local time the archive was started, in MS-DOS format
+    std::time_t now = std::time(nullptr);
+    std::tm local = {};
+#if defined(_WIN32)
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    int year = std::max(local.tm_year + 1900, 1980);
+    dosTime_ = static_cast<uint16_t>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    dosDate_ = static_cast<uint16_t>(((year - 1980) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+}
+
+ZipWriter::~ZipWriter() = default;
+
+bool ZipWriter::open(const std::string& filename) {
+    file_ = std::make_unique<QSaveFile>(QString::fromStdString(filename));
+    offset_ = 0;
+    entries_.clear();
+    failed_ = !file_->open(QIODevice::WriteOnly);
+    return !failed_;
+}
+
+bool ZipWriter::beginEntry(const std::string& name, uint16_t method, uint32_t crc, uint64_t compressedSize, uint64_t uncompressedSize) {
+    Entry entry;
+    entry.info.name = name;
+    entry.info.method = method;
+    entry.info.compressedSize = compressedSize;
+    entry.info.uncompressedSize = uncompressedSize;
+    entry.info.localHeaderOffset = offset_;
+    entry.crc = crc;
+
+    bool zip64 = compressedSize >= kSaturated32 || uncompressedSize >= kSaturated32;
+    std::string header;
+    putLE32(header, 0x04034b50);
+    putLE16(header, zip64 ? 45 : 20);
+    putLE16(header, kUtf8NamesFlag);
+    putLE16(header, method);
+    putLE16(header, dosTime_);
+    putLE16(header, dosDate_);
+    putLE32(header, crc);
+    putLE32(header, zip64 ? kSaturated32 : static_cast<uint32_t>(compressedSize));
+    putLE32(header, zip64 ? kSaturated32 : static_cast<uint32_t>(uncompressedSize));
+    putLE16(header, static_cast<uint32_t>(name.size()));
+    putLE16(header, zip64 ? 20 : 0);
+    header += name;
+    if (zip64) {
+        putLE16(header, 0x0001);
+        putLE16(header, 16);
+        putLE64(header, uncompressedSize);
+        putLE64(header, compressedSize);
+    }
+
+    entries_.push_back(std::move(entry));
+    return write(header.data(), header.size());
+}
+
+bool ZipWriter::write(const char* data, size_t size) {
+    if (failed_ || !file_) return false;
+    if (size > 0 && file_->write(data, static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+        failed_ = true;
+        return false;
+    }
+    offset_ += size;
+    return true;
+}
+
+bool ZipWriter::addEntry(const std::string& name, const std::string& content) {
+    DeflateEncoder encoder;
+    encoder.write(content.data(), content.size());
+    encoder.finish();
+    const std::string& compressed = encoder.output();
+    return beginEntry(name, 8, crc32Update(0, content.data(), content.size()), compressed.size(), content.size()) &&
+           write(compressed.data(), compressed.size());
+}
+
+bool ZipWriter::commit() {
+    if (failed_ || !file_) return false;
+
+    uint64_t directoryOffset = offset_;
+    std::string directory;
+    for (const auto& entry : entries_) {
+        const ZipEntry& info = entry.info;
+        // ZIP64 extended information holds only the saturated fields, in this order
+        std::string extra;
+        if (info.uncompressedSize >= kSaturated32) putLE64(extra, info.uncompressedSize);
+        if (info.compressedSize >= kSaturated32) putLE64(extra, info.compressedSize);
+        if (info.localHeaderOffset >= kSaturated32) putLE64(extra, info.localHeaderOffset);
+        if (!extra.empty()) {
+            std::string field;
+            putLE16(field, 0x0001);
+            putLE16(field, static_cast<uint32_t>(extra.size()));
+            extra.insert(0, field);
+        }
+        uint16_t version = extra.empty() ? 20 : 45;
+
+        putLE32(directory, 0x02014b50);
+        putLE16(directory, version);
+        putLE16(directory, version);
+        putLE16(directory, kUtf8NamesFlag);
+        putLE16(directory, info.method);
+        putLE16(directory, dosTime_);
+        putLE16(directory, dosDate_);
+        putLE32(directory, entry.crc);
+        putLE32(directory, static_cast<uint32_t>(std::min<uint64_t>(info.compressedSize, kSaturated32)));
+        putLE32(directory, static_cast<uint32_t>(std::min<uint64_t>(info.uncompressedSize, kSaturated32)));
+        putLE16(directory, static_cast<uint32_t>(info.name.size()));
+        putLE16(directory, static_cast<uint32_t>(extra.size()));
+        putLE16(directory, 0);   // Comment
+        putLE16(directory, 0);   // Disk number
+        putLE16(directory, 0);   // Internal attributes
+        putLE32(directory, 0);   // External attributes
+        putLE32(directory, static_cast<uint32_t>(std::min<uint64_t>(info.localHeaderOffset, kSaturated32)));
+        directory += info.name;
+        directory += extra;
+    }
+    if (!write(directory.data(), directory.size())) return false;
+
+    uint64_t directorySize = directory.size();
+    uint64_t entryCount = entries_.size();
+    std::string end;
+    if (entryCount >= 0xFFFF || directoryOffset >= kSaturated32 || directorySize >= kSaturated32) {
+        uint64_t recordOffset = offset_;
+        putLE32(end, 0x06064b50);
+        putLE64(end, 44);          // Size of the rest of the record
+        putLE16(end, 45);
+        putLE16(end, 45);
+        putLE32(end, 0);
+        putLE32(end, 0);
+        putLE64(end, entryCount);
+        putLE64(end, entryCount);
+        putLE64(end, directorySize);
+        putLE64(end, directoryOffset);
+
+        putLE32(end, 0x07064b50);
+        putLE32(end, 0);
+        putLE64(end, recordOffset);
+        putLE32(end, 1);
+    }
+    putLE32(end, 0x06054b50);
+    putLE16(end, 0);
+    putLE16(end, 0);
+    putLE16(end, static_cast<uint32_t>(std::min<uint64_t>(entryCount, 0xFFFF)));
+    putLE16(end, static_cast<uint32_t>(std::min<uint64_t>(entryCount, 0xFFFF)));
+    putLE32(end, static_cast<uint32_t>(std::min<uint64_t>(directorySize, kSaturated32)));
+    putLE32(end, static_cast<uint32_t>(std::min<uint64_t>(directoryOffset, kSaturated32)));
+    putLE16(end, 0);
+    if (!write(end.data(), end.size())) return false;
+
+    bool ok = file_->commit();
+    file_.reset();
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Part spool
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const size_t kSpoolMemoryLimit = 8 << 20;
+
+} // namespace
+
+PartSpool::PartSpool() = default;
+PartSpool::~PartSpool() = default;
+
+bool PartSpool::append(const char* data, size_t size) {
+    if (!file_ && memory_.size() + size <= kSpoolMemoryLimit) {
+        memory_.append(data, size);
+        size_ += size;
+        return true;
+    }
+    if (!file_) {
+        file_ = std::make_unique<QTemporaryFile>();
+        if (!file_->open()) return false;
+        if (!memory_.empty() && file_->write(memory_.data(), static_cast<qint64>(memory_.size())) != static_cast<qint64>(memory_.size())) {
+            return false;
+        }
+        std::string().swap(memory_);
+    }
+    if (file_->write(data, static_cast<qint64>(size)) != static_cast<qint64>(size)) return false;
+    size_ += size;
+    return true;
+}
+
+bool PartSpool::copyTo(ZipWriter& zip) {
+    if (!file_) return zip.write(memory_.data(), memory_.size());
+
+    if (!file_->seek(0)) return false;
+    std::vector<char> block(1 << 20);
+    uint64_t remaining = size_;
+    while (remaining > 0) {
+        qint64 n = file_->read(block.data(), static_cast<qint64>(std::min<uint64_t>(remaining, block.size())));
+        if (n <= 0 || !zip.write(block.data(), static_cast<size_t>(n))) return false;
+        remaining -= static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Workbook writer
+// ---------------------------------------------------------------------------
+
+namespace {
+
+const int kMaxRows = 1048576;
+const int kMaxColumns = 16384;
+const size_t kSheetFlushSize = 64 * 1024;
+
+const char kXmlDeclaration[] = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+const char kMainNamespace[] = "http://schemas.openxmlformats.org/spreadsheetml/2006/main";
+const char kRelationshipsNamespace[] = "http://schemas.openxmlformats.org/package/2006/relationships";
+const char kDocumentRelationships[] = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+
+// Cell style indices in styles.xml
+const int kDateStyle = 1;        // Built-in format 14 (short date)
+const int kDateTimeStyle = 2;    // Built-in format 22 (date and time)
+
+bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// Escapes text for element content or attribute values. Control characters XML cannot hold are
+// written as _xHHHH_, and a literal "_xHHHH_" gets its underscore escaped so it reads back unchanged.
+void appendEscaped(std::string& out, const std::string& text) {
+    static const char kHex[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        case '_':
+            if (i + 6 < text.size() && text[i + 1] == 'x' && isHexDigit(text[i + 2]) && isHexDigit(text[i + 3]) &&
+                isHexDigit(text[i + 4]) && isHexDigit(text[i + 5]) && text[i + 6] == '_') {
+                out += "_x005F_";
+            } else {
+                out += c;
+            }
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20 && c != '\t' && c != '\n') {
+                out += "_x00";
+                out += kHex[(c >> 4) & 0xF];
+                out += kHex[c & 0xF];
+                out += '_';
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+void appendColumnName(std::string& out, int column) {
+    char letters[4];
+    int n = 0;
+    while (column > 0) {
+        letters[n++] = static_cast<char>('A' + (column - 1) % 26);
+        column = (column - 1) / 26;
+    }
+    while (n > 0) out += letters[--n];
+}
+
+void appendInteger(std::string& out, long long value) {
+    char buffer[24];
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, res.ptr);
+#else
+    int n = std::snprintf(buffer, sizeof(buffer), "%lld", value);
+    if (n > 0) out.append(buffer, static_cast<size_t>(n));
+#endif
+}
+
+// Shortest text that reads back as the same double
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, res.ptr);
+#else
+    int n = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    if (n > 0) out.append(buffer, static_cast<size_t>(n));
+#endif
+}
+
+// Excel serial number in the 1900 date system (which counts the non-existent 1900-02-29); false if
+// the date lies before 1900-01-01
+bool dateToExcelSerial(const CellDate& date, double& serial) {
+    // The inverse of excelSerialToDate
+    int64_t unixDays = date.days();
+    int64_t days = unixDays + 25569 >= 61 ? unixDays + 25569 : unixDays + 25568;
+    if (days < 1) return false;
+    serial = static_cast<double>(days) + static_cast<double>(date.seconds - unixDays * 86400) / 86400.0;
+    return true;
+}
+
+std::string toLowerAscii(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+} // namespace
+
+struct XlsxWorkbookWriter::Sheet {
+    std::string name;
+    DeflateEncoder encoder;
+    PartSpool spool;
+    std::string xml;          // Row XML not compressed yet
+    uint32_t crc = 0;         // Of all row XML so far
+    uint64_t size = 0;
+    int lastRow = 0;
+    int lastColumn = 0;
+    bool spoolFailed = false;
+};
+
+XlsxWorkbookWriter::XlsxWorkbookWriter() = default;
+XlsxWorkbookWriter::~XlsxWorkbookWriter() = default;
+
+std::string XlsxWorkbookWriter::validSheetName(const std::string& name) {
+    std::string result;
+    int characters = 0;
+    for (size_t i = 0; i < name.size() && characters < 31; ++characters) {
+        unsigned char c = static_cast<unsigned char>(name[i]);
+        size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+        length = std::min(length, name.size() - i);
+        if (length == 1 && (c < 0x20 || std::strchr("[]:*?/\\", c))) result += '_';
+        else result.append(name, i, length);
+        i += length;
+    }
+    // Excel does not allow a leading or trailing apostrophe
+    if (!result.empty() && result.front() == '\'') result.front() = '_';
+    if (!result.empty() && result.back() == '\'') result.back() = '_';
+    return result.empty() ? "Sheet1" : result;
+}
+
+int XlsxWorkbookWriter::findSheet(const std::string& name) const {
+    std::string key = toLowerAscii(validSheetName(name));
+    for (size_t i = 0; i < sheets_.size(); ++i) {
+        if (toLowerAscii(sheets_[i]->name) == key) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int XlsxWorkbookWriter::addSheet(const std::string& name) {
+    auto sheet = std::make_unique<Sheet>();
+    sheet->name = validSheetName(name);
+    sheets_.push_back(std::move(sheet));
+    return static_cast<int>(sheets_.size()) - 1;
+}
+
+void XlsxWorkbookWriter::clearSheet(int index) {
+    auto sheet = std::make_unique<Sheet>();
+    sheet->name = sheets_[index]->name;
+    sheets_[index] = std::move(sheet);
+}
+
+bool XlsxWorkbookWriter::isSheetEmpty(int index) const {
+    return sheets_[index]->lastRow == 0;
+}
+
+bool XlsxWorkbookWriter::load(const std::string& filename) {
+    XlsxWorkbook workbook;
+    if (!workbook.open(filename)) {
+        error_ = workbook.error();
+        return false;
+    }
+
+    std::vector<CellValue> cells;
+    for (const auto& info : workbook.sheets()) {
+        int index = addSheet(info.name);
+        XlsxSheetReader reader;
+        if (!reader.open(workbook, info)) {
+            error_ = "Cannot read sheet " + info.name + " in " + filename;
+            return false;
+        }
+        int rowNumber = 0;
+        while (reader.nextRow(rowNumber, cells)) {
+            if (!writeRow(index, std::max(rowNumber, sheets_[index]->lastRow + 1), cells)) return false;
+        }
+        if (reader.failed()) {
+            error_ = "Corrupt sheet data in " + filename;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool XlsxWorkbookWriter::appendRows(int index, const std::vector<DataRow>& rows) {
+    Sheet& sheet = *sheets_[index];
+    for (const auto& row : rows) {
+        if (!writeRow(index, sheet.lastRow + 1, row.data)) return false;
+    }
+    return true;
+}
+
+bool XlsxWorkbookWriter::writeRow(int index, int rowNumber, const std::vector<CellValue>& cells) {
+    Sheet& sheet = *sheets_[index];
+    if (rowNumber > kMaxRows) {
+        error_ = "Sheet " + sheet.name + " exceeds Excel's limit of 1048576 rows";
+        return false;
+    }
+    if (static_cast<int>(cells.size()) > kMaxColumns) {
+        error_ = "Row exceeds Excel's limit of 16384 columns";
+        return false;
+    }
+    sheet.lastRow = rowNumber;
+
+    // Rows without any value are left out of the XML but still take their row number
+    size_t rowStart = sheet.xml.size();
+    sheet.xml += "<row r=\"";
+    appendInteger(sheet.xml, rowNumber);
+    sheet.xml += "\">";
+    size_t cellsStart = sheet.xml.size();
+    for (size_t c = 0; c < cells.size(); ++c) {
+        appendCell(sheet, static_cast<int>(c) + 1, rowNumber, cells[c]);
+    }
+    if (sheet.xml.size() == cellsStart) {
+        sheet.xml.resize(rowStart);
+    } else {
+        sheet.xml += "</row>";
+    }
+
+    if (sheet.xml.size() >= kSheetFlushSize && !flushSheet(sheet, false)) return false;
+    return true;
+}
+
+void XlsxWorkbookWriter::appendCell(Sheet& sheet, int column, int rowNumber, const CellValue& value) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        if (text->empty()) return;
+    }
+
+    std::string& xml = sheet.xml;
+    xml += "<c r=\"";
+    appendColumnName(xml, column);
+    appendInteger(xml, rowNumber);
+    xml += '"';
+    if (column > sheet.lastColumn) sheet.lastColumn = column;
+
+    std::visit([&](const auto& val) {
+        using T = std::decay_t<decltype(val)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            xml += " t=\"s\"><v>";
+            appendInteger(xml, sharedString(val));
+        } else if constexpr (std::is_same_v<T, int>) {
+            xml += "><v>";
+            appendInteger(xml, val);
+        } else if constexpr (std::is_same_v<T, double>) {
+            if (std::isfinite(val)) {
+                xml += "><v>";
+                appendNumber(xml, val);
+            } else {
+                xml += " t=\"e\"><v>#NUM!"; // Excel has no NaN or infinity
+            }
+        } else if constexpr (std::is_same_v<T, bool>) {
+            xml += " t=\"b\"><v>";
+            xml += val ? '1' : '0';
+        } else if constexpr (std::is_same_v<T, CellDate>) {
+            double serial = 0;
+            if (dateToExcelSerial(val, serial)) {
+                xml += val.hasTime() ? " s=\"2\"><v>" : " s=\"1\"><v>";
+                appendNumber(xml, serial);
+            } else {
+                // Before 1900 Excel has no serial number for the date, so it is kept as text
+                std::tm tm = val.toTm();
+                char buffer[64];
+                size_t n = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", &tm);
+                xml += " t=\"s\"><v>";
+                appendInteger(xml, sharedString(std::string(buffer, n)));
+            }
+        }
+    }, value);
+    xml += "</v></c>";
+}
+
+uint32_t XlsxWorkbookWriter::sharedString(const std::string& text) {
+    ++stringReferences_;
+    auto it = stringIndex_.find(text);
+    if (it != stringIndex_.end()) return it->second;
+    uint32_t index = static_cast<uint32_t>(strings_.size());
+    auto inserted = stringIndex_.emplace(text, index).first;
+    strings_.push_back(&inserted->first);
+    return index;
+}
+
+bool XlsxWorkbookWriter::flushSheet(Sheet& sheet, bool finalBlock) {
+    if (!sheet.xml.empty()) {
+        sheet.crc = crc32Update(sheet.crc, sheet.xml.data(), sheet.xml.size());
+        sheet.size += sheet.xml.size();
+        sheet.encoder.write(sheet.xml.data(), sheet.xml.size());
+        sheet.xml.clear();
+    }
+    if (finalBlock) sheet.encoder.finish();
+
+    std::string& compressed = sheet.encoder.output();
+    if (!compressed.empty()) {
+        if (!sheet.spool.append(compressed.data(), compressed.size())) sheet.spoolFailed = true;
+        compressed.clear();
+    }
+    if (sheet.spoolFailed) {
+        error_ = "Cannot write temporary data for sheet " + sheet.name;
+        return false;
+    }
+    return true;
+}
+
+bool XlsxWorkbookWriter::save(const std::string& filename) {
+    if (sheets_.empty()) addSheet("Sheet1");
+    const size_t sheetCount = sheets_.size();
+
+    std::string contentTypes = kXmlDeclaration;
+    contentTypes += "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+                    "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+                    "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+                    "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>";
+    for (size_t i = 1; i <= sheetCount; ++i) {
+        contentTypes += "<Override PartName=\"/xl/worksheets/sheet" + std::to_string(i) +
+                        ".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    contentTypes += "<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+                    "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
+                    "</Types>";
+
+    std::string rootRelationships = kXmlDeclaration;
+    rootRelationships += std::string("<Relationships xmlns=\"") + kRelationshipsNamespace + "\">"
+                         "<Relationship Id=\"rId1\" Type=\"" + kDocumentRelationships + "/officeDocument\" Target=\"xl/workbook.xml\"/>"
+                         "</Relationships>";
+
+    std::string workbook = kXmlDeclaration;
+    workbook += std::string("<workbook xmlns=\"") + kMainNamespace + "\" xmlns:r=\"" + kDocumentRelationships + "\"><sheets>";
+    std::string workbookRelationships = kXmlDeclaration;
+    workbookRelationships += std::string("<Relationships xmlns=\"") + kRelationshipsNamespace + "\">";
+    for (size_t i = 1; i <= sheetCount; ++i) {
+        std::string id = std::to_string(i);
+        workbook += "<sheet name=\"";
+        appendEscaped(workbook, sheets_[i - 1]->name);
+        workbook += "\" sheetId=\"" + id + "\" r:id=\"rId" + id + "\"/>";
+        workbookRelationships += "<Relationship Id=\"rId" + id + "\" Type=\"" + kDocumentRelationships +
+                                 "/worksheet\" Target=\"worksheets/sheet" + id + ".xml\"/>";
+    }
+    workbook += "</sheets></workbook>";
+    workbookRelationships += "<Relationship Id=\"rId" + std::to_string(sheetCount + 1) + "\" Type=\"" + kDocumentRelationships +
+                             "/styles\" Target=\"styles.xml\"/>"
+                             "<Relationship Id=\"rId" + std::to_string(sheetCount + 2) + "\" Type=\"" + kDocumentRelationships +
+                             "/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+                             "</Relationships>";
+
+    std::string styles = kXmlDeclaration;
+    styles += std::string("<styleSheet xmlns=\"") + kMainNamespace + "\">"
+              "<fonts count=\"1\"><font><sz val=\"11\"/><name val=\"Calibri\"/><family val=\"2\"/></font></fonts>"
+              "<fills count=\"2\"><fill><patternFill patternType=\"none\"/></fill><fill><patternFill patternType=\"gray125\"/></fill></fills>"
+              "<borders count=\"1\"><border><left/><right/><top/><bottom/><diagonal/></border></borders>"
+              "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+              "<cellXfs count=\"3\">"
+              "<xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+              "<xf numFmtId=\"14\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+              "<xf numFmtId=\"22\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\" applyNumberFormat=\"1\"/>"
+              "</cellXfs>"
+              "<cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+              "</styleSheet>";
+    static_assert(kDateStyle == 1 && kDateTimeStyle == 2, "cellXfs order in styles.xml");
+
+    ZipWriter zip;
+    if (!zip.open(filename)) {
+        error_ = "Cannot create " + filename;
+        return false;
+    }
+    bool ok = zip.addEntry("[Content_Types].xml", contentTypes) &&
+              zip.addEntry("_rels/.rels", rootRelationships) &&
+              zip.addEntry("xl/workbook.xml", workbook) &&
+              zip.addEntry("xl/_rels/workbook.xml.rels", workbookRelationships) &&
+              zip.addEntry("xl/styles.xml", styles);
+
+    // Each sheet's row XML is already compressed; the part starts with a separately compressed
+    // header holding the <dimension>, which is only known now. The header stream ends on a byte
+    // boundary without a final block, so the two DEFLATE streams simply follow each other.
+    for (size_t i = 0; ok && i < sheetCount; ++i) {
+        Sheet& sheet = *sheets_[i];
+        sheet.xml += "</sheetData></worksheet>";
+        if (!flushSheet(sheet, true)) return false;
+
+        std::string header = kXmlDeclaration;
+        header += std::string("<worksheet xmlns=\"") + kMainNamespace + "\" xmlns:r=\"" + kDocumentRelationships + "\"><dimension ref=\"A1";
+        if (sheet.lastRow > 0) {
+            header += ':';
+            appendColumnName(header, std::max(sheet.lastColumn, 1));
+            appendInteger(header, sheet.lastRow);
+        }
+        header += "\"/><sheetData>";
+        DeflateEncoder headerEncoder;
+        headerEncoder.write(header.data(), header.size());
+        headerEncoder.finish(false);
+        const std::string& compressedHeader = headerEncoder.output();
+
+        uint32_t crc = crc32Combine(crc32Update(0, header.data(), header.size()), sheet.crc, sheet.size);
+        ok = zip.beginEntry("xl/worksheets/sheet" + std::to_string(i + 1) + ".xml", 8, crc,
+                            compressedHeader.size() + sheet.spool.size(), header.size() + sheet.size) &&
+             zip.write(compressedHeader.data(), compressedHeader.size()) &&
+             sheet.spool.copyTo(zip);
+    }
+
+    // The shared string table goes last, once every cell has been seen
+    if (ok) {
+        DeflateEncoder encoder;
+        PartSpool spool;
+        uint32_t crc = 0;
+        uint64_t size = 0;
+        std::string xml = kXmlDeclaration;
+        xml += std::string("<sst xmlns=\"") + kMainNamespace + "\" count=\"" + std::to_string(stringReferences_) +
+               "\" uniqueCount=\"" + std::to_string(strings_.size()) + "\">";
+        auto flush = [&](bool finalBlock) {
+            crc = crc32Update(crc, xml.data(), xml.size());
+            size += xml.size();
+            encoder.write(xml.data(), xml.size());
+            xml.clear();
+            if (finalBlock) encoder.finish();
+            bool written = spool.append(encoder.output().data(), encoder.output().size());
+            encoder.output().clear();
+            return written;
+        };
+        for (const std::string* text : strings_) {
+            bool preserve = !text->empty() && (std::isspace(static_cast<unsigned char>(text->front())) ||
+                                               std::isspace(static_cast<unsigned char>(text->back())));
+            xml += preserve ? "<si><t xml:space=\"preserve\">" : "<si><t>";
+            appendEscaped(xml, *text);
+            xml += "</t></si>";
+            if (xml.size() >= kSheetFlushSize && !flush(false)) ok = false;
+        }
+        xml += "</sst>";
+        ok = ok && flush(true) &&
+             zip.beginEntry("xl/sharedStrings.xml", 8, crc, spool.size(), size) &&
+             spool.copyTo(zip);
+    }
+
+    if (!ok || !zip.commit()) {
+        error_ = "Cannot write " + filename;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "ExcelProcessorCore.h"
+#include "XlsxParser.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+class QSaveFile;
+class QTemporaryFile;
+
+// CRC-32 as used by zip, continued from crc (start with 0)
+uint32_t crc32Update(uint32_t crc, const char* data, size_t size);
+// CRC-32 of A followed by B, from the CRCs of both parts and the length of B
+uint32_t crc32Combine(uint32_t crcA, uint32_t crcB, uint64_t lengthB);
+
+// Streaming raw DEFLATE (RFC 1951) encoder: greedy LZ77 over the 32 KB window with hash chains,
+// one dynamic Huffman block per 64 KB of input (stored if that is smaller).
+// Compressed bytes accumulate in output(); the caller drains it as it likes.
+class DeflateEncoder {
+public:
+    DeflateEncoder();
+
+    void write(const char* data, size_t size);
+    // Compresses the remaining input. With finalBlock the stream is closed; otherwise it ends
+    // byte-aligned on an empty stored block, so another DEFLATE stream can be appended to it.
+    void finish(bool finalBlock = true);
+
+    std::string& output() { return output_; }
+
+private:
+    void compressPending(bool finalBlock);
+    void writeBlock(const uint32_t* tokens, size_t tokenCount, const uint8_t* raw, size_t rawSize, bool finalBlock);
+    void putBits(uint32_t value, int count);
+    void alignToByte();
+    void slideWindow();
+
+    std::vector<uint8_t> buffer_;      // 32 KB of history followed by input not yet compressed
+    size_t historySize_ = 0;
+    std::vector<int32_t> head_;        // Hash of 3 bytes -> last buffer position with that hash
+    std::vector<int32_t> prev_;        // Buffer position -> previous position with the same hash
+    std::vector<uint32_t> tokens_;     // Literal byte, or match (flag | length - 3 << 15 | distance - 1)
+    uint32_t literalFrequency_[286];
+    uint32_t distanceFrequency_[30];
+
+    uint64_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+    std::string output_;
+};
+
+// Writes a zip archive to a file in one pass. Every entry is added with its sizes and CRC known up
+// front, so no data descriptors are needed; ZIP64 records are used only when a size or offset requires it.
+// The destination is replaced only by commit(), an unfinished archive never overwrites it.
+class ZipWriter {
+public:
+    ZipWriter();
+    ~ZipWriter();
+
+    bool open(const std::string& filename);
+    // Starts an entry; write() must then supply exactly compressedSize bytes
+    bool beginEntry(const std::string& name, uint16_t method, uint32_t crc, uint64_t compressedSize, uint64_t uncompressedSize);
+    bool write(const char* data, size_t size);
+    // Adds a small entry compressed in memory
+    bool addEntry(const std::string& name, const std::string& content);
+    // Writes the central directory and replaces the destination file
+    bool commit();
+
+private:
+    struct Entry {
+        ZipEntry info;
+        uint32_t crc = 0;
+    };
+
+    std::unique_ptr<QSaveFile> file_;
+    uint64_t offset_ = 0;
+    std::vector<Entry> entries_;
+    uint16_t dosTime_ = 0;
+    uint16_t dosDate_ = 0;
+    bool failed_ = false;
+};
+
+// Compressed bytes of one part, held in memory up to a limit and spilled to a temporary file beyond it
+class PartSpool {
+public:
+    PartSpool();
+    ~PartSpool();
+
+    bool append(const char* data, size_t size);
+    bool copyTo(ZipWriter& zip);
+    uint64_t size() const { return size_; }
+
+private:
+    std::string memory_;
+    std::unique_ptr<QTemporaryFile> file_;
+    uint64_t size_ = 0;
+};
+
+// Builds an .xlsx workbook from rows appended sheet by sheet, in any interleaving.
+// Each sheet's XML is compressed as rows arrive, so memory holds only the compressed sheets (spilled
+// to temporary files when large) and the shared string table; save() then writes the file in one pass.
+// Strings go to the shared string table, dates use built-in date formats, empty strings leave the cell empty.
+class XlsxWorkbookWriter {
+public:
+    XlsxWorkbookWriter();
+    ~XlsxWorkbookWriter();
+
+    // Starts from the cell values of an existing workbook (formatting and formulas are not carried over)
+    bool load(const std::string& filename);
+
+    int sheetCount() const { return static_cast<int>(sheets_.size()); }
+    // Looks a sheet up by name, case-insensitively and after Excel's naming rules; -1 if missing
+    int findSheet(const std::string& name) const;
+    // Adds an empty sheet after the existing ones and returns its index
+    int addSheet(const std::string& name);
+    // Drops the rows written so far
+    void clearSheet(int index);
+    bool isSheetEmpty(int index) const;
+
+    // Appends rows below the last row of the sheet
+    bool appendRows(int index, const std::vector<DataRow>& rows);
+    // Writes one row at rowNumber, which must be below the last row of the sheet
+    bool writeRow(int index, int rowNumber, const std::vector<CellValue>& cells);
+
+    bool save(const std::string& filename);
+    const std::string& error() const { return error_; }
+
+    // Sheet name as Excel accepts it: at most 31 characters, none of []:*?/\ and no control characters
+    static std::string validSheetName(const std::string& name);
+
+private:
+    struct Sheet;
+
+    void appendCell(Sheet& sheet, int column, int rowNumber, const CellValue& value);
+    bool flushSheet(Sheet& sheet, bool finalBlock);
+    uint32_t sharedString(const std::string& text);
+
+    std::vector<std::unique_ptr<Sheet>> sheets_;
+    std::unordered_map<std::string, uint32_t> stringIndex_;
+    std::vector<const std::string*> strings_;   // Keys of stringIndex_ in index order
+    uint64_t stringReferences_ = 0;
+    std::string error_;
+};
@@ -101,8 +101,9 @@ void PreviewTable::draw_cell(TableContext context, int R, int C, int X, int Y, i
                     text = std::to_string(std::get<double>(val));
                 } else if (std::holds_alternative<bool>(val)) {
                     text = std::get<bool>(val) ? "TRUE" : "FALSE";
+                } else if (std::holds_alternative<CellDate>(val)) {
+                    text = std::get<CellDate>(val).toString();
                 }
-                // Date handling skipped for simplicity or add if needed
                 
                 fl_draw(text.c_str(), X + 2, Y, W - 4, H, FL_ALIGN_LEFT);
             }
@@ -761,6 +761,8 @@ void ExcelProcessorGUI::updatePreviewTable(const std::vector<DataRow>& data, con
                         }
                     } else if constexpr (std::is_same_v<ValType, bool>) {
                         cellValue = val ? "true" : "false";
+                    } else if constexpr (std::is_same_v<ValType, CellDate>) {
+                        cellValue = val.toString();
                     }
                 }, data[i].data[j]);
             }
@@ -860,6 +862,7 @@ QString ExcelProcessorGUI::generateRuleDescription(const Rule& rule) {
             case Operator::STARTS_WITH: part += QString::fromUtf8("\xE5\xBC\x80\xE5\xA4\xB4\xE6\x98\xAF"); break; // "Starts With"
             case Operator::ENDS_WITH: part += QString::fromUtf8("\xE7\xBB\x93\xE5\xB0\xBE\xE6\x98\xAF"); break; // "Ends With"
             case Operator::REGEX: part += "Regex"; break;
+            case Operator::IN_LIST: part += QString::fromUtf8("\xE5\x9C\xA8\xE5\x88\x97\xE8\xA1\xA8\xE4\xB8\xAD"); break; // "In List"
             default: part += "?"; break;
         }
         
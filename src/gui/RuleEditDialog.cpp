@@ -212,6 +212,7 @@ void RuleEditDialog::addCondition() {
     opCombo->addItem(QString::fromUtf8("\xE4\xB8\x8D\xE4\xB8\xBA\xE7\xA9\xBA"), static_cast<int>(Operator::NOT_EMPTY));
     opCombo->addItem(QString::fromUtf8("\xE4\xBB\xA5...\xE5\xBC\x80\xE5\xA4\xB4"), static_cast<int>(Operator::STARTS_WITH));
     opCombo->addItem(QString::fromUtf8("\xE4\xBB\xA5...\xE7\xBB\x93\xE5\xB0\xBE"), static_cast<int>(Operator::ENDS_WITH));
+    opCombo->addItem(QString::fromUtf8("\xE5\x9C\xA8\xE5\x88\x97\xE8\xA1\xA8\xE4\xB8\xAD (\xE9\x80\x97\xE5\x8F\xB7\xE5\x88\x86\xE9\x9A\x94)"), static_cast<int>(Operator::IN_LIST));
     conditionsTable_->setCellWidget(row, 1, opCombo);
 
     // Value Edit
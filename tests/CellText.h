@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ExcelProcessorCore.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Cells and rows as comparable text for the xlsx tests: every value is tagged with its type
+// (N number, S string, B bool, D date) and each row starts with its row number
+
+inline std::string cellText(const CellValue& cell) {
+    std::ostringstream oss;
+    std::visit([&oss](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, CellDate>) oss << "D" << (v.toTm().tm_year + 1900) << "-" << (v.toTm().tm_mon + 1) << "-" << v.toTm().tm_mday;
+        else if constexpr (std::is_same_v<T, std::string>) oss << "S" << v;
+        else if constexpr (std::is_same_v<T, bool>) oss << "B" << v;
+        else oss << "N" << v;
+    }, cell);
+    return oss.str();
+}
+
+inline std::string rowsText(const std::vector<DataRow>& rows) {
+    std::string out;
+    for (const auto& row : rows) {
+        out += std::to_string(row.rowNumber) + ":";
+        for (const auto& cell : row.data) out += cellText(cell) + "|";
+        out += "\n";
+    }
+    return out;
+}
@@ -0,0 +1,89 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Helper to print test results
+void test(bool result, const std::string& name) {
+    if (result) {
+        std::cout << "[PASS] " << name << std::endl;
+    } else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+std::tm makeTm(int year, int month, int day, int hour = 0, int minute = 0, int second = 0) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    return tm;
+}
+
+int main() {
+    // Test 1: The cell stays small
+    {
+        std::cout << "  sizeof(CellDate) " << sizeof(CellDate) << ", sizeof(CellValue) " << sizeof(CellValue) << std::endl;
+        test(sizeof(CellDate) == 8, "CellDate is 8 bytes");
+        test(sizeof(CellValue) <= sizeof(std::string) + 8, "A cell is a string plus the tag");
+    }
+
+    // Test 2: Known day numbers and text
+    {
+        test(CellDate(makeTm(1970, 1, 1)).seconds == 0, "Epoch is zero");
+        test(CellDate::fromDate(2000, 3, 1).days() == 11017, "2000-03-01 is day 11017");
+        test(CellDate::fromDate(1969, 12, 31).days() == -1, "Day before the epoch is -1");
+        test(CellDate(makeTm(1969, 12, 31, 23, 59, 59)).days() == -1, "Times before the epoch round down");
+        test(CellDate::fromDate(2024, 1, 5).toString() == "2024-01-05", "Date text");
+        test(CellDate(makeTm(2024, 1, 5, 13, 4, 9)).toString() == "2024-01-05 13:04:09", "Date and time text");
+        test(!CellDate::fromDate(2024, 1, 5).hasTime() && CellDate(makeTm(1900, 1, 1, 0, 0, 1)).hasTime(), "hasTime");
+    }
+
+    // Test 3: Every day from 1600 to 2400 round-trips through std::tm
+    {
+        int mismatches = 0;
+        int64_t previous = CellDate::fromDate(1600, 1, 1).days() - 1;
+        const int monthDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        for (int year = 1600; year <= 2400; ++year) {
+            bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+            for (int month = 1; month <= 12; ++month) {
+                int days = monthDays[month - 1] + (month == 2 && leap ? 1 : 0);
+                for (int day = 1; day <= days; ++day) {
+                    CellDate date(makeTm(year, month, day, day % 24, month, year % 60));
+                    std::tm back = date.toTm();
+                    if (date.days() != previous + 1 || back.tm_year != year - 1900 || back.tm_mon != month - 1 ||
+                        back.tm_mday != day || back.tm_hour != day % 24 || back.tm_min != month || back.tm_sec != year % 60) {
+                        if (mismatches++ == 0) std::cerr << "  first mismatch " << year << "-" << month << "-" << day << std::endl;
+                    }
+                    previous = date.days();
+                }
+            }
+        }
+        test(mismatches == 0, "Calendar round trip 1600-2400");
+        test(CellDate::fromDate(2024, 1, 7).toTm().tm_wday == 0 && CellDate::fromDate(2024, 3, 1).toTm().tm_yday == 60,
+             "Weekday and day of year");
+    }
+
+    // Test 4: Out-of-range std::tm fields carry over like mktime
+    {
+        test(CellDate(makeTm(2023, 13, 1)) == CellDate::fromDate(2024, 1, 1), "Month 13 is next January");
+        test(CellDate(makeTm(2024, 3, 0)) == CellDate::fromDate(2024, 2, 29), "Day 0 is the last day of the previous month");
+        test(CellDate(makeTm(2024, 0, 15)) == CellDate::fromDate(2023, 12, 15), "Month 0 is previous December");
+    }
+
+    // Test 5: Cells built from a std::tm hold a CellDate
+    {
+        DataRow row;
+        row.data.push_back(makeTm(2024, 2, 29));
+        CellValue cell = makeTm(2024, 2, 29);
+        test(std::holds_alternative<CellDate>(row.data[0]) && row.data[0] == cell &&
+             std::get<CellDate>(cell).toString() == "2024-02-29", "std::tm converts into a cell");
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
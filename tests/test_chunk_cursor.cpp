@@ -0,0 +1,90 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static bool sameCells(const DataRow& a, const DataRow& b) {
+    if (a.data.size() != b.data.size()) return false;
+    for (size_t i = 0; i < a.data.size(); ++i) {
+        if (a.data[i].index() != b.data[i].index()) return false;
+        if (auto s = std::get_if<std::string>(&a.data[i])) {
+            if (*s != std::get<std::string>(b.data[i])) return false;
+        } else if (auto n = std::get_if<int>(&a.data[i])) {
+            if (*n != std::get<int>(b.data[i])) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // 1. Create test CSV (row count deliberately not a multiple of the chunk size)
+    std::string inputFile = "test_chunk_cursor_input.csv";
+    const int dataRows = 12345;
+    {
+        std::ofstream out(inputFile);
+        out << "ID,Name,Amount\n";
+        for (int i = 1; i <= dataRows; ++i) {
+            out << i << ",Name" << i << "," << (i * 3) << "\n";
+        }
+    }
+
+    auto reader = createExcelReader(inputFile);
+
+    for (bool includeHeader : { false, true }) {
+        std::string mode = includeHeader ? " (with header)" : " (no header)";
+
+        // Reference: single full read
+        std::vector<DataRow> expected;
+        test(reader->readExcelFile(inputFile, expected, "", 0, 0, includeHeader), "Full read" + mode);
+
+        // 2. Cursor read in chunks
+        auto cursor = reader->openChunkCursor(inputFile, "", includeHeader);
+        test(cursor != nullptr, "Cursor opens" + mode);
+
+        std::vector<DataRow> streamed;
+        int chunks = 0;
+        while (true) {
+            std::vector<DataRow> chunk;
+            test(cursor->readNextChunk(chunk, 1000), "Chunk read succeeds" + mode);
+            if (chunk.empty()) break;
+            streamed.insert(streamed.end(), chunk.begin(), chunk.end());
+            chunks++;
+            if (cursor->atEnd()) break;
+        }
+
+        // 3. Verify
+        test(chunks == 13, "Chunk count is 13" + mode);
+        test(streamed.size() == expected.size(), "Row count matches full read" + mode);
+
+        bool allSame = true;
+        bool numbersAscending = true;
+        for (size_t i = 0; i < streamed.size() && i < expected.size(); ++i) {
+            if (!sameCells(streamed[i], expected[i])) allSame = false;
+            if (streamed[i].rowNumber != static_cast<int>(i) + 1) numbersAscending = false;
+        }
+        test(allSame, "Cells match full read" + mode);
+        test(numbersAscending, "Row numbers are contiguous across chunks" + mode);
+    }
+
+    // 4. Missing file
+    test(reader->openChunkCursor("does_not_exist.csv") == nullptr, "Missing file returns no cursor");
+
+    // Cleanup
+    try {
+        fs::remove(inputFile);
+    } catch (...) {}
+
+    std::cout << "Chunk cursor test passed!" << std::endl;
+    return 0;
+}
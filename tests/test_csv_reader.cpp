@@ -0,0 +1,105 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static bool sameRows(const std::vector<DataRow>& a, const std::vector<DataRow>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t r = 0; r < a.size(); ++r) {
+        if (a[r].rowNumber != b[r].rowNumber || a[r].data.size() != b[r].data.size()) return false;
+        for (size_t c = 0; c < a[r].data.size(); ++c) {
+            const auto& x = a[r].data[c];
+            const auto& y = b[r].data[c];
+            if (x.index() != y.index()) return false;
+            if (auto s = std::get_if<std::string>(&x)) { if (*s != std::get<std::string>(y)) return false; }
+            else if (auto i = std::get_if<int>(&x)) { if (*i != std::get<int>(y)) return false; }
+            else if (auto d = std::get_if<double>(&x)) { if (*d != std::get<double>(y)) return false; }
+            else if (auto b1 = std::get_if<bool>(&x)) { if (*b1 != std::get<bool>(y)) return false; }
+        }
+    }
+    return true;
+}
+
+int main() {
+    // 1. Create test CSV covering the parser's edge cases (CRLF, empty line, trailing comma, no final newline)
+    std::string inputFile = "test_csv_reader_input.csv";
+    {
+        std::ofstream out(inputFile, std::ios::binary);
+        out << "ID,Name,Amount,Flag\r\n";
+        out << "1,\"Alice\",12.5,TRUE\r\n";
+        out << "2,Bob,-7,false\n";
+        out << "\n";
+        out << "3,,+42,\r\n";
+        out << "4,Name4,99999999999,x\n";
+        out << "5,\"\",1e999,True\n";
+        out << "6,\"Smith, J\",\"multi\r\nline\",\"say \"\"hi\"\"\"";
+    }
+
+    auto mappedReader = createExcelReader(inputFile, true);
+    auto streamReader = createExcelReader(inputFile, false);
+
+    // 2. Both modes must produce identical rows
+    for (bool includeHeader : { false, true }) {
+        std::vector<DataRow> mapped, streamed;
+        test(mappedReader->readExcelFile(inputFile, mapped, "", 0, 0, includeHeader), "Mapped read succeeds");
+        test(streamReader->readExcelFile(inputFile, streamed, "", 0, 0, includeHeader), "Stream read succeeds");
+        test(sameRows(mapped, streamed), std::string("Mapped and stream rows match") + (includeHeader ? " (with header)" : ""));
+    }
+
+    // 3. Cell typing
+    std::vector<DataRow> rows;
+    mappedReader->readExcelFile(inputFile, rows);
+    test(rows.size() == 7, "Empty line is kept as a row, quoted newline is not");
+    test(std::get<std::string>(rows[0].data[1]) == "Alice", "Quotes are trimmed");
+    test(std::get<double>(rows[0].data[2]) == 12.5, "Double parsed");
+    test(std::get<bool>(rows[0].data[3]) == true, "Boolean parsed case-insensitively");
+    test(std::get<int>(rows[1].data[2]) == -7, "Negative int parsed");
+    test(std::get<bool>(rows[1].data[3]) == false, "Lowercase boolean parsed");
+    test(rows[2].data.empty(), "Empty line has no cells");
+    test(rows[3].data.size() == 3 && std::get<int>(rows[3].data[2]) == 42, "CR stripped, trailing comma adds no cell, '+' sign accepted");
+    test(std::holds_alternative<double>(rows[4].data[2]), "Int overflow falls back to double");
+    test(std::holds_alternative<std::string>(rows[5].data[2]), "Double overflow falls back to string");
+    test(std::get<std::string>(rows[5].data[1]).empty(), "Quoted empty cell is empty string");
+    test(rows[6].data.size() == 4, "Embedded comma and newline stay in one cell");
+    test(std::get<std::string>(rows[6].data[1]) == "Smith, J", "Quoted comma kept");
+    test(std::get<std::string>(rows[6].data[2]) == "multi\r\nline", "CRLF inside quotes kept");
+    test(std::get<std::string>(rows[6].data[3]) == "say \"hi\"", "Doubled quotes unescaped");
+
+    // 4. Large file (parallel ranges when mapped) matches the sequential stream read, row numbers included
+    std::string largeFile = "test_csv_reader_large.csv";
+    {
+        std::ofstream out(largeFile, std::ios::binary);
+        out << "ID,Name,Note\r\n";
+        for (int i = 1; i <= 150000; ++i) {
+            out << i << ",\"Name, " << i << "\",\"line1\nline \"\"" << i << "\"\"\"\r\n";
+        }
+    }
+    for (bool includeHeader : { false, true }) {
+        std::vector<DataRow> mapped, streamed;
+        mappedReader->readExcelFile(largeFile, mapped, "", 0, 0, includeHeader);
+        streamReader->readExcelFile(largeFile, streamed, "", 0, 0, includeHeader);
+        test(mapped.size() == (includeHeader ? 150001u : 150000u), "Large file row count");
+        test(sameRows(mapped, streamed), std::string("Large mapped read matches stream read") + (includeHeader ? " (with header)" : ""));
+        test(mapped.back().rowNumber == static_cast<int>(mapped.size()), "Row numbers are sequential");
+    }
+
+    // Cleanup
+    try {
+        fs::remove(inputFile);
+        fs::remove(largeFile);
+    } catch (...) {}
+
+    std::cout << "CSV reader test passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "../src/core/CsvParser.h"
+#include <iostream>
+#include <random>
+#include <cstring>
+#include <vector>
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+using Cell = CellValue;
+
+static bool sameCell(const Cell& a, const Cell& b) {
+    if (a.index() != b.index()) return false;
+    if (auto s = std::get_if<std::string>(&a)) return *s == std::get<std::string>(b);
+    if (auto i = std::get_if<int>(&a)) return *i == std::get<int>(b);
+    if (auto d = std::get_if<double>(&a)) {
+        double e = std::get<double>(b);
+        return std::memcmp(d, &e, sizeof(double)) == 0 || (*d != *d && e != e); // Bitwise, so -0.0 and NaN count
+    }
+    if (auto v = std::get_if<bool>(&a)) return *v == std::get<bool>(b);
+    return std::get<CellDate>(a).days() == std::get<CellDate>(b).days();
+}
+
+int main() {
+    // 1. Inference from sample rows; the header row is not sampled
+    {
+        CsvSchema schema(3);
+        std::vector<Cell> cells;
+        std::vector<std::vector<std::string_view>> rows = {
+            { "ID", "Amount", "Price", "Flag", "Name", "Mixed" },
+            { "1", "10", "1.5", "TRUE", "Alice", "x" },
+            { "2", "", "2.25", "false", "Bob", "5" },
+            { "3", "-7", "3", "True", "Carol", "true" },
+        };
+        schema.parseRecord(rows[0], cells, false);
+        for (size_t r = 1; r < rows.size(); ++r) schema.parseRecord(rows[r], cells);
+
+        test(schema.isLocked(), "Schema locks after the sample rows");
+        test(schema.columnType(0) == CsvColumnType::Int, "Int column");
+        test(schema.columnType(1) == CsvColumnType::Int, "Empty cells do not affect the type");
+        test(schema.columnType(2) == CsvColumnType::Number, "Int and double cells make a number column");
+        test(schema.columnType(3) == CsvColumnType::Bool, "Bool column");
+        test(schema.columnType(4) == CsvColumnType::String, "String column");
+        test(schema.columnType(5) == CsvColumnType::Mixed, "Mixed column");
+        test(schema.columnType(6) == CsvColumnType::Mixed, "Columns beyond the sample are mixed");
+
+        cells.clear();
+        schema.parseRecord({ "4", "abc", "1e3", "yes", "123", "7", "extra" }, cells);
+        test(std::get<int>(cells[0]) == 4, "Int column parsed");
+        test(std::get<std::string>(cells[1]) == "abc", "Non-numeric cell in int column falls back to string");
+        test(std::get<double>(cells[2]) == 1000.0, "Exponent in number column goes through the generic parser");
+        test(std::get<std::string>(cells[3]) == "yes", "Non-boolean cell in bool column falls back to string");
+        test(std::get<int>(cells[4]) == 123, "Number in string column keeps its number type");
+        test(std::get<std::string>(cells[6]) == "extra", "Extra column parsed generically");
+    }
+
+    // 2. Locked column parsers agree with per-cell parsing for every cell
+    {
+        const char* pieces[] = { "0", "1", "9", "-", "+", ".", "e", "E", "00", "123", "4567", "89012345678",
+                                 "true", "FALSE", "TrUe", "x", "Name", " ", "inf", "nan", "2024-01-01", "2024/12/31",
+                                 "\xE4\xB8\xAD", "0.1", "99999999999999999999", "1e308", "1e999", "-0" };
+        const size_t pieceCount = sizeof(pieces) / sizeof(pieces[0]);
+        std::mt19937 rng(2024);
+
+        int mismatches = 0;
+        int checked = 0;
+        for (CsvColumnType target : { CsvColumnType::Int, CsvColumnType::Double, CsvColumnType::Number,
+                                      CsvColumnType::Bool, CsvColumnType::String }) {
+            // Prime a one-column schema to the target type
+            const char* sample = "1";
+            if (target == CsvColumnType::Double) sample = "1.5";
+            if (target == CsvColumnType::Bool) sample = "true";
+            if (target == CsvColumnType::String) sample = "text";
+            CsvSchema schema(target == CsvColumnType::Number ? 2 : 1);
+            std::vector<Cell> cells;
+            schema.parseRecord({ sample }, cells);
+            if (target == CsvColumnType::Number) schema.parseRecord({ "2.5" }, cells);
+            test(schema.columnType(0) == target, "Schema primed to target type");
+
+            for (int i = 0; i < 20000; ++i) {
+                std::string cell;
+                int parts = 1 + rng() % 3;
+                for (int p = 0; p < parts; ++p) cell += pieces[rng() % pieceCount];
+
+                cells.clear();
+                schema.parseRecord({ cell }, cells);
+                if (!sameCell(cells[0], parseCsvCell(cell))) {
+                    if (mismatches++ < 5) std::cerr << "Mismatch for cell '" << cell << "'" << std::endl;
+                }
+                ++checked;
+            }
+
+            // Random decimals near the fast-path limits
+            for (int i = 0; i < 20000; ++i) {
+                std::string cell = (rng() % 2 ? "-" : "") + std::to_string(rng() % 1000000000) + "." +
+                                   std::to_string(rng() % 1000000000);
+                cells.clear();
+                schema.parseRecord({ cell }, cells);
+                if (!sameCell(cells[0], parseCsvCell(cell))) {
+                    if (mismatches++ < 5) std::cerr << "Mismatch for cell '" << cell << "'" << std::endl;
+                }
+                ++checked;
+            }
+        }
+        test(mismatches == 0, "Column parsers match per-cell parsing on " + std::to_string(checked) + " cells");
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include "../src/core/CsvParser.h"
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <vector>
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+using Records = std::vector<std::vector<std::string>>;
+
+// Reference split for quote-free input: the original getline-based CSV parser
+static Records referenceSplit(const std::string& input) {
+    std::vector<std::vector<std::string>> records;
+    std::istringstream in(input);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::vector<std::string> fields;
+        std::stringstream lineStream(line);
+        std::string cell;
+        while (std::getline(lineStream, cell, ',')) fields.push_back(cell);
+        records.push_back(fields);
+    }
+    return records;
+}
+
+// Character-at-a-time RFC 4180 reference with the tokenizer's leniency rules:
+// a quote only opens a field at its start, text after the closing quote is kept,
+// stray quotes after it are dropped, and a trailing ',' adds no field.
+static std::string unescapeQuoted(const std::string& raw) {
+    std::string out;
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] != '"') out += raw[i];
+        else if (i + 1 < raw.size() && raw[i + 1] == '"') { out += '"'; ++i; }
+    }
+    return out;
+}
+
+static Records referenceParse(const std::string& input) {
+    Records records;
+    size_t i = 0, n = input.size();
+    while (i < n) {
+        std::vector<std::string> fields;
+        while (true) {
+            bool quoted = i < n && input[i] == '"';
+            bool inQuotes = quoted;
+            if (quoted) ++i;
+            std::string raw;
+            while (i < n) {
+                char c = input[i];
+                if (inQuotes) {
+                    if (c == '"') {
+                        if (i + 1 < n && input[i + 1] == '"') { raw += "\"\""; i += 2; continue; }
+                        inQuotes = false;
+                    }
+                } else if (c == ',' || c == '\n') {
+                    break;
+                }
+                raw += c;
+                ++i;
+            }
+
+            bool atComma = i < n && input[i] == ',';
+            if (!atComma && !inQuotes && !raw.empty() && raw.back() == '\r') raw.pop_back();
+            if (atComma || quoted || !raw.empty()) fields.push_back(quoted ? unescapeQuoted(raw) : raw);
+
+            if (atComma) { ++i; continue; }
+            if (i < n) ++i; // '\n'
+            break;
+        }
+        records.push_back(fields);
+    }
+    return records;
+}
+
+static Records tokenizerSplit(const std::string& input, CsvSimdLevel level) {
+    std::vector<std::vector<std::string>> records;
+    CsvTokenizer tokenizer(input.data(), input.data() + input.size(), level);
+    std::vector<std::string_view> fields;
+    while (tokenizer.nextRecord(fields)) {
+        records.emplace_back(fields.begin(), fields.end());
+    }
+    return records;
+}
+
+int main() {
+    std::vector<CsvSimdLevel> levels = { CsvSimdLevel::Scalar };
+    if (detectCsvSimdLevel() != CsvSimdLevel::Scalar) levels.push_back(CsvSimdLevel::SSE2);
+    if (detectCsvSimdLevel() == CsvSimdLevel::AVX2) levels.push_back(CsvSimdLevel::AVX2);
+    std::cout << "Detected SIMD level: " << csvSimdLevelName(detectCsvSimdLevel()) << std::endl;
+
+    // 1. Quote-free input splits exactly like the original getline parser
+    std::vector<std::string> plainCases = {
+        "", "\n", "a", "a,b,c", "a,b,c\n", "a,b,\r\n,x\r\n", ",,,\n,", "\r\n\r\n", "a\rb,c\r"
+    };
+    for (const auto& input : plainCases) {
+        for (auto level : levels) {
+            test(tokenizerSplit(input, level) == referenceSplit(input),
+                 std::string("Plain case matches getline split (") + csvSimdLevelName(level) + ")");
+        }
+    }
+
+    // 2. RFC 4180 quoting
+    {
+        std::string input = "\"a,b\",\"say \"\"hi\"\"\",\"line1\r\nline2\"\r\n\"\",x\"y,\"tail\"\r\n\"open,\n";
+        Records expected = {
+            { "a,b", "say \"hi\"", "line1\r\nline2" },
+            { "", "x\"y", "tail" },
+            { "open,\n" }
+        };
+        for (auto level : levels) {
+            auto records = tokenizerSplit(input, level);
+            test(records == expected, std::string("Embedded delimiters, doubled quotes, CRLF in quotes (") + csvSimdLevelName(level) + ")");
+            test(records == referenceParse(input), "Quoted case matches RFC reference");
+        }
+
+        CsvTokenizer tokenizer(input.data(), input.data() + input.size());
+        std::vector<std::string_view> fields;
+        tokenizer.nextRecord(fields);
+        test(fields[0].data() == input.data() + 1, "Quoted field without escapes is not copied");
+        test(!tokenizer.endedInQuotes(), "Closed quotes reported");
+        tokenizer.nextRecord(fields);
+        test(fields[1].data() == input.data() + input.find("x\"y"), "Unquoted field with inner quote is not copied");
+        tokenizer.nextRecord(fields);
+        test(tokenizer.endedInQuotes() && tokenizer.atEnd(), "Unterminated quote runs to end of input");
+    }
+
+    // 3. Fuzzed inputs, including sizes that cross 64-byte blocks and the bitmap window
+    std::mt19937 rng(12345);
+    int mismatches = 0;
+    for (const std::string& alphabet : { std::string(",,,\n\n\r abcXYZ0123456789.-\x80\xff"),
+                                        std::string(",,,\"\"\"\n\n\r abcXYZ0123456789.-\x80\xff") }) {
+        bool hasQuotes = alphabet.find('"') != std::string::npos;
+        for (int round = 0; round < 400; ++round) {
+            size_t size = (round % 40 == 0) ? 70000 + rng() % 5000 : rng() % 300;
+            std::string input(size, ' ');
+            for (auto& c : input) c = alphabet[rng() % alphabet.size()];
+
+            auto expected = hasQuotes ? referenceParse(input) : referenceSplit(input);
+            for (auto level : levels) {
+                if (tokenizerSplit(input, level) != expected) ++mismatches;
+            }
+
+            // Same input viewed from every offset inside the first block (unaligned starts and tails)
+            if (round < 20) {
+                for (size_t offset = 1; offset < 64 && offset < input.size(); ++offset) {
+                    std::string shifted = input.substr(offset);
+                    auto shiftedExpected = hasQuotes ? referenceParse(shifted) : referenceSplit(shifted);
+                    for (auto level : levels) {
+                        if (tokenizerSplit(shifted, level) != shiftedExpected) ++mismatches;
+                    }
+                }
+            }
+        }
+    }
+    test(mismatches == 0, "Fuzzed inputs match reference at every SIMD level");
+
+    // 4. Long lines spanning several windows
+    std::string longLine;
+    for (int i = 0; i < 20000; ++i) longLine += "field" + std::to_string(i) + ",";
+    longLine += "last\r\nnext,row";
+    for (auto level : levels) {
+        auto records = tokenizerSplit(longLine, level);
+        test(records == referenceSplit(longLine) && records.size() == 2 && records[0].size() == 20001,
+             std::string("Record spanning multiple windows (") + csvSimdLevelName(level) + ")");
+    }
+    std::string longQuoted = "id,\"";
+    for (int i = 0; i < 5000; ++i) longQuoted += "a,\"\"b\"\"\n";
+    longQuoted += "\",end\nnext";
+    for (auto level : levels) {
+        auto records = tokenizerSplit(longQuoted, level);
+        test(records == referenceParse(longQuoted) && records.size() == 2 && records[0].size() == 3,
+             std::string("Quoted field spanning multiple windows (") + csvSimdLevelName(level) + ")");
+    }
+
+    // 5. skipRecord stays in step with nextRecord
+    {
+        std::string input = "h1,\"h\n2\"\r\n1,2\n3,4";
+        CsvTokenizer tokenizer(input.data(), input.data() + input.size());
+        std::vector<std::string_view> fields;
+        test(tokenizer.skipRecord(), "Skip header");
+        test(tokenizer.nextRecord(fields) && fields.size() == 2 && fields[0] == "1", "First record after skip");
+        test(tokenizer.nextRecord(fields) && fields.size() == 2 && fields[1] == "4", "Last record without newline");
+        test(!tokenizer.nextRecord(fields) && tokenizer.atEnd(), "End of input");
+    }
+
+    // 6. Record-aligned byte ranges for parallel parsing
+    {
+        std::string input;
+        std::mt19937 gen(777);
+        for (int r = 0; r < 20000; ++r) {
+            for (int c = 0; c < 5; ++c) {
+                if (c > 0) input += ',';
+                switch (gen() % 4) {
+                    case 0: input += std::to_string(gen() % 100000); break;
+                    case 1: input += "\"q,\"\"" + std::to_string(r) + "\"\"\""; break;
+                    case 2: input += "\"multi\r\nline " + std::to_string(c) + "\""; break;
+                    default: input += "text" + std::to_string(c); break;
+                }
+            }
+            input += (r % 2) ? "\r\n" : "\n";
+        }
+
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+        auto whole = tokenizerSplit(input, detectCsvSimdLevel());
+        for (size_t parts : { 1, 2, 3, 8, 64 }) {
+            auto bounds = splitCsvRecords(begin, end, parts);
+            bool ok = bounds.front() == begin && bounds.back() == end && bounds.size() <= parts + 1;
+            Records joined;
+            for (size_t i = 0; ok && i + 1 < bounds.size(); ++i) {
+                ok = bounds[i] < bounds[i + 1];
+                auto part = tokenizerSplit(std::string(bounds[i], bounds[i + 1]), detectCsvSimdLevel());
+                joined.insert(joined.end(), part.begin(), part.end());
+            }
+            test(ok && joined == whole, "Ranges split into " + std::to_string(parts) + " start on record boundaries");
+        }
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "ExcelProcessorCore.h"
+#include "../src/core/CsvWriter.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+using Cell = CellValue;
+
+// The original per-cell ostringstream formatting
+static std::string legacyFormat(const Cell& value) {
+    std::ostringstream oss;
+    std::visit([&oss](const auto& val) {
+        using ValType = std::decay_t<decltype(val)>;
+        if constexpr (std::is_same_v<ValType, std::string>) {
+            oss << "\"" << val << "\"";
+        } else if constexpr (std::is_same_v<ValType, bool>) {
+            oss << (val ? "true" : "false");
+        } else if constexpr (std::is_same_v<ValType, CellDate>) {
+            std::tm tm = val.toTm();
+            oss << std::put_time(&tm, "%Y-%m-%d");
+        } else {
+            oss << val;
+        }
+    }, value);
+    return oss.str();
+}
+
+static std::string readAll(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main() {
+    // 1. Formatting matches the original writer for quote-free values
+    std::mt19937 rng(99);
+    std::vector<DataRow> rows;
+    std::string expected;
+    for (int r = 0; r < 5000; ++r) {
+        DataRow row;
+        for (int c = 0; c < 6; ++c) {
+            switch (rng() % 5) {
+                case 0: row.data.push_back(static_cast<int>(rng()) - static_cast<int>(rng() / 2)); break;
+                case 1: {
+                    double values[] = { 0.1, -0.0, 1e20, 123456789.0, 1e-5, 100000.0, 1000000.0,
+                                        static_cast<double>(rng()) / 7.0, -static_cast<double>(rng() % 1000) / 3.0 };
+                    row.data.push_back(values[rng() % 9]);
+                    break;
+                }
+                case 2: row.data.push_back(rng() % 2 == 0); break;
+                case 3: {
+                    std::tm tm = {};
+                    tm.tm_year = 100 + rng() % 50;
+                    tm.tm_mon = rng() % 12;
+                    tm.tm_mday = 1 + rng() % 28;
+                    row.data.push_back(tm);
+                    break;
+                }
+                default: row.data.push_back("text " + std::to_string(rng() % 1000) + ", more"); break;
+            }
+        }
+        for (size_t i = 0; i < row.data.size(); ++i) {
+            if (i > 0) expected += ",";
+            expected += legacyFormat(row.data[i]);
+        }
+        expected += "\n";
+        rows.push_back(row);
+    }
+
+    std::ostringstream out;
+    {
+        CsvOutputBuffer buffer(out, 4096); // Small threshold so rows straddle several flushes
+        for (const auto& row : rows) buffer.appendRow(row.data);
+        test(buffer.flush(), "Flush succeeds");
+        test(buffer.bytesWritten() == expected.size(), "Byte count reported");
+    }
+    test(out.str() == expected, "Output matches the original formatting");
+
+    // 2. Writer and appendToSheet through ExcelWriter
+    auto writer = createExcelWriter(ExcelWriterType::CSV);
+    std::string outputFile = "test_csv_writer_output.csv";
+    test(writer->writeExcelFile(outputFile, rows), "writeExcelFile succeeds");
+    test(readAll(outputFile) == expected, "File content matches");
+    test(writer->appendToSheet(outputFile, rows, "Sheet1"), "appendToSheet succeeds");
+    test(readAll(outputFile) == expected + expected, "Append adds to the end");
+    test(writer->appendToSheet(outputFile, rows, "Sheet1", true), "Overwrite succeeds");
+    test(readAll(outputFile) == expected, "Overwrite replaces content");
+
+    // 3. Strings with quotes, commas and newlines read back unchanged
+    {
+        std::vector<DataRow> tricky(1);
+        tricky[0].data = { std::string("say \"hi\""), std::string("a,b"), std::string("line1\nline2"), 42 };
+        test(writer->writeExcelFile(outputFile, tricky), "Write quoted values");
+
+        std::vector<DataRow> back;
+        auto reader = createExcelReader(outputFile);
+        reader->readExcelFile(outputFile, back, "", 0, 0, true);
+        test(back.size() == 1 && back[0].data.size() == 4, "Round trip keeps one row");
+        test(std::get<std::string>(back[0].data[0]) == "say \"hi\"", "Embedded quotes round trip");
+        test(std::get<std::string>(back[0].data[1]) == "a,b", "Embedded comma round trips");
+        test(std::get<std::string>(back[0].data[2]) == "line1\nline2", "Embedded newline round trips");
+        test(std::get<int>(back[0].data[3]) == 42, "Number round trips");
+    }
+
+    try {
+        fs::remove(outputFile);
+    } catch (...) {}
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
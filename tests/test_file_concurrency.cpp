@@ -0,0 +1,163 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <algorithm>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static std::string readAll(const fs::path& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static const fs::path kInputDir = "test_file_concurrency_in";
+static const fs::path kOutputDir = "test_file_concurrency_out";
+
+struct Run {
+    std::vector<ProcessingResult> results;
+    std::string outputs;
+    std::vector<std::string> progress;
+    std::vector<int> progressRows;
+};
+
+// Runs every task over the files their patterns match and returns the outputs and progress messages
+static Run runTasks(ExcelProcessorCore& processor, const fs::path& outputDir, int concurrentFiles) {
+    fs::remove_all(outputDir);
+    fs::create_directories(outputDir);
+
+    Run run;
+    std::mutex mutex;
+    processor.setProgressCallback([&](int rows, const std::string& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        run.progress.push_back(msg);
+        run.progressRows.push_back(rows);
+    });
+    processor.setConcurrentFiles(concurrentFiles);
+    run.results = processor.processTasks("", (outputDir / "shared.csv").string());
+
+    for (const char* output : { "shared.csv", "out_b.csv" }) {
+        run.outputs += std::string(output) + "\n" + readAll(outputDir / output);
+    }
+    return run;
+}
+
+int main() {
+    // Two groups of inputs, several 5000-row chunks each
+    fs::remove_all(kInputDir);
+    fs::create_directories(kInputDir);
+    std::vector<std::string> names = { "a_1.csv", "a_2.csv", "a_3.csv", "b_1.csv", "b_2.csv", "b_3.csv" };
+    for (size_t f = 0; f < names.size(); ++f) {
+        std::ofstream out(kInputDir / names[f]);
+        const int rows = 7000 + static_cast<int>(f) * 1000;
+        for (int i = 1; i <= rows; ++i) {
+            out << names[f] << "," << i << "," << (i % 3 == 0 ? "A" : "B") << "\n";
+        }
+    }
+    // Patterns without a directory are matched in the current directory
+    const fs::path testDir = fs::current_path();
+    fs::current_path(kInputDir);
+    const fs::path outputDir = testDir / kOutputDir;
+
+    ExcelProcessorCore processor;
+
+    Rule ruleA;
+    ruleA.id = 1;
+    ruleA.name = "GroupA";
+    ruleA.type = RuleType::FILTER;
+    ruleA.enabled = true;
+    RuleCondition cond;
+    cond.column = 3;
+    cond.oper = Operator::EQUAL;
+    cond.value = std::string("A");
+    ruleA.conditions.push_back(cond);
+    processor.addRule(ruleA);
+
+    // The a_ files all append to one shared destination, the b_ files replace another, and a third
+    // task over every file writes nothing
+    ProcessingTask shared;
+    shared.id = 1;
+    shared.taskName = "SharedA";
+    shared.inputFilenamePattern = "a_*.csv";
+    shared.outputMode = OutputMode::NEW_SHEET;
+    shared.rules.push_back(TaskRuleEntry(ruleA.id));
+    processor.addTask(shared);
+
+    ProcessingTask replaced;
+    replaced.id = 2;
+    replaced.taskName = "ReplacedB";
+    replaced.inputFilenamePattern = "b_*.csv";
+    replaced.outputWorkbookName = "out_b.csv";
+    replaced.outputMode = OutputMode::NEW_WORKBOOK;
+    processor.addTask(replaced);
+
+    ProcessingTask counted;
+    counted.id = 3;
+    counted.taskName = "Counted";
+    counted.inputFilenamePattern = "*.csv";
+    counted.outputMode = OutputMode::NONE;
+    counted.rules.push_back(TaskRuleEntry(ruleA.id));
+    processor.addTask(counted);
+
+    Run serial = runTasks(processor, outputDir, 1);
+    Run concurrent = runTasks(processor, outputDir, 4);
+
+    // 1. Same output and results as a serial run
+    test(serial.outputs.find("a_3.csv") != std::string::npos, "Serial run wrote the shared output");
+    test(concurrent.outputs == serial.outputs, "Concurrent output matches serial output");
+    test(concurrent.results.size() == serial.results.size(), "Same number of results");
+    bool same = concurrent.results.size() == serial.results.size();
+    for (size_t i = 0; same && i < serial.results.size(); ++i) {
+        same = serial.results[i].totalRows == concurrent.results[i].totalRows &&
+               serial.results[i].processedRows == concurrent.results[i].processedRows &&
+               concurrent.results[i].errors.empty();
+    }
+    test(same, "Results in file order with the same counts");
+
+    // 2. Appends to the shared destination come file by file, in name order
+    std::string sharedOutput = readAll(outputDir / "shared.csv");
+    size_t a1 = sharedOutput.find("a_1.csv");
+    size_t a2 = sharedOutput.find("a_2.csv");
+    size_t a3 = sharedOutput.find("a_3.csv");
+    test(a1 < a2 && a2 < a3 && sharedOutput.rfind("a_1.csv") < a2 && sharedOutput.rfind("a_2.csv") < a3,
+         "Shared destination written one file at a time");
+
+    // 3. Progress is reported per file
+    bool everyFile = true;
+    for (size_t f = 0; f < names.size(); ++f) {
+        std::string prefix = "[" + std::to_string(f + 1) + "/6 " + names[f] + "] ";
+        bool found = false;
+        for (const auto& msg : concurrent.progress) found = found || msg.rfind(prefix, 0) == 0;
+        everyFile = everyFile && found;
+    }
+    test(everyFile, "Progress messages name their file");
+    int finished = 0;
+    for (const auto& msg : concurrent.progress) finished += msg.rfind("Finished file ", 0) == 0;
+    test(finished == 6, "Each file reports when it is finished");
+    bool rising = std::is_sorted(concurrent.progressRows.begin(), concurrent.progressRows.end());
+    // 57000 rows in all, less the first row of each file, which is read as its header
+    test(rising && concurrent.progressRows.back() == 57000 - 6, "Progress counts the rows of all files and never goes back");
+
+    // Cleanup
+    try {
+        fs::current_path(testDir);
+        fs::remove_all(kInputDir);
+        fs::remove_all(kOutputDir);
+    } catch (...) {}
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -84,6 +84,91 @@ int main() {
     std::cout << "Matched rows: " << results[0].matchedRows << std::endl;
     test(results[0].matchedRows == 1, "Should match exactly 1 row (Row 1)");
 
+    // 5. Many tasks sharing include and exclusion rules: every rule runs once per row, and each task
+    // keeps exactly the rows its own AND / OR / exclusion logic selects
+    {
+        std::string sharedInput = "test_granular_shared.csv";
+        std::ofstream shared(sharedInput);
+        const int rowCount = 300;
+        std::vector<std::vector<std::string>> rows;
+        shared << "Col1,Col2,Col3\n";
+        for (int i = 0; i < rowCount; ++i) {
+            rows.push_back({ std::string(1, "ABC"[i % 3]), i % 7 == 0 ? "Exclude" : "Keep", std::to_string(i % 10) });
+            shared << rows.back()[0] << "," << rows.back()[1] << "," << rows.back()[2] << "\n";
+        }
+        shared.close();
+
+        ExcelProcessorCore many;
+        auto addRule = [&many](int id, int column, Operator oper, const std::string& value) {
+            Rule rule;
+            rule.id = id;
+            rule.name = "Rule" + std::to_string(id);
+            RuleCondition cond;
+            cond.column = column;
+            cond.oper = oper;
+            cond.value = value;
+            rule.conditions.push_back(cond);
+            many.addRule(rule);
+        };
+        addRule(1, 1, Operator::EQUAL, "A");
+        addRule(2, 1, Operator::EQUAL, "B");
+        addRule(3, 2, Operator::EQUAL, "Exclude");
+        addRule(4, 3, Operator::LESS, "5");
+
+        auto matches = [](int ruleId, const std::vector<std::string>& row) {
+            if (ruleId == 1) return row[0] == "A";
+            if (ruleId == 2) return row[0] == "B";
+            if (ruleId == 3) return row[1] == "Exclude";
+            if (ruleId == 4) return std::stoi(row[2]) < 5;
+            return false;
+        };
+
+        std::vector<int> expected;
+        for (int t = 0; t < 20; ++t) {
+            ProcessingTask task;
+            task.id = 100 + t;
+            task.outputWorkbookName = "test_granular_shared_" + std::to_string(t) + ".csv";
+            task.outputMode = OutputMode::NEW_WORKBOOK;
+            task.ruleLogic = t % 2 ? RuleLogic::AND : RuleLogic::OR;
+            if (t % 4 != 3) {
+                TaskRuleEntry first(1 + t % 2);
+                if (t % 3 == 0) first.excludeRuleIds.push_back(4);
+                task.rules.push_back(first);
+                task.rules.push_back(TaskRuleEntry(t % 5 == 0 ? 99 : 4)); // 99 does not exist
+            }
+            task.excludeRuleIds.push_back(3);
+            many.addTask(task);
+
+            int kept = 0;
+            for (const auto& row : rows) {
+                bool include = task.rules.empty() || task.ruleLogic == RuleLogic::AND;
+                for (const auto& entry : task.rules) {
+                    bool matched = matches(entry.ruleId, row);
+                    for (int exId : entry.excludeRuleIds) matched = matched && !matches(exId, row);
+                    include = task.ruleLogic == RuleLogic::AND ? include && matched : include || matched;
+                }
+                for (int exId : task.excludeRuleIds) include = include && !matches(exId, row);
+                if (include) kept++;
+            }
+            expected.push_back(kept);
+        }
+
+        auto sharedResults = many.processTasks(sharedInput);
+        bool allMatch = sharedResults.size() == expected.size();
+        for (size_t t = 0; allMatch && t < expected.size(); ++t) {
+            if (sharedResults[t].matchedRows != expected[t]) {
+                std::cerr << "Task " << t << ": " << sharedResults[t].matchedRows << " rows, expected " << expected[t] << std::endl;
+                allMatch = false;
+            }
+        }
+        test(allMatch, "20 tasks sharing rules keep the expected rows");
+        std::cout << "Rule evaluations: " << many.ruleRowEvaluationCount() << " rows" << std::endl;
+        test(many.ruleRowEvaluationCount() == rowCount, "Rules are evaluated once per row for all tasks");
+
+        fs::remove(sharedInput);
+        for (int t = 0; t < 20; ++t) fs::remove("test_granular_shared_" + std::to_string(t) + ".csv");
+    }
+
     // Cleanup
     try {
         fs::remove(inputFile);
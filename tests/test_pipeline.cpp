@@ -0,0 +1,177 @@
+#include "ExcelProcessorCore.h"
+#include "../src/core/BoundedQueue.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static std::string readAll(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static const char* kOutputs[] = { "test_pipeline_a.csv", "test_pipeline_all.csv", "test_pipeline_shared.csv" };
+
+// Runs the task set once and returns the concatenated outputs
+static std::string runTasks(ExcelProcessorCore& processor, const std::string& inputFile, bool pipelined,
+                            std::vector<ProcessingResult>& results) {
+    for (const char* output : kOutputs) fs::remove(output);
+    processor.setPipelinedProcessing(pipelined);
+    results = processor.processTasks(inputFile, "test_pipeline_shared.csv");
+
+    std::string combined;
+    for (const char* output : kOutputs) combined += std::string(output) + "\n" + readAll(output);
+    return combined;
+}
+
+int main() {
+    // 1. Bounded queue keeps order and never holds more than its capacity
+    {
+        BoundedQueue<int> queue(3);
+        std::atomic<size_t> maxSize{ 0 };
+        std::thread producer([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                queue.push(i);
+                size_t size = queue.size();
+                if (size > maxSize) maxSize = size;
+            }
+            queue.close();
+        });
+
+        std::vector<int> received;
+        int value;
+        while (queue.pop(value)) {
+            received.push_back(value);
+            if (received.size() % 100 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        producer.join();
+
+        bool ordered = received.size() == 1000;
+        for (size_t i = 0; ordered && i < received.size(); ++i) ordered = received[i] == static_cast<int>(i);
+        test(ordered, "Items arrive in order");
+        test(maxSize <= 3, "Queue never exceeds its capacity");
+        test(!queue.push(1), "Push fails after close");
+    }
+
+    // 2. Pipelined and serial runs write identical output
+    const int rowCount = 23000; // Several 5000-row chunks, last one partial
+    std::string inputFile = "test_pipeline_input.csv";
+    {
+        std::ofstream out(inputFile);
+        out << "ID,Group,Note\n";
+        for (int i = 1; i <= rowCount; ++i) {
+            out << i << "," << (i % 3 == 0 ? "A" : "B") << ",\"note, " << i << "\"\n";
+        }
+    }
+
+    ExcelProcessorCore processor;
+
+    Rule ruleA;
+    ruleA.id = 1;
+    ruleA.name = "GroupA";
+    ruleA.type = RuleType::FILTER;
+    ruleA.enabled = true;
+    RuleCondition cond;
+    cond.column = 2;
+    cond.oper = Operator::EQUAL;
+    cond.value = std::string("A");
+    ruleA.conditions.push_back(cond);
+    processor.addRule(ruleA);
+
+    ProcessingTask filtered;
+    filtered.id = 1;
+    filtered.taskName = "Filtered";
+    filtered.outputWorkbookName = "test_pipeline_a.csv";
+    filtered.outputMode = OutputMode::NEW_WORKBOOK;
+    filtered.useHeader = true;
+    filtered.rules.push_back(TaskRuleEntry(ruleA.id));
+    processor.addTask(filtered);
+
+    ProcessingTask all;
+    all.id = 2;
+    all.taskName = "All";
+    all.outputWorkbookName = "test_pipeline_all.csv";
+    all.outputMode = OutputMode::NEW_WORKBOOK;
+    processor.addTask(all);
+
+    // Two tasks appending to the same file: the second one's header check must see the first one's rows
+    for (int id = 3; id <= 4; ++id) {
+        ProcessingTask shared;
+        shared.id = id;
+        shared.taskName = "Shared" + std::to_string(id);
+        shared.outputMode = OutputMode::NEW_SHEET;
+        shared.useHeader = true;
+        shared.rules.push_back(TaskRuleEntry(ruleA.id));
+        processor.addTask(shared);
+    }
+
+    std::vector<ProcessingResult> serialResults;
+    std::vector<ProcessingResult> pipelinedResults;
+    ExcelProcessorCore::setThreadCount(1);
+    std::string serial = runTasks(processor, inputFile, false, serialResults);
+    std::string pipelined = runTasks(processor, inputFile, true, pipelinedResults);
+
+    test(readAll("test_pipeline_all.csv").size() > 0, "Output written");
+    test(serial == pipelined, "Pipelined output matches serial output");
+    test(serialResults.size() == pipelinedResults.size(), "Same number of results");
+    for (size_t i = 0; i < serialResults.size(); ++i) {
+        test(serialResults[i].processedRows == pipelinedResults[i].processedRows &&
+             serialResults[i].totalRows == pipelinedResults[i].totalRows &&
+             pipelinedResults[i].errors.empty(), "Task statistics match");
+    }
+
+    // Rows evaluated and copied on several threads come out in the same order
+    std::vector<ProcessingResult> threadedResults;
+    ExcelProcessorCore::setThreadCount(4);
+    test(runTasks(processor, inputFile, false, threadedResults) == serial, "Multi-threaded output matches serial output");
+    test(runTasks(processor, inputFile, true, threadedResults) == serial, "Multi-threaded pipelined output matches serial output");
+    for (size_t i = 0; i < serialResults.size() && i < threadedResults.size(); ++i) {
+        test(serialResults[i].processedRows == threadedResults[i].processedRows, "Multi-threaded task statistics match");
+    }
+
+    std::string shared = readAll("test_pipeline_shared.csv");
+    test(shared.find("\"ID\"") == 0 && shared.find("\"ID\"", 1) == std::string::npos,
+         "Header written once to the shared target");
+
+    // 3. Write failures are reported against the task in both modes
+    {
+        ExcelProcessorCore failing;
+        ProcessingTask bad;
+        bad.id = 7;
+        bad.taskName = "Bad";
+        bad.outputWorkbookName = "test_pipeline_missing_dir/out.csv";
+        bad.outputMode = OutputMode::NEW_WORKBOOK;
+        failing.addTask(bad);
+
+        for (bool mode : { false, true }) {
+            failing.setPipelinedProcessing(mode);
+            auto results = failing.processTasks(inputFile);
+            test(results.size() == 1 && !results[0].errors.empty(),
+                 std::string("Write failure reported (") + (mode ? "pipelined" : "serial") + ")");
+        }
+    }
+
+    // Cleanup
+    try {
+        fs::remove(inputFile);
+        for (const char* output : kOutputs) fs::remove(output);
+    } catch (...) {}
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
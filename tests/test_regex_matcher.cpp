@@ -0,0 +1,155 @@
+#include "../src/core/RegexMatcher.h"
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+// Helper to print test results
+void test(bool result, const std::string& name) {
+    if (result) {
+        std::cout << "[PASS] " << name << std::endl;
+    } else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+// What std::regex_match says; an invalid pattern never matches
+bool reference(const std::string& pattern, const std::string& text, bool& valid) {
+    try {
+        std::regex re(pattern);
+        valid = true;
+        return std::regex_match(text, re);
+    } catch (const std::regex_error&) {
+        valid = false;
+        return false;
+    }
+}
+
+// Compares both engines with std::regex_match on every text; returns the number of disagreements
+int compare(const std::string& pattern, const std::vector<std::string>& texts) {
+    RegexMatcher automatic(pattern);
+    RegexMatcher standard(pattern, RegexMatcher::Engine::StdRegex);
+    int mismatches = 0;
+    for (const auto& text : texts) {
+        bool valid = false;
+        bool expected = reference(pattern, text, valid);
+        if (automatic.valid() != valid || automatic.matches(text) != expected || standard.matches(text) != expected) {
+            if (mismatches++ < 5) {
+                std::cerr << "  pattern '" << pattern << "' text '" << text << "' expected " << expected
+                          << (automatic.usesAutomaton() ? " (automaton)" : " (std::regex)") << std::endl;
+            }
+        }
+    }
+    return mismatches;
+}
+
+int main() {
+    // Test 1: Common rule patterns run on the automaton
+    {
+        const char* patterns[] = { "ABC", "prefix.*", ".*x.*", "[A-Z]{3}\\d{4}", "^\\d+$", "\\w+@\\w+\\.com",
+                                   "[^,]*", "a?b+c{2,}", "\\s*", "" };
+        bool all = true;
+        for (const char* pattern : patterns) {
+            if (!RegexMatcher(pattern).usesAutomaton()) {
+                std::cerr << "  not on the automaton: " << pattern << std::endl;
+                all = false;
+            }
+        }
+        test(all, "Simple patterns use the automaton");
+    }
+
+    // Test 2: Unsupported syntax falls back, invalid patterns never match
+    {
+        const char* fallback[] = { "(ab)+", "a|b", "\\bword", "(a)\\1", "a**", "[[:alpha:]]+", "\xe6\x98\xaf.*" };
+        bool all = true;
+        for (const char* pattern : fallback) {
+            RegexMatcher matcher(pattern);
+            if (matcher.usesAutomaton()) all = false;
+        }
+        test(all, "Groups, alternation, boundaries and non-ASCII use std::regex");
+
+        RegexMatcher invalid("[a-");
+        test(!invalid.valid() && !invalid.matches("a") && !invalid.matches(""), "Invalid pattern never matches");
+        test(!RegexMatcher("a{2,1}").valid(), "Reversed repeat bounds are invalid");
+    }
+
+    // Test 3: Hand-picked cases against std::regex_match
+    {
+        std::vector<std::string> texts = { "", "a", "ab", "abc", "ABC", "aab", "abb", "abbb", "x", "xx", "axb",
+                                           "A1234", "ABC1234", "abc1234", "12", "0", "a.b", "a\nb", "a\rb",
+                                           " \t", "user@host.com", "a,b", "-", "]", "$", "^", "\\", "\x80", "a\xff" };
+        const char* patterns[] = { "a", "ab*", "a+b", "a?b?", "a.b", "a\\.b", "a*b*c*", "[a-c]+", "[^a]*", "[\\d]+",
+                                   "[A-Z]{3}\\d{4}", "\\d{1,3}", "\\d{2,}", "x{0}", "x{0,1}", ".*", ".+", "\\D*", "\\W",
+                                   "\\S+", "[-a]", "[a-]", "[\\]]", "\\$", "a\\\\", "\\x41BC", "[\\x30-\\x39]+",
+                                   "^abc$", "^", "$", "a*?b", "\\w+@\\w+\\.com", "[^,]*,[^,]*", "a$", "^$", "\\^",
+                                   "[]a]", "a{", "a{1", "a{,2}", "}", "]", "[b-a]", "\\", "[\\d-z]", "a{3,3}b{0,}" };
+        int mismatches = 0;
+        for (const char* pattern : patterns) mismatches += compare(pattern, texts);
+        test(mismatches == 0, "Hand-picked patterns agree with std::regex_match");
+    }
+
+    // Test 4: Random patterns over the supported grammar against std::regex_match
+    {
+        std::mt19937 rng(1234);
+        const std::vector<std::string> atoms = { "a", "b", "c", ".", "\\d", "\\w", "\\s", "\\D", "[a-c]", "[^b]",
+                                                 "[ab1]", "\\.", "-", "1", " ", "\\n", "[\\s,]" };
+        const std::vector<std::string> quantifiers = { "", "", "", "*", "+", "?", "{2}", "{1,3}", "{0,2}", "{2,}", "*?" };
+        const std::string alphabet = "abc1 ._-,\n\r\x80\xff";
+
+        std::vector<std::string> patterns;
+        for (int i = 0; i < 400; ++i) {
+            std::string pattern = rng() % 4 == 0 ? "^" : "";
+            int length = 1 + rng() % 6;
+            for (int j = 0; j < length; ++j) {
+                pattern += atoms[rng() % atoms.size()];
+                pattern += quantifiers[rng() % quantifiers.size()];
+            }
+            if (rng() % 4 == 0) pattern += "$";
+            patterns.push_back(pattern);
+        }
+
+        std::vector<std::string> texts;
+        for (int i = 0; i < 60; ++i) {
+            std::string text;
+            int length = rng() % 9;
+            for (int j = 0; j < length; ++j) text += alphabet[rng() % alphabet.size()];
+            texts.push_back(text);
+        }
+
+        int mismatches = 0;
+        int onAutomaton = 0;
+        for (const auto& pattern : patterns) {
+            mismatches += compare(pattern, texts);
+            if (RegexMatcher(pattern).usesAutomaton()) onAutomaton++;
+        }
+        std::cout << "  " << onAutomaton << " of " << patterns.size() << " random patterns on the automaton" << std::endl;
+        test(mismatches == 0, "Random patterns agree with std::regex_match");
+        test(onAutomaton == static_cast<int>(patterns.size()), "Random grammar patterns all use the automaton");
+    }
+
+    // Test 5: Long patterns beyond the automaton width still match correctly
+    {
+        std::string pattern = "a{40}b{30}";
+        std::string text = std::string(40, 'a') + std::string(30, 'b');
+        RegexMatcher matcher(pattern);
+        test(!matcher.usesAutomaton() && matcher.matches(text) && !matcher.matches(text + "b"), "Wide pattern falls back");
+
+        RegexMatcher wide("a{30}b*c{30}");
+        test(wide.usesAutomaton() && wide.matches(std::string(30, 'a') + "bbb" + std::string(30, 'c')) &&
+             !wide.matches(std::string(29, 'a') + std::string(30, 'c')), "Pattern of 61 positions on the automaton");
+    }
+
+    // Test 6: The cache hands out one matcher per pattern and engine
+    {
+        auto first = RegexMatcher::cached("\\d+");
+        auto second = RegexMatcher::cached("\\d+");
+        auto standard = RegexMatcher::cached("\\d+", RegexMatcher::Engine::StdRegex);
+        test(first == second && first != standard && !standard->usesAutomaton() && standard->matches("42"),
+             "Cached matchers are shared");
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static std::vector<std::string> readLines(const std::string& filename) {
+    std::vector<std::string> lines;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+static Rule makeRule(int id, RuleType type, int column, Operator oper, const std::string& value) {
+    Rule rule;
+    rule.id = id;
+    rule.name = "Rule " + std::to_string(id);
+    rule.type = type;
+    RuleCondition cond;
+    cond.column = column;
+    cond.oper = oper;
+    cond.value = value;
+    rule.conditions.push_back(cond);
+    return rule;
+}
+
+int main() {
+    // IDs spanning several chunks: odd rows are group A
+    const int rowCount = 25000;
+    std::string inputFile = "test_rule_combination_input.csv";
+    std::string outputFile = "test_rule_combination_output.csv";
+    {
+        std::ofstream out(inputFile);
+        out << "ID,Group\n";
+        for (int i = 1; i <= rowCount; ++i) out << i << "," << (i % 2 ? "A" : "B") << "\n";
+    }
+
+    // Rule IDs do not follow their positions, so combinations must look rules up by ID
+    ExcelProcessorCore processor;
+    processor.addRule(makeRule(20, RuleType::DELETE_ROW, 1, Operator::ENDS_WITH, "5"));
+    processor.addRule(makeRule(10, RuleType::FILTER, 2, Operator::EQUAL, "A"));
+    processor.addRule(makeRule(30, RuleType::FILTER, 1, Operator::LESS_EQUAL, "20000"));
+    processor.createRuleCombination(1, { 10, 30 });
+    processor.createRuleCombination(2, { 20, 99 }); // 99 does not exist and is skipped
+
+    ProcessingResult result = processor.processExcelFile(inputFile, outputFile);
+
+    // Kept: odd IDs up to 20000 that do not end in 5
+    int expected = 0;
+    for (int i = 1; i <= 20000; i += 2) expected += i % 10 != 5;
+
+    int kept = 0;
+    bool onlyExpected = true;
+    for (const auto& line : readLines(outputFile)) {
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) continue;
+        std::string id = line.substr(0, comma);
+        id.erase(std::remove(id.begin(), id.end(), '"'), id.end());
+        if (id == "ID") continue;
+        int value = std::stoi(id);
+        kept++;
+        if (value % 2 == 0 || value > 20000 || value % 10 == 5) onlyExpected = false;
+    }
+    test(kept == expected && onlyExpected, "Combinations resolve rules by ID (" + std::to_string(kept) + " rows kept)");
+    test(result.matchedRows == expected, "Matched rows counted once per kept row");
+
+    // Delete combinations only: every other row stays, in input order
+    ExcelProcessorCore deleting;
+    deleting.addRule(makeRule(7, RuleType::DELETE_ROW, 2, Operator::EQUAL, "B"));
+    deleting.createRuleCombination(1, { 7 });
+    result = deleting.processExcelFile(inputFile, outputFile);
+
+    std::vector<int> ids;
+    for (const auto& line : readLines(outputFile)) {
+        std::string id = line.substr(0, line.find(','));
+        id.erase(std::remove(id.begin(), id.end(), '"'), id.end());
+        if (!id.empty() && id != "ID") ids.push_back(std::stoi(id));
+    }
+    bool inOrder = ids.size() == static_cast<size_t>(rowCount / 2);
+    for (size_t i = 0; inOrder && i < ids.size(); ++i) inOrder = ids[i] == static_cast<int>(2 * i + 1);
+    test(inOrder && result.matchedRows == 0, "Deleted rows are dropped and the rest keep their order");
+
+    std::remove(inputFile.c_str());
+    std::remove(outputFile.c_str());
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
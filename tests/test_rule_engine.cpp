@@ -2,6 +2,10 @@
 #include <cassert>
 #include <iostream>
 #include <variant>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 // Helper to print test results
 void test(bool result, const std::string& name) {
@@ -24,7 +28,7 @@ int main() {
         cond.type = DataType::STRING; // User treats it as string rule
         
         // Excel cell value is double 5.0
-        std::variant<std::string, int, double, bool, std::tm> val = 5.0;
+        CellValue val = 5.0;
         
         bool result = engine->evaluateCondition(cond, val);
         test(result, "Double 5.0 CONTAINS '5.0'");
@@ -38,7 +42,7 @@ int main() {
         cond.type = DataType::STRING;
         
         // Excel cell value is double 5.0 (should NOT contain 15.0)
-        std::variant<std::string, int, double, bool, std::tm> val = 5.0;
+        CellValue val = 5.0;
         
         bool result = engine->evaluateCondition(cond, val);
         test(result, "Double 5.0 NOT_CONTAINS '15.0'");
@@ -52,7 +56,7 @@ int main() {
         cond.type = DataType::STRING;
         
         // Excel cell value is double 15.0
-        std::variant<std::string, int, double, bool, std::tm> val = 15.0;
+        CellValue val = 15.0;
         
         bool result = engine->evaluateCondition(cond, val);
         test(!result, "Double 15.0 NOT_CONTAINS '15.0' should be false");
@@ -66,7 +70,7 @@ int main() {
         cond.type = DataType::STRING;
         
         // Excel cell value is int 5
-        std::variant<std::string, int, double, bool, std::tm> val = 5;
+        CellValue val = 5;
         
         bool result = engine->evaluateCondition(cond, val);
         test(result, "Int 5 CONTAINS '5'");
@@ -80,12 +84,304 @@ int main() {
         cond.type = DataType::STRING;
         
         // Excel cell value is double 5.0
-        std::variant<std::string, int, double, bool, std::tm> val = 5.0;
+        CellValue val = 5.0;
         
         bool result = engine->evaluateCondition(cond, val);
         test(result, "Double 5.0 STARTS_WITH '5.'");
     }
 
+    // Test 5b: IN_LIST matches any comma-separated item, as text or as a number
+    {
+        RuleCondition cond;
+        cond.column = 1;
+        cond.oper = Operator::IN_LIST;
+        cond.value = std::string("C001, c002 ,, 17");
+        Rule rule;
+        rule.id = 1;
+        rule.conditions.push_back(cond);
+        auto compiled = engine->compileRule(rule);
+        bool allAgree = true;
+        bool expectedAll = true;
+        for (auto [cell, expected] : std::vector<std::pair<CellValue, bool>>{
+                 { std::string("c001"), true }, { std::string(" C002"), true }, { std::string("C003"), false },
+                 { std::string(""), false }, { 17, true }, { 17.0, true }, { std::string("17.0"), true }, { 18, false } }) {
+            DataRow row;
+            row.data.push_back(cell);
+            expectedAll = expectedAll && engine->evaluateCondition(cond, cell) == expected;
+            allAgree = allAgree && compiled->matches(row) == expected;
+        }
+        test(expectedAll && allAgree, "IN_LIST matches list items");
+    }
+
+    // Test 6: Compiled rules agree with the interpreter on the cases above and on random rules and rows
+    {
+        using Cell = CellValue;
+        std::tm date = {};
+        date.tm_year = 124;
+        date.tm_mon = 0;
+        date.tm_mday = 5;
+
+        const std::vector<std::string> texts = { "", " ", "abc", " ABC ", "Abc", "5", "5.0", " 5 ", "5.000000", "15", "15.0",
+            "-3.5", "1e3", "1E3", "1000", "inf", "NaN", "0x1A", "true", "TRUE", "yes", "\xe6\x98\xaf", "340*12", "*12", "340*",
+            "a*b", "12 * 7", "2024-01-05", "abc123", "1e999", "1e-320", "  12abc", "[a-z]+", "(", "a|b", "5.", "0" };
+        const std::vector<Cell> cells = { 5.0, 15.0, 5, 0, -5, 340, 1000, -3.5, 1e-11, 5.00000000001, 1e300,
+            std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), true, false, date };
+
+        std::mt19937 rng(2024);
+        auto pick = [&rng](size_t n) { return static_cast<size_t>(rng() % n); };
+        auto randomCell = [&]() -> Cell {
+            if (rng() % 2) return texts[pick(texts.size())];
+            return cells[pick(cells.size())];
+        };
+        auto randomCondition = [&]() {
+            RuleCondition cond;
+            cond.column = rng() % 10 == 0 ? -1 : 1 + static_cast<int>(pick(4));
+            cond.oper = static_cast<Operator>(pick(static_cast<size_t>(Operator::IN_LIST) + 1));
+            switch (rng() % 4) {
+                case 0: cond.value = static_cast<int>(pick(20)) - 5; break;
+                case 1: cond.value = std::vector<double>{ 5.0, -3.5, 1e-11, 0.0 }[pick(4)]; break;
+                case 2: cond.value = rng() % 2 == 0; break;
+                default: cond.value = texts[pick(texts.size())];
+            }
+            if (cond.oper == Operator::IN_LIST && rng() % 2) {
+                std::string list = texts[pick(texts.size())];
+                for (int n = static_cast<int>(pick(5)); n > 0; --n) list += (rng() % 3 ? "," : ", ,") + texts[pick(texts.size())];
+                cond.value = list;
+            }
+            cond.case_sensitive = rng() % 3 == 0;
+            if (rng() % 5 == 0) {
+                cond.splitSymbol = std::vector<std::string>{ "*", "", "x" }[pick(3)];
+                cond.splitTarget = static_cast<SplitTarget>(pick(4));
+            }
+            return cond;
+        };
+
+        // The single-condition cases of tests 1-5
+        std::vector<std::pair<RuleCondition, Cell>> cases;
+        for (auto [oper, text, cell] : std::vector<std::tuple<Operator, std::string, Cell>>{
+                 { Operator::CONTAINS, "5.0", 5.0 }, { Operator::NOT_CONTAINS, "15.0", 5.0 },
+                 { Operator::NOT_CONTAINS, "15.0", 15.0 }, { Operator::CONTAINS, "5", 5 }, { Operator::STARTS_WITH, "5.", 5.0 } }) {
+            RuleCondition cond;
+            cond.column = 1;
+            cond.oper = oper;
+            cond.value = text;
+            cases.push_back({ cond, cell });
+        }
+
+        int evaluations = 0;
+        int mismatches = 0;
+        for (const auto& c : cases) {
+            Rule rule;
+            rule.id = 1;
+            rule.conditions.push_back(c.first);
+            DataRow row;
+            row.data.push_back(c.second);
+            bool expected = engine->evaluateCondition(c.first, c.second);
+            if (engine->evaluateRule(rule, row) != expected || engine->compileRule(rule)->matches(row) != expected) mismatches++;
+            evaluations++;
+        }
+
+        for (int r = 0; r < 20000; ++r) {
+            Rule rule;
+            rule.id = 1;
+            rule.type = static_cast<RuleType>(pick(5)); // 4 is not a valid type
+            rule.enabled = rng() % 8 != 0;
+            rule.logic = rng() % 2 ? RuleLogic::AND : RuleLogic::OR;
+            int conditionCount = static_cast<int>(pick(4));
+            for (int c = 0; c < conditionCount; ++c) rule.conditions.push_back(randomCondition());
+            auto compiled = engine->compileRule(rule);
+
+            for (int n = 0; n < 10; ++n) {
+                DataRow row;
+                int cellCount = static_cast<int>(pick(5));
+                for (int c = 0; c < cellCount; ++c) row.data.push_back(randomCell());
+                bool expected = engine->evaluateRule(rule, row);
+                if (compiled->matches(row) != expected) {
+                    if (mismatches++ == 0) {
+                        std::cerr << "First mismatch: rule " << r << " (" << rule.conditions.size() << " conditions), row " << n
+                                  << ", expected " << expected << std::endl;
+                    }
+                }
+                evaluations++;
+            }
+        }
+        test(mismatches == 0, "Compiled rules match the interpreter (" + std::to_string(evaluations) + " evaluations)");
+
+        // Test 7: Rule sets, with keyword lists sharing a column scan and value lists sharing a lookup,
+        // agree with the interpreter rule by rule
+        const std::vector<std::string> keywords = { "", "a", "ab", "abc", "bc", "c", "ABC", "b c", "5", "5.0", "12", "0000",
+                                                    "true", "2024", "\xe6\x98\xaf", "*", " abc " };
+        evaluations = 0;
+        mismatches = 0;
+        for (int s = 0; s < 400; ++s) {
+            std::vector<Rule> rules;
+            int ruleCount = 1 + static_cast<int>(pick(90));
+            for (int r = 0; r < ruleCount; ++r) {
+                Rule rule;
+                rule.id = rng() % 20 == 0 ? 1 : r + 1; // Some duplicate ids: the first one wins
+                rule.type = static_cast<RuleType>(pick(5));
+                rule.enabled = rng() % 8 != 0;
+                rule.logic = rng() % 2 ? RuleLogic::AND : RuleLogic::OR;
+                int conditionCount = static_cast<int>(pick(4));
+                for (int c = 0; c < conditionCount; ++c) {
+                    RuleCondition cond = randomCondition();
+                    if (rng() % 4 != 0) {
+                        cond.oper = std::vector<Operator>{ Operator::CONTAINS, Operator::CONTAINS, Operator::NOT_CONTAINS,
+                                                           Operator::EQUAL, Operator::EQUAL, Operator::IN_LIST }[pick(6)];
+                        cond.column = 1 + static_cast<int>(pick(2));
+                        cond.value = keywords[pick(keywords.size())];
+                        if (cond.oper == Operator::IN_LIST) {
+                            std::string list = keywords[pick(keywords.size())];
+                            for (int n = static_cast<int>(pick(6)); n > 0; --n) list += "," + texts[pick(texts.size())];
+                            cond.value = list;
+                        }
+                        cond.splitTarget = SplitTarget::NONE;
+                    }
+                    rule.conditions.push_back(cond);
+                }
+                rules.push_back(rule);
+            }
+            auto ruleSet = engine->compileRuleSet(rules);
+
+            std::vector<uint64_t> results;
+            for (int n = 0; n < 10; ++n) {
+                DataRow row;
+                int cellCount = static_cast<int>(pick(4));
+                for (int c = 0; c < cellCount; ++c) {
+                    if (rng() % 2) row.data.push_back(randomCell());
+                    else row.data.push_back(keywords[pick(keywords.size())] + texts[pick(texts.size())] + keywords[pick(keywords.size())]);
+                }
+                ruleSet->evaluate(row, results);
+                for (const auto& rule : rules) {
+                    int index = ruleSet->ruleIndex(rule.id);
+                    const Rule& first = *std::find_if(rules.begin(), rules.end(), [&rule](const Rule& r) { return r.id == rule.id; });
+                    bool matched = index >= 0 && ((results[index / 64] >> (index % 64)) & 1);
+                    if (matched != engine->evaluateRule(first, row)) {
+                        if (mismatches++ == 0) {
+                            std::cerr << "First mismatch: set " << s << ", rule id " << rule.id << ", row " << n << std::endl;
+                        }
+                    }
+                    evaluations++;
+                }
+            }
+        }
+        test(mismatches == 0, "Rule sets match the interpreter (" + std::to_string(evaluations) + " evaluations)");
+        test(engine->compileRuleSet({})->ruleCount() == 0 && engine->compileRuleSet({})->ruleIndex(1) == -1, "Empty rule set");
+
+        // Keywords that use every byte value leave no byte for the shared column
+        std::vector<Rule> everyByte;
+        for (int b = 0; b < 256; ++b) {
+            Rule rule;
+            rule.id = b + 1;
+            rule.type = RuleType::FILTER;
+            rule.enabled = true;
+            RuleCondition cond;
+            cond.column = 1;
+            cond.oper = Operator::CONTAINS;
+            cond.case_sensitive = true;
+            cond.value = std::string(1, static_cast<char>(b)) + "x";
+            rule.conditions.push_back(cond);
+            everyByte.push_back(rule);
+        }
+        auto everyByteSet = engine->compileRuleSet(everyByte);
+        mismatches = 0;
+        for (const std::string& text : { std::string("\xffx"), std::string("ax\x80"), std::string("xx", 2), std::string("\0x", 2) }) {
+            DataRow row;
+            row.data.push_back(text);
+            std::vector<uint64_t> results;
+            everyByteSet->evaluate(row, results);
+            for (const auto& rule : everyByte) {
+                int index = everyByteSet->ruleIndex(rule.id);
+                bool matched = (results[index / 64] >> (index % 64)) & 1;
+                mismatches += matched != engine->evaluateRule(rule, row);
+            }
+        }
+        test(mismatches == 0, "Rule set with keywords over all 256 byte values");
+
+        // Test 8: Column-at-a-time evaluation of a chunk gives the row-at-a-time answers, across word
+        // boundaries, ragged rows and columns left out of the chunk
+        evaluations = 0;
+        mismatches = 0;
+        ColumnarChunk chunk;
+        for (int s = 0; s < 150; ++s) {
+            std::vector<Rule> rules;
+            int ruleCount = 1 + static_cast<int>(pick(40));
+            for (int r = 0; r < ruleCount; ++r) {
+                Rule rule;
+                rule.id = r + 1;
+                rule.type = static_cast<RuleType>(pick(5));
+                rule.enabled = rng() % 8 != 0;
+                rule.logic = rng() % 2 ? RuleLogic::AND : RuleLogic::OR;
+                int conditionCount = static_cast<int>(pick(4));
+                for (int c = 0; c < conditionCount; ++c) {
+                    RuleCondition cond = randomCondition();
+                    if (rng() % 3 == 0) {
+                        cond.oper = std::vector<Operator>{ Operator::CONTAINS, Operator::NOT_CONTAINS, Operator::EQUAL,
+                                                           Operator::IN_LIST }[pick(4)];
+                        cond.value = rng() % 2 ? keywords[pick(keywords.size())] : "5,abc,true, 15.0";
+                        cond.splitTarget = SplitTarget::NONE;
+                    }
+                    rule.conditions.push_back(cond);
+                }
+                rules.push_back(rule);
+            }
+            auto ruleSet = engine->compileRuleSet(rules);
+
+            std::vector<DataRow> rows(pick(200));
+            for (auto& row : rows) {
+                int cellCount = static_cast<int>(pick(6));
+                for (int c = 0; c < cellCount; ++c) row.data.push_back(randomCell());
+            }
+            if (s % 2) chunk.assign(rows);
+            else chunk.assign(rows, ruleSet->columns());
+
+            std::vector<std::vector<uint64_t>> ruleRows;
+            std::vector<uint64_t> results;
+            ruleSet->evaluateColumns(chunk, ruleRows);
+            bool shaped = ruleRows.size() == rules.size();
+            for (const auto& bitmap : ruleRows) shaped = shaped && bitmap.size() == (rows.size() + 63) / 64;
+            if (!shaped) {
+                mismatches++;
+                continue;
+            }
+            for (size_t n = 0; n < rows.size(); ++n) {
+                ruleSet->evaluate(rows[n], results);
+                for (size_t r = 0; r < rules.size(); ++r) {
+                    bool byRow = (results[r / 64] >> (r % 64)) & 1;
+                    bool byColumn = (ruleRows[r][n / 64] >> (n % 64)) & 1;
+                    if (byRow != byColumn && mismatches++ == 0) {
+                        std::cerr << "First mismatch: set " << s << ", rule " << r << ", row " << n << std::endl;
+                    }
+                    evaluations++;
+                }
+            }
+        }
+        test(mismatches == 0, "Columnar evaluation matches row evaluation (" + std::to_string(evaluations) + " evaluations)");
+    }
+
+    // Test 9: A chunk's text columns hold each distinct text once
+    {
+        std::vector<DataRow> rows(300);
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i].data.push_back(std::string(i % 3 == 0 ? "North" : i % 3 == 1 ? "South" : "East"));
+            if (i % 5 == 0) rows[i].data.push_back(static_cast<int>(i));
+            else rows[i].data.push_back(CellDate::fromDate(2024, 1, 1 + static_cast<int>(i % 2)));
+        }
+        ColumnarChunk chunk;
+        chunk.assign(rows);
+        const auto& region = chunk.column(0);
+        const auto& date = chunk.column(1);
+        test(region.dictionary.size() == 3 && region.textAt(0) == "North" && region.textAt(299) == "East" &&
+             region.codes[3] == region.codes[0], "Repeated text shares a dictionary entry");
+        test(date.dictionary.size() == 2 && date.textAt(1) == "2024-01-02" && date.types[5] == ColumnarChunk::CellType::Int,
+             "Dates are interned as text, numbers stay out of the dictionary");
+
+        rows.resize(10);
+        for (auto& row : rows) row.data[0] = std::string("West");
+        chunk.assign(rows);
+        test(chunk.column(0).dictionary.size() == 1 && chunk.column(0).textAt(9) == "West", "Dictionary is rebuilt per chunk");
+    }
+
     std::cout << "All tests passed!" << std::endl;
     return 0;
 }
@@ -0,0 +1,112 @@
+#include "ExcelProcessorCore.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static std::vector<std::string> readLines(const std::string& filename) {
+    std::vector<std::string> lines;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(line);
+    return lines;
+}
+
+int main() {
+    // 1. Input spanning several 5000-row chunks
+    const int rowCount = 12000;
+    std::string inputFile = "test_task_output_input.csv";
+    {
+        std::ofstream out(inputFile);
+        out << "ID,Group\n";
+        for (int i = 1; i <= rowCount; ++i) out << i << "," << (i % 2 ? "A" : "B") << "\n";
+    }
+
+    // Existing destination for the append-mode task: not empty, so no header is added
+    std::string appendFile = "test_task_output_append.csv";
+    {
+        std::ofstream out(appendFile);
+        out << "\"existing\"\n";
+    }
+
+    ExcelProcessorCore processor;
+
+    Rule ruleA;
+    ruleA.id = 1;
+    ruleA.name = "GroupA";
+    ruleA.type = RuleType::FILTER;
+    ruleA.enabled = true;
+    RuleCondition cond;
+    cond.column = 2;
+    cond.oper = Operator::EQUAL;
+    cond.value = std::string("A");
+    ruleA.conditions.push_back(cond);
+    processor.addRule(ruleA);
+
+    ProcessingTask filtered;
+    filtered.id = 1;
+    filtered.taskName = "Filtered";
+    filtered.outputWorkbookName = "test_task_output_a.csv";
+    filtered.outputMode = OutputMode::NEW_WORKBOOK;
+    filtered.useHeader = true;
+    filtered.rules.push_back(TaskRuleEntry(ruleA.id));
+    processor.addTask(filtered);
+
+    ProcessingTask all;
+    all.id = 2;
+    all.taskName = "All";
+    all.outputWorkbookName = "test_task_output_all.csv";
+    all.outputMode = OutputMode::NEW_WORKBOOK;
+    processor.addTask(all);
+
+    ProcessingTask appended;
+    appended.id = 3;
+    appended.taskName = "Appended";
+    appended.outputMode = OutputMode::NEW_SHEET;
+    appended.useHeader = true;
+    appended.rules.push_back(TaskRuleEntry(ruleA.id));
+    processor.addTask(appended);
+
+    // 2. Two runs: NEW_WORKBOOK outputs are rewritten, the append target grows
+    for (int run = 1; run <= 2; ++run) {
+        auto results = processor.processTasks(inputFile, appendFile);
+        test(results.size() == 3, "Three task results (run " + std::to_string(run) + ")");
+        for (const auto& result : results) test(result.errors.empty(), "Task succeeded");
+
+        auto filteredLines = readLines("test_task_output_a.csv");
+        test(filteredLines.size() == rowCount / 2 + 1, "Filtered output has header and matching rows only");
+        test(filteredLines[0] == "\"ID\",\"Group\"", "Header written once at the top");
+        test(filteredLines[1] == "1,\"A\"" && filteredLines.back() == std::to_string(rowCount - 1) + ",\"A\"",
+             "Rows from every chunk in input order");
+
+        auto allLines = readLines("test_task_output_all.csv");
+        test(allLines.size() == rowCount, "Unfiltered output has every data row");
+        test(allLines[4999] == "5000,\"B\"" && allLines[5000] == "5001,\"A\"", "Chunk boundary is seamless");
+
+        auto appendLines = readLines(appendFile);
+        test(appendLines.size() == static_cast<size_t>(1 + run * (rowCount / 2)), "Append target keeps existing content and grows each run");
+        test(appendLines[0] == "\"existing\"" && appendLines[1] == "1,\"A\"", "No header appended to a non-empty target");
+    }
+
+    // Cleanup
+    try {
+        fs::remove(inputFile);
+        fs::remove(appendFile);
+        fs::remove("test_task_output_a.csv");
+        fs::remove("test_task_output_all.csv");
+    } catch (...) {}
+
+    std::cout << "Task output test passed!" << std::endl;
+    return 0;
+}
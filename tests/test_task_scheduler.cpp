@@ -0,0 +1,116 @@
+#include "../src/core/TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+// Runs parallelFor and checks every item was visited exactly once
+bool coversOnce(TaskScheduler& scheduler, size_t count, size_t morselSize) {
+    std::vector<std::atomic<int>> visits(count);
+    for (auto& v : visits) v = 0;
+    scheduler.parallelFor(count, morselSize, [&](size_t begin, size_t end) {
+        if (end - begin > std::max<size_t>(1, morselSize)) visits[begin] += 100; // Oversized morsel
+        for (size_t i = begin; i < end; ++i) visits[i]++;
+    });
+    for (auto& v : visits) {
+        if (v != 1) return false;
+    }
+    return true;
+}
+
+int main() {
+    // Test 1: Every item runs once, whatever the thread count and morsel size
+    {
+        bool all = true;
+        for (size_t threads : { 1, 2, 4, 7 }) {
+            TaskScheduler scheduler(threads);
+            all = all && scheduler.threadCount() == threads;
+            all = all && coversOnce(scheduler, 0, 10) && coversOnce(scheduler, 1, 10) && coversOnce(scheduler, 1000, 1) &&
+                  coversOnce(scheduler, 100000, 1024) && coversOnce(scheduler, 12345, 0);
+        }
+        test(all, "parallelFor covers every item once");
+    }
+
+    // Test 2: Morsels spread over the threads and the counters add up
+    {
+        TaskScheduler scheduler(4);
+        scheduler.resetStats();
+        scheduler.parallelFor(400, 1, [](size_t, size_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        });
+        auto stats = scheduler.workerStats();
+        uint64_t morsels = 0;
+        size_t busyThreads = 0;
+        for (const auto& s : stats) {
+            morsels += s.morsels;
+            if (s.morsels > 0) busyThreads++;
+        }
+        test(stats.size() == 4 && morsels == 400, "Counters see every morsel");
+        test(busyThreads >= 2 && stats[1].busySeconds > 0.0, "Workers share the morsels");
+        test(scheduler.statsSeconds() > 0.0, "Counters cover the elapsed time");
+    }
+
+    // Test 3: Calls from inside a morsel and from several threads at once complete
+    {
+        TaskScheduler scheduler(3);
+        std::atomic<size_t> inner{ 0 };
+        scheduler.parallelFor(16, 1, [&](size_t, size_t) {
+            scheduler.parallelFor(100, 7, [&](size_t begin, size_t end) { inner += end - begin; });
+        });
+        test(inner == 1600, "Nested parallelFor completes");
+
+        std::atomic<size_t> total{ 0 };
+        std::vector<std::thread> callers;
+        for (int c = 0; c < 4; ++c) {
+            callers.emplace_back([&]() {
+                for (int round = 0; round < 50; ++round) {
+                    scheduler.parallelFor(1000, 64, [&](size_t begin, size_t end) { total += end - begin; });
+                }
+            });
+        }
+        for (auto& caller : callers) caller.join();
+        test(total == 4 * 50 * 1000, "Concurrent callers share the workers");
+    }
+
+    // Test 4: An exception reaches the caller after the other morsels ran
+    {
+        TaskScheduler scheduler(4);
+        std::atomic<int> ran{ 0 };
+        bool caught = false;
+        try {
+            scheduler.parallelFor(100, 1, [&](size_t begin, size_t) {
+                ran++;
+                if (begin == 37) throw std::runtime_error("morsel 37");
+            });
+        } catch (const std::runtime_error& e) {
+            caught = std::string(e.what()) == "morsel 37";
+        }
+        test(caught && ran == 100, "First exception is rethrown");
+    }
+
+    // Test 5: The thread count can change between runs
+    {
+        TaskScheduler scheduler(2);
+        scheduler.setThreadCount(5);
+        bool resized = scheduler.threadCount() == 5 && coversOnce(scheduler, 5000, 10);
+        scheduler.setThreadCount(1);
+        resized = resized && scheduler.threadCount() == 1 && coversOnce(scheduler, 5000, 10);
+        scheduler.setThreadCount(0);
+        resized = resized && scheduler.threadCount() >= 1 && coversOnce(scheduler, 5000, 10);
+        test(resized, "Thread count changes between runs");
+    }
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,594 @@
+#include "ExcelProcessorCore.h"
+#include "../src/core/XlsxParser.h"
+#include "CellText.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <queue>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Minimal DEFLATE encoder and zip writer, so the test can build its own .xlsx files
+// ---------------------------------------------------------------------------
+
+enum class BlockMode { Stored, Fixed, Dynamic };
+
+class BitWriter {
+public:
+    void put(uint32_t value, int bits) {
+        for (int i = 0; i < bits; ++i) {
+            if (count_ == 0) out.push_back(0);
+            if ((value >> i) & 1) out.back() |= static_cast<char>(1 << count_);
+            count_ = (count_ + 1) & 7;
+        }
+    }
+    // Huffman codes are written most significant bit first
+    void putCode(uint32_t code, int length) {
+        for (int i = length - 1; i >= 0; --i) put((code >> i) & 1, 1);
+    }
+    void align() { count_ = 0; }
+    std::string out;
+
+private:
+    int count_ = 0;
+};
+
+struct Token {
+    int literal;      // -1 for a match
+    int length;
+    int distance;
+};
+
+static const int kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const int kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const int kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                   257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const int kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static int lengthSymbol(int length) {
+    int i = 28;
+    while (kLengthBase[i] > length) --i;
+    return i;
+}
+
+static int distanceSymbol(int distance) {
+    int i = 29;
+    while (kDistBase[i] > distance) --i;
+    return i;
+}
+
+// Greedy LZ77 with a hash of the next three bytes
+static std::vector<Token> tokenize(const std::string& data) {
+    std::vector<Token> tokens;
+    std::vector<int> head(1 << 15, -1);
+    std::vector<int> prev(data.size(), -1);
+    auto hash = [&](size_t i) {
+        return ((static_cast<unsigned char>(data[i]) << 10) ^ (static_cast<unsigned char>(data[i + 1]) << 5) ^
+                static_cast<unsigned char>(data[i + 2])) & 0x7FFF;
+    };
+    size_t i = 0;
+    while (i < data.size()) {
+        int bestLength = 0, bestDistance = 0;
+        if (i + 3 <= data.size()) {
+            int candidate = head[hash(i)];
+            for (int tries = 0; candidate >= 0 && tries < 32; ++tries, candidate = prev[candidate]) {
+                int distance = static_cast<int>(i) - candidate;
+                if (distance > 32768) break;
+                int length = 0;
+                while (length < 258 && i + length < data.size() && data[candidate + length] == data[i + length]) ++length;
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = distance;
+                }
+            }
+        }
+        size_t advance = bestLength >= 3 ? bestLength : 1;
+        if (bestLength >= 3) tokens.push_back({ -1, bestLength, bestDistance });
+        else tokens.push_back({ static_cast<unsigned char>(data[i]), 0, 0 });
+        for (size_t k = i; k < i + advance; ++k) {
+            if (k + 3 <= data.size()) {
+                prev[k] = head[hash(k)];
+                head[hash(k)] = static_cast<int>(k);
+            }
+        }
+        i += advance;
+    }
+    return tokens;
+}
+
+// Code lengths (at most 15 bits) for the given symbol frequencies
+static std::vector<int> huffmanLengths(std::vector<long> freq) {
+    while (true) {
+        std::vector<int> lengths(freq.size(), 0);
+        using Node = std::pair<long, int>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+        std::vector<int> parent;
+        for (size_t s = 0; s < freq.size(); ++s) {
+            if (freq[s] > 0) {
+                heap.push({ freq[s], static_cast<int>(parent.size()) });
+                parent.push_back(-1);
+            }
+        }
+        std::vector<int> leafOf;
+        for (size_t s = 0; s < freq.size(); ++s) if (freq[s] > 0) leafOf.push_back(static_cast<int>(s));
+        if (leafOf.size() == 1) {
+            lengths[leafOf[0]] = 1;
+            return lengths;
+        }
+        while (heap.size() > 1) {
+            Node a = heap.top(); heap.pop();
+            Node b = heap.top(); heap.pop();
+            int node = static_cast<int>(parent.size());
+            parent.push_back(-1);
+            parent[a.second] = node;
+            parent[b.second] = node;
+            heap.push({ a.first + b.first, node });
+        }
+        bool tooLong = false;
+        for (size_t leaf = 0; leaf < leafOf.size(); ++leaf) {
+            int depth = 0;
+            for (int n = static_cast<int>(leaf); parent[n] >= 0; n = parent[n]) ++depth;
+            lengths[leafOf[leaf]] = depth;
+            if (depth > 15) tooLong = true;
+        }
+        if (!tooLong) return lengths;
+        for (auto& f : freq) if (f > 0) f = (f + 1) / 2;
+    }
+}
+
+static std::vector<uint32_t> canonicalCodes(const std::vector<int>& lengths) {
+    int count[16] = {}, next[16] = {};
+    for (int len : lengths) if (len) count[len]++;
+    int code = 0;
+    for (int len = 1; len < 16; ++len) {
+        next[len] = code;
+        code = (code + count[len]) << 1;
+    }
+    std::vector<uint32_t> codes(lengths.size(), 0);
+    for (size_t s = 0; s < lengths.size(); ++s) if (lengths[s]) codes[s] = next[lengths[s]]++;
+    return codes;
+}
+
+static void writeTokens(BitWriter& w, const std::vector<Token>& tokens, const std::vector<int>& litLen,
+                        const std::vector<uint32_t>& litCode, const std::vector<int>& distLen, const std::vector<uint32_t>& distCode) {
+    for (const auto& t : tokens) {
+        if (t.literal >= 0) {
+            w.putCode(litCode[t.literal], litLen[t.literal]);
+        } else {
+            int ls = lengthSymbol(t.length);
+            w.putCode(litCode[257 + ls], litLen[257 + ls]);
+            w.put(t.length - kLengthBase[ls], kLengthExtra[ls]);
+            int ds = distanceSymbol(t.distance);
+            w.putCode(distCode[ds], distLen[ds]);
+            w.put(t.distance - kDistBase[ds], kDistExtra[ds]);
+        }
+    }
+    w.putCode(litCode[256], litLen[256]);
+}
+
+// Raw DEFLATE stream; blocks of blockSize input bytes, all in the given mode
+static std::string deflateRaw(const std::string& data, BlockMode mode, size_t blockSize = 20000) {
+    BitWriter w;
+    size_t start = 0;
+    do {
+        std::string block = data.substr(start, blockSize);
+        start += block.size();
+        bool last = start >= data.size();
+        if (mode == BlockMode::Stored) {
+            w.put(last ? 1 : 0, 1);
+            w.put(0, 2);
+            w.align();
+            w.put(static_cast<uint32_t>(block.size()), 16); // blockSize stays below 64 KB
+            w.put(static_cast<uint32_t>(block.size() ^ 0xFFFF), 16);
+            w.out += block;
+            continue;
+        }
+
+        // Matches may reach back into earlier blocks, so tokenize with the preceding 32 KB as history
+        size_t historyStart = start - block.size() > 32768 ? start - block.size() - 32768 : 0;
+        std::string window = data.substr(historyStart, start - historyStart);
+        std::vector<Token> all = tokenize(window);
+        std::vector<Token> tokens;
+        size_t pos = 0, blockBegin = window.size() - block.size();
+        for (const auto& t : all) {
+            size_t len = t.literal >= 0 ? 1 : t.length;
+            if (pos >= blockBegin) tokens.push_back(t);
+            else if (pos + len > blockBegin) {
+                for (size_t k = blockBegin; k < pos + len; ++k) tokens.push_back({ static_cast<unsigned char>(window[k]), 0, 0 });
+            }
+            pos += len;
+        }
+
+        std::vector<int> litLen(288), distLen(30);
+        if (mode == BlockMode::Fixed) {
+            for (int i = 0; i < 288; ++i) litLen[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+            for (int i = 0; i < 30; ++i) distLen[i] = 5;
+            w.put(last ? 1 : 0, 1);
+            w.put(1, 2);
+        } else {
+            std::vector<long> litFreq(286, 0), distFreq(30, 0);
+            for (const auto& t : tokens) {
+                if (t.literal >= 0) litFreq[t.literal]++;
+                else {
+                    litFreq[257 + lengthSymbol(t.length)]++;
+                    distFreq[distanceSymbol(t.distance)]++;
+                }
+            }
+            litFreq[256]++;
+            if (std::count(distFreq.begin(), distFreq.end(), 0L) == 30) distFreq[0] = 1;
+            litLen = huffmanLengths(litFreq);
+            distLen = huffmanLengths(distFreq);
+
+            int hlit = 286;
+            while (hlit > 257 && litLen[hlit - 1] == 0) --hlit;
+            int hdist = 30;
+            while (hdist > 1 && distLen[hdist - 1] == 0) --hdist;
+            std::vector<int> all(litLen.begin(), litLen.begin() + hlit);
+            all.insert(all.end(), distLen.begin(), distLen.begin() + hdist);
+
+            // Run-length encode the code lengths with symbols 16/17/18
+            struct Rle { int symbol, extra, bits; };
+            std::vector<Rle> rle;
+            for (size_t i = 0; i < all.size();) {
+                size_t run = 1;
+                while (i + run < all.size() && all[i + run] == all[i]) ++run;
+                if (all[i] == 0 && run >= 11) { int n = static_cast<int>(std::min<size_t>(run, 138)); rle.push_back({ 18, n - 11, 7 }); i += n; }
+                else if (all[i] == 0 && run >= 3) { int n = static_cast<int>(std::min<size_t>(run, 10)); rle.push_back({ 17, n - 3, 3 }); i += n; }
+                else if (i > 0 && all[i] == all[i - 1] && run >= 3) { int n = static_cast<int>(std::min<size_t>(run, 6)); rle.push_back({ 16, n - 3, 2 }); i += n; }
+                else { rle.push_back({ all[i], 0, 0 }); ++i; }
+            }
+            std::vector<long> clFreq(19, 0);
+            for (const auto& r : rle) clFreq[r.symbol]++;
+            std::vector<int> clLen = huffmanLengths(clFreq);
+            for (int& len : clLen) if (len > 7) len = 7; // Small alphabet, never reached in practice
+            std::vector<uint32_t> clCode = canonicalCodes(clLen);
+            static const int order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            int hclen = 19;
+            while (hclen > 4 && clLen[order[hclen - 1]] == 0) --hclen;
+
+            w.put(last ? 1 : 0, 1);
+            w.put(2, 2);
+            w.put(hlit - 257, 5);
+            w.put(hdist - 1, 5);
+            w.put(hclen - 4, 4);
+            for (int i = 0; i < hclen; ++i) w.put(clLen[order[i]], 3);
+            for (const auto& r : rle) {
+                w.putCode(clCode[r.symbol], clLen[r.symbol]);
+                if (r.bits) w.put(r.extra, r.bits);
+            }
+            litLen.resize(288, 0);
+        }
+        writeTokens(w, tokens, litLen, canonicalCodes(litLen), distLen, canonicalCodes(distLen));
+    } while (start < data.size());
+    return w.out;
+}
+
+static uint32_t crc32(const std::string& data) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char c : data) {
+        crc ^= c;
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static void putLE(std::string& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+static void writeZip(const std::string& filename, const std::vector<std::pair<std::string, std::string>>& files,
+                     BlockMode mode) {
+    std::string out, directory;
+    for (const auto& file : files) {
+        bool stored = mode == BlockMode::Stored && file.first.find("sheet") == std::string::npos;
+        std::string body = stored ? file.second : deflateRaw(file.second, mode);
+        uint32_t offset = static_cast<uint32_t>(out.size());
+        uint32_t crc = crc32(file.second);
+
+        putLE(out, 0x04034b50, 4); putLE(out, 20, 2); putLE(out, 0, 2); putLE(out, stored ? 0 : 8, 2);
+        putLE(out, 0, 4); putLE(out, crc, 4); putLE(out, static_cast<uint32_t>(body.size()), 4);
+        putLE(out, static_cast<uint32_t>(file.second.size()), 4); putLE(out, static_cast<uint32_t>(file.first.size()), 2);
+        putLE(out, 0, 2);
+        out += file.first;
+        out += body;
+
+        putLE(directory, 0x02014b50, 4); putLE(directory, 20, 2); putLE(directory, 20, 2); putLE(directory, 0, 2);
+        putLE(directory, stored ? 0 : 8, 2); putLE(directory, 0, 4); putLE(directory, crc, 4);
+        putLE(directory, static_cast<uint32_t>(body.size()), 4); putLE(directory, static_cast<uint32_t>(file.second.size()), 4);
+        putLE(directory, static_cast<uint32_t>(file.first.size()), 2); putLE(directory, 0, 2); putLE(directory, 0, 2);
+        putLE(directory, 0, 2); putLE(directory, 0, 2); putLE(directory, 0, 4); putLE(directory, offset, 4);
+        directory += file.first;
+    }
+    uint32_t directoryOffset = static_cast<uint32_t>(out.size());
+    out += directory;
+    putLE(out, 0x06054b50, 4); putLE(out, 0, 2); putLE(out, 0, 2);
+    putLE(out, static_cast<uint32_t>(files.size()), 2); putLE(out, static_cast<uint32_t>(files.size()), 2);
+    putLE(out, static_cast<uint32_t>(directory.size()), 4); putLE(out, directoryOffset, 4); putLE(out, 0, 2);
+
+    std::ofstream f(filename, std::ios::binary);
+    f << out;
+}
+
+// ---------------------------------------------------------------------------
+// Test workbook
+// ---------------------------------------------------------------------------
+
+static const int kDataRows = 12000;
+
+static std::vector<std::pair<std::string, std::string>> buildWorkbook() {
+    std::vector<std::pair<std::string, std::string>> files;
+    files.push_back({ "[Content_Types].xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\"/>" });
+    files.push_back({ "_rels/.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>" });
+    files.push_back({ "xl/workbook.xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" "
+        "xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\"><workbookPr/><sheets>"
+        "<sheet name=\"Data\" sheetId=\"1\" r:id=\"rId1\"/>"
+        "<sheet name=\"\xE6\x95\xB0\xE6\x8D\xAE &amp; more\" sheetId=\"2\" r:id=\"rId2\"/>"
+        "</sheets></workbook>" });
+    // Relationship order differs from sheet order on purpose
+    files.push_back({ "xl/_rels/workbook.xml.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId3\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"
+        "<Relationship Id=\"rId2\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet2.xml\"/>"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"/xl/worksheets/sheet1.xml\"/>"
+        "<Relationship Id=\"rId4\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>"
+        "</Relationships>" });
+    files.push_back({ "xl/styles.xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><styleSheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">"
+        "<numFmts count=\"2\"><numFmt numFmtId=\"164\" formatCode=\"yyyy\\-mm\\-dd\"/><numFmt numFmtId=\"165\" formatCode=\"[Red]0.00\"/></numFmts>"
+        "<cellStyleXfs count=\"1\"><xf numFmtId=\"14\"/></cellStyleXfs>"
+        "<cellXfs count=\"4\"><xf numFmtId=\"0\"/><xf numFmtId=\"164\"/><xf numFmtId=\"165\"/><xf numFmtId=\"14\"/></cellXfs>"
+        "</styleSheet>" });
+    files.push_back({ "xl/sharedStrings.xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><sst xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\" count=\"5\" uniqueCount=\"5\">"
+        "<si><t>ID</t></si><si><t>Name</t></si>"
+        "<si><r><rPr><b/></rPr><t>Rich </t></r><r><t xml:space=\"preserve\">Text</t></r><rPh sb=\"0\" eb=\"1\"><t>IGNORED</t></rPh></si>"
+        "<si><t>a &lt;b&gt; &amp; &#x4E2D;&#25991;_x000D_</t></si>"
+        "<si><t>A</t></si>"
+        "</sst>" });
+
+    // Sheet 1: header, then kDataRows rows. Row 5 is blank, column C is sometimes missing.
+    std::string sheet = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><dimension ref=\"A1:F" +
+        std::to_string(kDataRows + 1) + "\"/><sheetViews><sheetView workbookViewId=\"0\"/></sheetViews><sheetData>"
+        "<row r=\"1\"><c r=\"A1\" t=\"s\"><v>0</v></c><c r=\"B1\" t=\"s\"><v>1</v></c><c r=\"C1\" t=\"inlineStr\"><is><t>Amount</t></is></c>"
+        "<c r=\"D1\" t=\"str\"><v>Flag</v></c><c r=\"E1\" t=\"inlineStr\"><is><t>Date</t></is></c><c r=\"F1\" t=\"inlineStr\"><is><t>Note</t></is></c></row>\n";
+    for (int i = 1; i <= kDataRows; ++i) {
+        int r = i + 1;
+        if (r == 5) {
+            sheet += "<row r=\"5\" spans=\"1:6\"><c r=\"A5\" s=\"2\"/></row>";
+            continue;
+        }
+        std::string R = std::to_string(r);
+        sheet += "<row r=\"" + R + "\">";
+        sheet += "<c r=\"A" + R + "\"><v>" + std::to_string(i) + "</v></c>";
+        sheet += "<c r=\"B" + R + "\" t=\"s\"><v>" + std::to_string(i % 3 == 0 ? 4 : (i % 3 == 1 ? 2 : 3)) + "</v></c>";
+        if (i % 7 != 0) sheet += "<c r=\"C" + R + "\" s=\"2\"><v>" + std::to_string(i) + ".25</v></c>";
+        sheet += "<c r=\"D" + R + "\" t=\"b\"><v>" + std::string(i % 2 ? "1" : "0") + "</v></c>";
+        sheet += "<c r=\"E" + R + "\" s=\"" + std::string(i % 2 ? "1" : "3") + "\"><v>" + std::to_string(45000 + i % 400) + "</v></c>";
+        sheet += "</row>\n";
+    }
+    sheet += "</sheetData><pageMargins left=\"0.7\"/></worksheet>";
+    files.push_back({ "xl/worksheets/sheet1.xml", sheet });
+
+    // Sheet 2: no row 1, no r attributes on cells, no dimension
+    files.push_back({ "xl/worksheets/sheet2.xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?><worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>"
+        "<row r=\"3\"><c><v>1</v></c><c t=\"inlineStr\"><is><t>x</t></is></c></row>"
+        "<row><c><v>2</v></c><c t=\"e\"><v>#N/A</v></c></row>"
+        "</sheetData></worksheet>" });
+    return files;
+}
+
+int main() {
+    // 1. Inflate against the test encoder in every block type, read in uneven pieces
+    {
+        std::mt19937 rng(31);
+        std::vector<std::string> inputs = { "", "a", std::string(100000, 'x') };
+        std::string text;
+        for (int i = 0; i < 20000; ++i) text += "<c r=\"A" + std::to_string(i) + "\"><v>" + std::to_string(rng() % 1000) + "</v></c>";
+        inputs.push_back(text);
+        std::string noise(70000, ' ');
+        for (auto& c : noise) c = static_cast<char>(rng());
+        inputs.push_back(noise);
+
+        bool ok = true;
+        for (const auto& input : inputs) {
+            for (BlockMode mode : { BlockMode::Stored, BlockMode::Fixed, BlockMode::Dynamic }) {
+                std::string compressed = deflateRaw(input, mode);
+                InflateStream inflate;
+                inflate.reset(compressed.data(), compressed.size());
+                std::string output;
+                char piece[7000];
+                size_t n;
+                while ((n = inflate.read(piece, 1 + rng() % sizeof(piece))) > 0) output.append(piece, n);
+                if (output != input || inflate.failed() || !inflate.atEnd()) ok = false;
+            }
+        }
+        test(ok, "Inflate round trip (stored, fixed and dynamic blocks)");
+
+        std::string compressed = deflateRaw(text, BlockMode::Dynamic);
+        InflateStream truncated;
+        truncated.reset(compressed.data(), compressed.size() / 2);
+        char piece[4096];
+        while (truncated.read(piece, sizeof(piece)) > 0) {}
+        test(truncated.failed(), "Truncated stream reported as failed");
+    }
+
+    auto files = buildWorkbook();
+    std::string xlsxFile = "test_xlsx_reader.xlsx";
+
+    for (BlockMode mode : { BlockMode::Dynamic, BlockMode::Fixed, BlockMode::Stored }) {
+        writeZip(xlsxFile, files, mode);
+        std::string modeName = mode == BlockMode::Dynamic ? "dynamic" : mode == BlockMode::Fixed ? "fixed" : "stored";
+
+        // 2. Sheet names in workbook order
+        auto reader = createExcelReader(xlsxFile);
+        std::vector<std::string> names;
+        test(reader->getSheetNames(xlsxFile, names) && names.size() == 2 && names[0] == "Data" &&
+             names[1] == "\xE6\x95\xB0\xE6\x8D\xAE & more", "Sheet names (" + modeName + ")");
+
+        // 3. Full read with header
+        std::vector<DataRow> rows;
+        test(reader->readExcelFile(xlsxFile, rows, "Data", 0, 0, true), "Read sheet");
+        test(rows.size() == static_cast<size_t>(kDataRows), "Header plus data rows, blank row skipped");
+        test(rows[0].rowNumber == 1 && cellText(rows[0].data[0]) == "SID" && cellText(rows[0].data[2]) == "SAmount" &&
+             cellText(rows[0].data[3]) == "SFlag" && rows[0].data.size() == 6, "Header from shared, inline and formula strings");
+        test(rows[1].rowNumber == 2 && *rows[1].sheetName == "Data", "Row number and sheet name");
+        test(rows[1].data.size() == 6 && cellText(rows[1].data[0]) == "N1" && cellText(rows[1].data[2]) == "N1.25",
+             "Numbers are doubles, [Red] format is not a date");
+        test(cellText(rows[1].data[1]) == "SRich Text", "Rich text runs joined, phonetic text dropped");
+        test(cellText(rows[3].data[1]) == "SA", "Shared string");
+        test(cellText(rows[1].data[3]) == "B1" && cellText(rows[2].data[3]) == "B0", "Booleans");
+        test(cellText(rows[1].data[4]) == "D2023-3-16" && cellText(rows[2].data[4]) == "D2023-3-17", "Custom and built-in date styles");
+        test(cellText(rows[1].data[5]) == "S", "Short row padded to the dimension");
+        test(rows[3].rowNumber == 4 && rows[4].rowNumber == 6, "Blank row 5 skipped");
+        const DataRow& seventh = *std::find_if(rows.begin(), rows.end(), [](const DataRow& r) { return r.rowNumber == 8; });
+        test(cellText(seventh.data[2]) == "S", "Missing cell is an empty string");
+        test(cellText(rows.back().data[0]) == "N" + std::to_string(kDataRows), "Last row read");
+
+        // 4. Offsets follow the ActiveQt reader: with a header, offset counts data rows after row 1
+        std::vector<DataRow> part;
+        reader->readExcelFile(xlsxFile, part, "Data", 10, 100, true);
+        test(part.size() == 10 && part[0].rowNumber == 102 && part.back().rowNumber == 111, "Offset and maxRows");
+        part.clear();
+        reader->readExcelFile(xlsxFile, part, "", 3, 0, false);
+        test(part.size() == 3 && part[0].rowNumber == 1, "Default sheet, row 1 is data without header");
+
+        // 5. Chunk cursor returns the same rows as a full read
+        auto cursor = reader->openChunkCursor(xlsxFile, "Data", true);
+        test(cursor && cursor->supportsBackgroundRead(), "Cursor opened");
+        std::vector<DataRow> chunked;
+        int chunks = 0;
+        while (cursor && !cursor->atEnd()) {
+            std::vector<DataRow> chunk;
+            cursor->readNextChunk(chunk, 5000);
+            chunked.insert(chunked.end(), chunk.begin(), chunk.end());
+            chunks++;
+        }
+        test(chunks == 3 && rowsText(chunked) == rowsText(rows), "Chunked read matches full read");
+
+        // 6. Sheet without row 1, cell references or dimension
+        std::vector<DataRow> second;
+        test(reader->readExcelFile(xlsxFile, second, "\xE6\x95\xB0\xE6\x8D\xAE & MORE", 0, 0, true), "Case-insensitive sheet lookup");
+        test(second.size() == 3 && second[0].rowNumber == 1 && cellText(second[0].data[0]) == "S",
+             "Missing header row returned empty");
+        test(second[1].rowNumber == 3 && cellText(second[1].data[1]) == "Sx" && second[2].rowNumber == 4 &&
+             cellText(second[2].data[1]) == "S#N/A", "Rows and cells without references");
+
+        // Every call above shared one parse of the workbook
+        test(reader->getRowCount("Data") == kDataRows + 1 && reader->getColumnCount("Data") == 6 &&
+             reader->getRowCount(names[1]) == 4 && reader->getColumnCount(names[1]) == 2, "Sheet dimensions");
+        test(reader->fileOpenCount() == 1, "Workbook opened once per reader (" + modeName + ")");
+    }
+
+    // 7. Text decoding
+    {
+        XlsxWorkbook workbook;
+        test(workbook.open(xlsxFile), "Workbook opens");
+        test(workbook.sharedStrings().size() == 5 && workbook.sharedStrings()[3] == "a <b> & \xE4\xB8\xAD\xE6\x96\x87\r",
+             "Entities, character references and _x000D_ decoded");
+    }
+
+    // 8. Broken input
+    {
+        auto reader = createExcelReader(xlsxFile);
+        std::vector<DataRow> rows;
+        test(!reader->readExcelFile(xlsxFile, rows, "Missing"), "Unknown sheet fails");
+
+        std::string notZip = "test_xlsx_reader_bad.xlsx";
+        std::ofstream(notZip) << "ID,Name\n1,2\n";
+        test(!reader->readExcelFile(notZip, rows) && !reader->openChunkCursor(notZip, "", true), "Non-zip file fails");
+        fs::remove(notZip);
+    }
+
+    // 9. Tasks read xlsx input without Excel
+    {
+        writeZip(xlsxFile, files, BlockMode::Dynamic);
+        ExcelProcessorCore processor;
+        Rule rule;
+        rule.id = 1;
+        rule.name = "A";
+        rule.type = RuleType::FILTER;
+        rule.enabled = true;
+        RuleCondition cond;
+        cond.column = 2;
+        cond.oper = Operator::EQUAL;
+        cond.value = std::string("A");
+        rule.conditions.push_back(cond);
+        processor.addRule(rule);
+
+        ProcessingTask task;
+        task.id = 1;
+        task.taskName = "OnlyA";
+        task.outputWorkbookName = "test_xlsx_reader_out.csv";
+        task.outputMode = OutputMode::NEW_WORKBOOK;
+        task.inputSheetName = "Data";
+        task.useHeader = true;
+        task.rules.push_back(TaskRuleEntry(rule.id));
+        processor.addTask(task);
+
+        auto results = processor.processTasks(xlsxFile);
+        test(results.size() == 1 && results[0].errors.empty(), "Task over xlsx input succeeds");
+
+        std::ifstream in("test_xlsx_reader_out.csv");
+        std::string line;
+        int lines = 0;
+        std::getline(in, line);
+        bool header = line == "\"ID\",\"Name\",\"Amount\",\"Flag\",\"Date\",\"Note\"";
+        while (std::getline(in, line)) lines++;
+        test(header && lines == kDataRows / 3, "Filtered rows written with header");
+    }
+
+    // 10. A run opens its input once for all sheets; a changed file is parsed again
+    {
+        ExcelProcessorCore processor;
+        ProcessingTask task;
+        task.id = 1;
+        task.taskName = "All";
+        task.outputWorkbookName = "test_xlsx_reader_out.csv";
+        task.outputMode = OutputMode::NEW_WORKBOOK;
+        processor.addTask(task);
+        auto results = processor.processTasks(xlsxFile);
+        test(results.size() == 2 && processor.inputFileOpenCount() == 1, "Two sheets processed from one open");
+
+        auto reader = createExcelReader(xlsxFile);
+        std::vector<std::string> names;
+        reader->getSheetNames(xlsxFile, names);
+        writeZip(xlsxFile, files, BlockMode::Stored);
+        test(reader->getSheetNames(xlsxFile, names) && reader->fileOpenCount() == 2, "Rewritten file reopened");
+        reader->closeInput();
+        test(reader->getRowCount("Data") == 0, "Dimensions released with the input");
+        reader->getSheetNames(xlsxFile, names);
+        test(reader->fileOpenCount() == 3, "Closed input opened again on next use");
+    }
+
+    try {
+        fs::remove(xlsxFile);
+        fs::remove("test_xlsx_reader_out.csv");
+    } catch (...) {}
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,324 @@
+#include "ExcelProcessorCore.h"
+#include "../src/core/XlsxParser.h"
+#include "../src/core/XlsxWriter.h"
+#include "CellText.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <vector>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void test(bool condition, const std::string& name) {
+    if (condition) std::cout << "[PASS] " << name << std::endl;
+    else {
+        std::cerr << "[FAIL] " << name << std::endl;
+        exit(1);
+    }
+}
+
+static std::string inflateAll(const std::string& compressed) {
+    InflateStream inflate;
+    inflate.reset(compressed.data(), compressed.size());
+    std::string output;
+    char piece[4096];
+    size_t n;
+    while ((n = inflate.read(piece, sizeof(piece))) > 0) output.append(piece, n);
+    return inflate.failed() || !inflate.atEnd() ? "<failed>" : output;
+}
+
+// All rows of a sheet, row 1 included
+static std::string readSheet(const std::string& filename, const std::string& sheetName) {
+    auto reader = createExcelReader(filename);
+    std::vector<DataRow> rows;
+    if (!reader->readExcelFile(filename, rows, sheetName, 0, 0, true)) return "<unreadable>";
+    return rowsText(rows);
+}
+
+static std::vector<std::string> sheetNames(const std::string& filename) {
+    auto reader = createExcelReader(filename);
+    std::vector<std::string> names;
+    reader->getSheetNames(filename, names);
+    return names;
+}
+
+static DataRow makeRow(std::vector<CellValue> cells) {
+    DataRow row;
+    row.data = std::move(cells);
+    return row;
+}
+
+static std::tm makeDate(int year, int month, int day, int hour = 0) {
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    return tm;
+}
+
+int main() {
+    // 1. Encoder output inflates back, in one stream and as a sync-flushed prefix followed by another stream
+    {
+        std::mt19937 rng(7);
+        std::vector<std::string> inputs = { "", "a", std::string(200000, 'x') };
+        std::string xml;
+        for (int i = 1; i < 30000; ++i) xml += "<row r=\"" + std::to_string(i) + "\"><c r=\"A" + std::to_string(i) + "\"><v>" + std::to_string(rng() % 1000) + "</v></c></row>";
+        inputs.push_back(xml);
+        std::string noise(150000, ' ');
+        for (auto& c : noise) c = static_cast<char>(rng());
+        inputs.push_back(noise);
+
+        bool ok = true;
+        for (const auto& input : inputs) {
+            DeflateEncoder encoder;
+            for (size_t pos = 0; pos < input.size();) {
+                size_t n = std::min<size_t>(1 + rng() % 90000, input.size() - pos);
+                encoder.write(input.data() + pos, n);
+                pos += n;
+            }
+            encoder.finish();
+            if (inflateAll(encoder.output()) != input) ok = false;
+        }
+        test(ok, "Deflate round trip");
+        test(inputs[3].size() / 4 > 0 && [&]() {
+            DeflateEncoder encoder;
+            encoder.write(inputs[3].data(), inputs[3].size());
+            encoder.finish();
+            return encoder.output().size() < inputs[3].size() / 4;
+        }(), "Sheet XML compresses");
+
+        DeflateEncoder head;
+        head.write(xml.data(), 1000);
+        head.finish(false);
+        DeflateEncoder body;
+        body.write(xml.data() + 1000, xml.size() - 1000);
+        body.finish();
+        test(inflateAll(head.output() + body.output()) == xml, "Sync-flushed stream continues with a second stream");
+
+        uint32_t whole = crc32Update(0, xml.data(), xml.size());
+        uint32_t combined = crc32Combine(crc32Update(0, xml.data(), 1000), crc32Update(0, xml.data() + 1000, xml.size() - 1000), xml.size() - 1000);
+        test(crc32Update(0, "123456789", 9) == 0xCBF43926u && combined == whole, "CRC-32 and CRC combination");
+    }
+
+    // 2. Sheets written in interleaved order read back with their values
+    std::string bookFile = "test_xlsx_writer_book.xlsx";
+    {
+        XlsxWorkbookWriter book;
+        int first = book.addSheet("Data");
+        int second = book.addSheet("\xE6\x95\xB0\xE6\x8D\xAE/Q1?");
+        test(book.findSheet("DATA") == first && book.findSheet("\xE6\x95\xB0\xE6\x8D\xAE_Q1_") == second, "Sheet lookup");
+
+        for (int i = 1; i <= 3000; ++i) {
+            book.writeRow(first, i, { i, "Item " + std::to_string(i % 10), i * 0.5 });
+            if (i % 1000 == 0) book.writeRow(second, i / 1000, { std::string("chunk"), i });
+        }
+        book.appendRows(second, { makeRow({ std::string("a & <b> \"c\""), std::string(" padded "), std::string("_x0041_"),
+                                           std::string("bell\x07"), std::string("line\nbreak") }),
+                                  makeRow({ true, false, std::string(""), makeDate(2024, 2, 29), makeDate(1999, 12, 31, 13) }),
+                                  makeRow({ std::string(""), std::string("") }),
+                                  makeRow({ std::string(""), 1.0 / 3, -2.5e-300, 123456789012345.0 }) });
+        test(book.save(bookFile), "Workbook saved");
+
+        auto names = sheetNames(bookFile);
+        test(names.size() == 2 && names[0] == "Data" && names[1] == "\xE6\x95\xB0\xE6\x8D\xAE_Q1_", "Sheets in order, invalid characters replaced");
+
+        auto reader = createExcelReader(bookFile);
+        std::vector<DataRow> rows;
+        reader->readExcelFile(bookFile, rows, "Data", 0, 0, true);
+        test(rows.size() == 3000 && cellText(rows[0].data[0]) == "N1" && cellText(rows[0].data[1]) == "SItem 1" &&
+             cellText(rows[2999].data[2]) == "N1500", "First sheet values");
+
+        rows.clear();
+        reader->readExcelFile(bookFile, rows, names[1], 0, 0, true);
+        test(rows.size() == 6 && rows[2].rowNumber == 3 && cellText(rows[2].data[1]) == "N3000", "Interleaved rows kept their sheet");
+        test(cellText(rows[3].data[0]) == "Sa & <b> \"c\"" && cellText(rows[3].data[1]) == "S padded " &&
+             cellText(rows[3].data[2]) == "S_x0041_" && cellText(rows[3].data[3]) == "Sbell\x07" &&
+             cellText(rows[3].data[4]) == "Sline\nbreak", "Strings escaped and read back unchanged");
+        test(cellText(rows[4].data[0]) == "B1" && cellText(rows[4].data[1]) == "B0" && cellText(rows[4].data[2]) == "S" &&
+             cellText(rows[4].data[3]) == "D2024-2-29" && cellText(rows[4].data[4]) == "D1999-12-31", "Booleans, empty cell and dates");
+        test(rows[5].rowNumber == 7, "Row without values keeps its row number");
+        test(std::get<double>(rows[5].data[1]) == 1.0 / 3 && std::get<double>(rows[5].data[2]) == -2.5e-300 &&
+             std::get<double>(rows[5].data[3]) == 123456789012345.0, "Doubles round trip exactly");
+
+        XlsxWorkbook workbook;
+        test(workbook.open(bookFile) && workbook.sharedStrings().size() == 16, "Each distinct string stored once");
+    }
+
+    // 3. The ExcelWriter interface keeps workbooks open and writes each file once
+    std::string outFile = "test_xlsx_writer_out.xlsx";
+    {
+        fs::remove(outFile);
+        auto writer = createExcelWriter(ExcelWriterType::Xlsx);
+        test(writer->getType() == ExcelWriterType::Xlsx, "Factory creates the native writer");
+
+        std::vector<DataRow> chunk = { makeRow({ std::string("ID"), std::string("Name") }), makeRow({ 1, std::string("one") }) };
+        test(writer->writeExcelFile(outFile, chunk), "New workbook");
+        test(writer->appendToSheet(outFile, { makeRow({ 2, std::string("two") }) }, "Sheet1"), "Append chunk");
+        test(writer->appendToSheet(outFile, { makeRow({ std::string("x") }) }, "Extra"), "Append to a new sheet");
+        test(!fs::exists(outFile), "Nothing written before closeAll");
+        writer->closeAll();
+        test(readSheet(outFile, "Sheet1") == "1:SID|SName|\n2:N1|Sone|\n3:N2|Stwo|\n" &&
+             readSheet(outFile, "Extra") == "1:Sx|\n", "Chunks appended below each other");
+
+        // Appending to a closed workbook continues from its values
+        auto again = createExcelWriter(ExcelWriterType::Xlsx);
+        test(again->appendToSheet(outFile, { makeRow({ 3, std::string("three") }) }, "sheet1"), "Append to an existing file");
+        test(again->appendToSheet(outFile, { makeRow({ std::string("y") }) }, "Extra", true), "Overwrite a sheet");
+        again->closeAll();
+        test(sheetNames(outFile) == std::vector<std::string>({ "Sheet1", "Extra" }) &&
+             readSheet(outFile, "Sheet1") == "1:SID|SName|\n2:N1|Sone|\n3:N2|Stwo|\n4:N3|Sthree|\n" &&
+             readSheet(outFile, "Extra") == "1:Sy|\n", "Existing rows kept, overwritten sheet replaced");
+
+        // A new workbook replaces one that is still open
+        auto replace = createExcelWriter(ExcelWriterType::Xlsx);
+        replace->appendToSheet(outFile, { makeRow({ std::string("dropped") }) }, "Sheet1");
+        std::map<std::string, std::vector<DataRow>> sheets;
+        sheets["B"] = { makeRow({ std::string("b") }) };
+        sheets["A"] = { makeRow({ std::string("a") }) };
+        test(replace->writeMultipleSheets(outFile, sheets), "Multiple sheets");
+        replace->closeAll();
+        test(sheetNames(outFile) == std::vector<std::string>({ "A", "B" }) && readSheet(outFile, "B") == "1:Sb|\n",
+             "Workbook replaced by the multi-sheet write");
+
+        XlsxWorkbookWriter limits;
+        int sheet = limits.addSheet("Rows");
+        test(limits.writeRow(sheet, 1048576, { 1 }) && !limits.writeRow(sheet, 1048577, { 1 }), "Excel row limit enforced");
+    }
+
+    // 4. Task output: a NEW_WORKBOOK .xlsx and two NEW_SHEET tasks sharing one workbook, serial and pipelined
+    {
+        std::string inputFile = "test_xlsx_writer_input.csv";
+        {
+            std::ofstream out(inputFile);
+            out << "ID,Group,Note\n";
+            for (int i = 1; i <= 12000; ++i) out << i << "," << (i % 4 == 0 ? "A" : "B") << ",note " << i % 7 << "\n";
+        }
+
+        ExcelProcessorCore processor;
+        Rule rule;
+        rule.id = 1;
+        rule.name = "GroupA";
+        rule.type = RuleType::FILTER;
+        rule.enabled = true;
+        RuleCondition cond;
+        cond.column = 2;
+        cond.oper = Operator::EQUAL;
+        cond.value = std::string("A");
+        rule.conditions.push_back(cond);
+        processor.addRule(rule);
+
+        ProcessingTask own;
+        own.id = 1;
+        own.taskName = "Own";
+        own.outputWorkbookName = "test_xlsx_writer_task.xlsx";
+        own.outputMode = OutputMode::NEW_WORKBOOK;
+        own.useHeader = true;
+        own.rules.push_back(TaskRuleEntry(rule.id));
+        processor.addTask(own);
+
+        ProcessingTask groupA;
+        groupA.id = 2;
+        groupA.taskName = "GroupA";
+        groupA.outputMode = OutputMode::NEW_SHEET;
+        groupA.useHeader = true;
+        groupA.rules.push_back(TaskRuleEntry(rule.id));
+        processor.addTask(groupA);
+
+        ProcessingTask all;
+        all.id = 3;
+        all.taskName = "All";
+        all.outputMode = OutputMode::NEW_SHEET;
+        all.useHeader = true;
+        processor.addTask(all);
+
+        std::string sharedFile = "test_xlsx_writer_shared.xlsx";
+        std::string outputs[2];
+        for (bool pipelined : { false, true }) {
+            fs::remove("test_xlsx_writer_task.xlsx");
+            fs::remove(sharedFile);
+            processor.setPipelinedProcessing(pipelined);
+            auto results = processor.processTasks(inputFile, sharedFile);
+            std::string mode = pipelined ? " (pipelined)" : " (serial)";
+            test(results.size() == 3 && results[0].errors.empty() && results[1].errors.empty() && results[2].errors.empty(),
+                 "Tasks succeed" + mode);
+            outputs[pipelined] = readSheet("test_xlsx_writer_task.xlsx", "Sheet1") + readSheet(sharedFile, "GroupA") +
+                                 readSheet(sharedFile, "All");
+        }
+        test(outputs[0] == outputs[1], "Pipelined output matches serial output");
+        test(sheetNames(sharedFile) == std::vector<std::string>({ "GroupA", "All" }), "One sheet per NEW_SHEET task");
+
+        auto reader = createExcelReader(sharedFile);
+        std::vector<DataRow> rows;
+        reader->readExcelFile(sharedFile, rows, "All", 0, 0, true);
+        test(rows.size() == 12001 && cellText(rows[0].data[0]) == "SID" && cellText(rows[1].data[0]) == "N1" &&
+             rows.back().rowNumber == 12001, "Header written once, rows in input order");
+        rows.clear();
+        reader->readExcelFile("test_xlsx_writer_task.xlsx", rows, "", 0, 0, true);
+        test(rows.size() == 3001 && cellText(rows[1].data[0]) == "N4" && cellText(rows[1].data[2]) == "Snote 4",
+             "Filtered rows in the task workbook");
+
+        fs::remove(inputFile);
+        fs::remove(sharedFile);
+        fs::remove("test_xlsx_writer_task.xlsx");
+    }
+
+    // 5. A multi-sheet input appends every sheet to one native workbook, saved once after the last sheet;
+    //    a failed save is reported against each sheet's result of the task
+    {
+        std::string inputFile = "test_xlsx_writer_sheets.xlsx";
+        {
+            std::map<std::string, std::vector<DataRow>> sheets;
+            for (int s = 1; s <= 3; ++s) {
+                auto& data = sheets["Input" + std::to_string(s)];
+                data.resize(101);
+                data[0].data.push_back(std::string("ID"));
+                for (int i = 1; i <= 100; ++i) data[i].data.push_back(s * 1000 + i);
+            }
+            auto writer = createExcelWriter(ExcelWriterType::Xlsx);
+            writer->writeMultipleSheets(inputFile, sheets);
+            writer->closeAll();
+        }
+
+        ExcelProcessorCore processor;
+        ProcessingTask all;
+        all.id = 1;
+        all.taskName = "All";
+        all.outputMode = OutputMode::NEW_SHEET;
+        all.useHeader = true;
+        processor.addTask(all);
+
+        std::string sharedFile = "test_xlsx_writer_sheets_out.xlsx";
+        for (bool pipelined : { false, true }) {
+            std::string mode = pipelined ? " (pipelined)" : " (serial)";
+            fs::remove(sharedFile);
+            processor.setPipelinedProcessing(pipelined);
+            auto results = processor.processTasks(inputFile, sharedFile);
+            test(results.size() == 3 && results[0].errors.empty() && results[2].errors.empty(), "One result per input sheet" + mode);
+
+            auto reader = createExcelReader(sharedFile);
+            std::vector<DataRow> rows;
+            reader->readExcelFile(sharedFile, rows, "All", 0, 0, true);
+            test(rows.size() == 301 && cellText(rows[1].data[0]) == "N1001" && cellText(rows.back().data[0]) == "N3100",
+                 "Every input sheet appended in order" + mode);
+
+            results = processor.processTasks(inputFile, "test_xlsx_writer_missing_dir/out.xlsx");
+            bool allFailed = results.size() == 3;
+            for (const auto& result : results) allFailed = allFailed && result.errors.size() == 1;
+            test(allFailed, "Failed save reported once against each sheet's result" + mode);
+        }
+
+        fs::remove(inputFile);
+        fs::remove(sharedFile);
+    }
+
+    try {
+        fs::remove(bookFile);
+        fs::remove(outFile);
+    } catch (...) {}
+
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}